@@ -2,13 +2,32 @@
 #
 # URING_INCLUDE_DIR - Where to find liburing.h
 # URING_LIBRARIES - List of libraries when using uring.
+# URING_VERSION_STRING - The version of uring, 0 if older than 2.4.
 # uring_FOUND - True if uring found.
 
 find_path(URING_INCLUDE_DIR liburing.h)
 find_library(URING_LIBRARIES uring)
 
+set(_uring_version_h "${URING_INCLUDE_DIR}/liburing/io_uring_version.h")
+if(URING_INCLUDE_DIR AND EXISTS "${_uring_version_h}")
+  foreach(ver "MAJOR" "MINOR")
+    file(STRINGS "${_uring_version_h}" URING_VER_${ver}_LINE
+      REGEX "^#define[ \t]+IO_URING_VERSION_${ver}[ \t]+[0-9]+.*$")
+    string(REGEX REPLACE "^#define[ \t]+IO_URING_VERSION_${ver}[ \t]+([0-9]+).*$"
+      "\\1" URING_VERSION_${ver} "${URING_VER_${ver}_LINE}")
+    unset(URING_VER_${ver}_LINE)
+  endforeach()
+  set(URING_VERSION_STRING "${URING_VERSION_MAJOR}.${URING_VERSION_MINOR}")
+elseif(URING_INCLUDE_DIR)
+  # older versions don't tell theirs
+  set(URING_VERSION_STRING "0")
+endif()
+unset(_uring_version_h)
+
 include(FindPackageHandleStandardArgs)
-find_package_handle_standard_args(uring DEFAULT_MSG URING_LIBRARIES URING_INCLUDE_DIR)
+find_package_handle_standard_args(uring
+  REQUIRED_VARS URING_LIBRARIES URING_INCLUDE_DIR
+  VERSION_VAR URING_VERSION_STRING)
 
 if(uring_FOUND AND NOT TARGET uring::uring)
   add_library(uring::uring UNKNOWN IMPORTED)
@@ -0,0 +1,104 @@
+#!/usr/bin/env bash
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Library Public License as published by
+# the Free Software Foundation; either version 2, or (at your option)
+# any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Library Public License for more details.
+#
+
+source $CEPH_ROOT/qa/standalone/ceph-helpers.sh
+
+function run() {
+    local dir=$1
+    shift
+
+    export CEPH_MON="127.0.0.1:7212" # git grep '\<7212\>' : there must be only one
+    export CEPH_ARGS
+    CEPH_ARGS+="--fsid=$(uuidgen) --auth-supported=none "
+    CEPH_ARGS+="--mon-host=$CEPH_MON --osd_max_backfills=1 "
+    CEPH_ARGS+="--osd_mclock_override_recovery_settings=true "
+    # scan a few objects at a time so that backfill needs many read-aheads
+    CEPH_ARGS+="--osd_backfill_scan_ahead=true "
+    CEPH_ARGS+="--osd_backfill_scan_min=2 --osd_backfill_scan_max=4 "
+    CEPH_ARGS+="--debug_osd=20 "
+
+    local funcs=${@:-$(set | sed -n -e 's/^\(TEST_[0-9a-z_]*\) .*/\1/p')}
+    for func in $funcs ; do
+        setup $dir || return 1
+        $func $dir || return 1
+        teardown $dir || return 1
+    done
+}
+
+function _backfill_test() {
+    local dir=$1
+    local reset=$2
+    local OSDS=4
+    local objects=200
+
+    run_mon $dir a || return 1
+    run_mgr $dir x || return 1
+    for osd in $(seq 0 $(expr $OSDS - 1))
+    do
+      run_osd $dir $osd || return 1
+    done
+
+    create_pool test 1 1
+    wait_for_clean || return 1
+
+    local primary=$(get_primary test obj-1)
+    local replica=$(ceph pg dump pgs --format=json | \
+        jq ".pg_stats[0].up[] | select(. != $primary)" | head -1)
+
+    # let the replica miss all of the writes, then backfill it
+    ceph osd out $replica
+    wait_for_clean || return 1
+    for j in $(seq 1 $objects)
+    do
+       rados -p test put obj-${j} /etc/passwd
+    done
+    ceph osd in $replica
+
+    if [ "$reset" = "yes" ]; then
+        # restart backfill while read-ahead scans are in flight, which
+        # resets the intervals the replies would have extended
+        sleep 2
+        ceph pg repeer 1.0 || return 1
+    fi
+    wait_for_clean || return 1
+
+    for j in $(seq 1 $objects)
+    do
+       rados -p test stat obj-${j} || return 1
+    done
+    flush_pg_stats || return 1
+    test "$(ceph pg dump pgs --format=json | \
+        jq '.pg_stats[0].stat_sum.num_objects')" = "$objects" || return 1
+
+    grep -q "scanning ahead peer" $dir/osd.*.log || return 1
+}
+
+function TEST_backfill_scan_ahead() {
+    local dir=$1
+
+    _backfill_test $dir no || return 1
+}
+
+# A read-ahead reply that arrives after the interval was reset is dropped,
+# and backfill must not keep waiting on it.
+function TEST_backfill_scan_ahead_reset() {
+    local dir=$1
+
+    _backfill_test $dir yes || return 1
+}
+
+main osd-backfill-scan-ahead "$@"
+
+# Local Variables:
+# compile-command: "make -j4 && ../qa/run-standalone.sh osd-backfill-scan-ahead.sh"
+# End:
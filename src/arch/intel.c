@@ -23,6 +23,9 @@ int ceph_arch_intel_ssse3 = 0;
 int ceph_arch_intel_sse3 = 0;
 int ceph_arch_intel_sse2 = 0;
 int ceph_arch_intel_aesni = 0;
+int ceph_arch_intel_avx2 = 0;
+int ceph_arch_intel_avx512bw = 0;
+int ceph_arch_intel_gfni = 0;
 
 #ifdef __x86_64__
 #include <cpuid.h>
@@ -36,6 +39,25 @@ int ceph_arch_intel_aesni = 0;
 #define CPUID_SSE3	(1)
 #define CPUID_SSE2	(1 << 26)
 #define CPUID_AESNI (1 << 25)
+#define CPUID_OSXSAVE	(1 << 27)
+#define CPUID_AVX	(1 << 28)
+
+/* leaf 7, sub-leaf 0 */
+#define CPUID7_AVX2	(1 << 5)
+#define CPUID7_AVX512F	(1 << 16)
+#define CPUID7_AVX512BW	(1 << 30)
+#define CPUID7_GFNI	(1 << 8)
+
+/* XCR0 state the OS saves: SSE and AVX, opmask and the upper ZMM state */
+#define XCR0_AVX	(0x6)
+#define XCR0_AVX512	(0xe0)
+
+static unsigned long long xgetbv0(void)
+{
+	unsigned int eax, edx;
+	__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+	return ((unsigned long long)edx << 32) | eax;
+}
 
 int ceph_arch_intel_probe(void)
 {
@@ -66,6 +88,30 @@ int ceph_arch_intel_probe(void)
           ceph_arch_intel_aesni = 1;
   }
 
+	/* AVX state must be enabled by the OS, not only by the CPU */
+	if ((ecx & (CPUID_OSXSAVE | CPUID_AVX)) != (CPUID_OSXSAVE | CPUID_AVX)) {
+		return 0;
+	}
+	unsigned long long xcr0 = xgetbv0();
+	if ((xcr0 & XCR0_AVX) != XCR0_AVX) {
+		return 0;
+	}
+	unsigned int ecx7 = 0;
+	if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx7, &edx)) {
+		return 0;
+	}
+	if ((ebx & CPUID7_AVX2) != 0) {
+		ceph_arch_intel_avx2 = 1;
+	}
+	if ((xcr0 & XCR0_AVX512) == XCR0_AVX512 &&
+	    (ebx & (CPUID7_AVX512F | CPUID7_AVX512BW)) ==
+	    (CPUID7_AVX512F | CPUID7_AVX512BW)) {
+		ceph_arch_intel_avx512bw = 1;
+	}
+	if ((ecx7 & CPUID7_GFNI) != 0) {
+		ceph_arch_intel_gfni = 1;
+	}
+
 	return 0;
 }
 
@@ -175,6 +175,9 @@ int main(int argc, const char **argv)
   if (!msgr)
     forker.exit(1);
   msgr->set_cluster_protocol(CEPH_MDS_PROTOCOL);
+  // the dispatchers of the MDS all take their own locks
+  msgr->set_dispatch_threads(
+    g_conf().get_val<uint64_t>("mds_dispatch_threads"));
 
   cout << "starting " << g_conf()->name << " at " << msgr->get_myaddrs()
        << std::endl;
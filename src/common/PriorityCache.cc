@@ -396,9 +396,19 @@ namespace PriorityCache
     // If this is the last priority, divide up any remaining memory based
     // solely on the ratios.
     if (pri == Priority::LAST) {
+      // The ratios of the owner's caches add up to 1, caches inserted from
+      // elsewhere come on top of that.  Scale them all down so that no more
+      // than the remaining memory is handed out.
+      double total_ratios = 0;
+      for (auto it = caches.begin(); it != caches.end(); it++) {
+        total_ratios += it->second->get_cache_ratio();
+      }
       uint64_t total_assigned = 0;
       for (auto it = caches.begin(); it != caches.end(); it++) {
         double ratio = it->second->get_cache_ratio();
+        if (total_ratios > 1) {
+          ratio /= total_ratios;
+        }
         int64_t fair_share = static_cast<int64_t>(*mem_avail * ratio);
         it->second->set_cache_bytes(Priority::LAST, fair_share);
         total_assigned += fair_share;
@@ -2131,6 +2131,19 @@ __u32 buffer::list::crc32c(__u32 crc) const
   return crc;
 }
 
+void buffer::list::set_crc32c(__u32 base, __u32 crc) const
+{
+  if (_num != 1) {
+    return;
+  }
+  const auto& node = _buffers.front();
+  if (node.length() && node._raw) {
+    node._raw->set_crc(
+      make_pair(node.offset(), node.offset() + node.length()),
+      make_pair(base, crc));
+  }
+}
+
 void buffer::list::invalidate_crc()
 {
   for (const auto& node : _buffers) {
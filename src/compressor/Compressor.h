@@ -16,6 +16,7 @@
 #ifndef CEPH_COMPRESSOR_H
 #define CEPH_COMPRESSOR_H
 
+#include <cerrno>
 #include <memory>
 #include <optional>
 #include <string>
@@ -88,6 +89,15 @@ public:
   // this is a bit weird but we need non-const iterator to be in
   // alignment with decode methods
   virtual int decompress(ceph::bufferlist::const_iterator &p, size_t compressed_len, ceph::bufferlist &out, std::optional<int32_t> compressor_message) = 0;
+  // Compress and decompress with a dictionary shared with whoever is on the
+  // other side from now on, set before the compressor is first used.
+  virtual int set_dictionary(const ceph::bufferlist &dict) {
+    return -EOPNOTSUPP;
+  }
+  // the id of the dictionary set, 0 without one
+  virtual uint32_t get_dictionary_id() const {
+    return 0;
+  }
 
   static CompressorRef create(CephContext *cct, const std::string &type);
   static CompressorRef create(CephContext *cct, int alg);
@@ -26,6 +26,37 @@
 class ZstdCompressor : public Compressor {
  public:
   ZstdCompressor(CephContext *cct) : Compressor(COMP_ALG_ZSTD, "zstd"), cct(cct) {}
+  ~ZstdCompressor() override {
+    ZSTD_freeCDict(cdict);
+    ZSTD_freeDDict(ddict);
+  }
+
+  int set_dictionary(const ceph::buffer::list &dict) override {
+    ceph::buffer::list d = dict;
+    const char *data = d.c_str();
+    // only trained dictionaries carry an id, which lets zstd refuse frames
+    // compressed with a dictionary other than ours
+    if (ZSTD_getDictID_fromDict(data, d.length()) == 0) {
+      return -EINVAL;
+    }
+    ZSTD_CDict *c = ZSTD_createCDict(data, d.length(),
+                                     cct->_conf->compressor_zstd_level);
+    ZSTD_DDict *dd = ZSTD_createDDict(data, d.length());
+    if (!c || !dd) {
+      ZSTD_freeCDict(c);
+      ZSTD_freeDDict(dd);
+      return -ENOMEM;
+    }
+    ZSTD_freeCDict(cdict);
+    ZSTD_freeDDict(ddict);
+    cdict = c;
+    ddict = dd;
+    return 0;
+  }
+
+  uint32_t get_dictionary_id() const override {
+    return ddict ? ZSTD_getDictID_fromDDict(ddict) : 0;
+  }
 
   int compress(const ceph::buffer::list &src, ceph::buffer::list &dst, std::optional<int32_t> &compressor_message) override {
     ZSTD_CCtx *s = ZSTD_createCCtx();
@@ -47,6 +78,13 @@ class ZstdCompressor : public Compressor {
       ZSTD_freeCCtx(s);
       return -EINVAL;
     }
+    if (cdict) {
+      res = ZSTD_CCtx_refCDict(s, cdict);
+      if (ZSTD_isError(res)) {
+        ZSTD_freeCCtx(s);
+        return -EINVAL;
+      }
+    }
     auto p = src.begin();
     size_t left = src.length();
 
@@ -103,15 +141,24 @@ class ZstdCompressor : public Compressor {
     outbuf.pos = 0;
     ZSTD_DStream *s = ZSTD_createDStream();
     ZSTD_initDStream(s);
+    if (ddict) {
+      ZSTD_DCtx_refDDict(s, ddict);
+    }
     while (compressed_len > 0) {
       if (p.end()) {
+	ZSTD_freeDStream(s);
 	return -1;
       }
       ZSTD_inBuffer_s inbuf;
       inbuf.pos = 0;
       inbuf.size = p.get_ptr_and_advance(compressed_len,
 					 (const char**)&inbuf.src);
-      ZSTD_decompressStream(s, &outbuf, &inbuf);
+      size_t r = ZSTD_decompressStream(s, &outbuf, &inbuf);
+      if (ZSTD_isError(r)) {
+	// e.g. compressed with a dictionary we do not have
+	ZSTD_freeDStream(s);
+	return -EINVAL;
+      }
       compressed_len -= inbuf.size;
     }
     ZSTD_freeDStream(s);
@@ -121,6 +168,8 @@ class ZstdCompressor : public Compressor {
   }
  private:
   CephContext *const cct;
+  ZSTD_CDict *cdict = nullptr;
+  ZSTD_DDict *ddict = nullptr;
 };
 
 #endif
@@ -120,6 +120,63 @@ __u32 crush_hash32_3(int type, __u32 a, __u32 b, __u32 c)
 	}
 }
 
+#ifdef __GNUC__
+/*
+ * crush_hash32_rjenkins1_3() of a block of b, one lane of the vectors
+ * for each of them.
+ */
+typedef __u32 crush_hash_vec
+	__attribute__((vector_size(CRUSH_HASH_BLOCK * sizeof(__u32))));
+
+static void crush_hash32_rjenkins1_3_block(__u32 a_, const __s32 *b_,
+					   __u32 c_, __u32 *out)
+{
+	crush_hash_vec a, b, c, hash, x, y;
+	int i;
+
+	for (i = 0; i < CRUSH_HASH_BLOCK; i++) {
+		a[i] = a_;
+		b[i] = b_[i];
+		c[i] = c_;
+		x[i] = 231232;
+		y[i] = 1232;
+	}
+	hash = crush_hash_seed ^ a ^ b ^ c;
+	crush_hashmix(a, b, hash);
+	crush_hashmix(c, x, hash);
+	crush_hashmix(y, a, hash);
+	crush_hashmix(b, x, hash);
+	crush_hashmix(y, c, hash);
+	for (i = 0; i < CRUSH_HASH_BLOCK; i++)
+		out[i] = hash[i];
+}
+#else
+static void crush_hash32_rjenkins1_3_block(__u32 a, const __s32 *b, __u32 c,
+					   __u32 *out)
+{
+	int i;
+
+	for (i = 0; i < CRUSH_HASH_BLOCK; i++)
+		out[i] = crush_hash32_rjenkins1_3(a, b[i], c);
+}
+#endif
+
+void crush_hash32_3_block(int type, __u32 a, const __s32 *b, __u32 c,
+			  __u32 *out)
+{
+	int i;
+
+	switch (type) {
+	case CRUSH_HASH_RJENKINS1:
+		crush_hash32_rjenkins1_3_block(a, b, c, out);
+		break;
+	default:
+		for (i = 0; i < CRUSH_HASH_BLOCK; i++)
+			out[i] = 0;
+		break;
+	}
+}
+
 __u32 crush_hash32_4(int type, __u32 a, __u32 b, __u32 c, __u32 d)
 {
 	switch (type) {
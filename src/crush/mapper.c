@@ -312,10 +312,8 @@ static inline __s32 *get_choose_arg_ids(const struct crush_bucket_straw2 *bucket
  * for reference, see the exponential distribution example at:  
  * https://en.wikipedia.org/wiki/Inverse_transform_sampling#Examples
  */
-static inline __s64 generate_exponential_distribution(int type, int x, int y, int z, 
-                                                      int weight)
+static inline __s64 exponential_distribution_of_hash(unsigned int u, int weight)
 {
-	unsigned int u = crush_hash32_3(type, x, y, z);
 	u &= 0xffff;
 
 	/*
@@ -339,25 +337,43 @@ static inline __s64 generate_exponential_distribution(int type, int x, int y, in
 	return div64_s64(ln, weight);
 }
 
+/*
+ * The hashes of the items are computed CRUSH_HASH_BLOCK at a time, so
+ * that they can be vectorized, before their draws are compared in
+ * order.  The result is the same as drawing one item after the other.
+ */
 static int bucket_straw2_choose(const struct crush_bucket_straw2 *bucket,
 				int x, int r, const struct crush_choose_arg *arg,
                                 int position)
 {
-	unsigned int i, high = 0;
+	unsigned int i, j, n, high = 0;
 	__s64 draw, high_draw = 0;
         __u32 *weights = get_choose_arg_weights(bucket, arg, position);
         __s32 *ids = get_choose_arg_ids(bucket, arg);
-	for (i = 0; i < bucket->h.size; i++) {
-                dprintk("weight 0x%x item %d\n", weights[i], ids[i]);
-		if (weights[i]) {
-			draw = generate_exponential_distribution(bucket->h.hash, x, ids[i], r, weights[i]);
+	__u32 u[CRUSH_HASH_BLOCK];
+	for (i = 0; i < bucket->h.size; i += n) {
+		n = MIN(bucket->h.size - i, CRUSH_HASH_BLOCK);
+		if (n == CRUSH_HASH_BLOCK) {
+			crush_hash32_3_block(bucket->h.hash, x, ids + i, r, u);
 		} else {
-			draw = S64_MIN;
+			for (j = 0; j < n; j++)
+				u[j] = crush_hash32_3(bucket->h.hash, x,
+						      ids[i + j], r);
 		}
+		for (j = 0; j < n; j++) {
+			dprintk("weight 0x%x item %d\n", weights[i + j],
+				ids[i + j]);
+			if (weights[i + j]) {
+				draw = exponential_distribution_of_hash(
+					u[j], weights[i + j]);
+			} else {
+				draw = S64_MIN;
+			}
 
-		if (i == 0 || draw > high_draw) {
-			high = i;
-			high_draw = draw;
+			if (i + j == 0 || draw > high_draw) {
+				high = i + j;
+				high_draw = draw;
+			}
 		}
 	}
 
@@ -2051,3 +2067,35 @@ int crush_do_rule(const struct crush_map *map,
 			choose_args);
 	}
 }
+
+void crush_do_rule_batch(const struct crush_map *map,
+			 int ruleno,
+			 const int *x, int n,
+			 int *result, int *result_len, int result_max,
+			 const __u32 *weight, int weight_max,
+			 void *cwin, const struct crush_choose_arg *choose_args)
+{
+	const struct crush_rule *rule;
+	int (*do_rule)(const struct crush_map *, int, int, int *, int,
+		       const __u32 *, int, void *,
+		       const struct crush_choose_arg *);
+	int i;
+
+	if ((__u32)ruleno >= map->max_rules) {
+		dprintk(" bad ruleno %d\n", ruleno);
+		for (i = 0; i < n; i++)
+			result_len[i] = 0;
+		return;
+	}
+
+	rule = map->rules[ruleno];
+	if (rule_type_is_msr(rule->type))
+		do_rule = crush_msr_do_rule;
+	else
+		do_rule = crush_do_rule_no_retry;
+	for (i = 0; i < n; i++) {
+		result_len[i] = do_rule(map, ruleno, x[i],
+					result + i * result_max, result_max,
+					weight, weight_max, cwin, choose_args);
+	}
+}
@@ -94,6 +94,33 @@ extern int crush_do_rule(const struct crush_map *map,
 			 const __u32 *weights, int weight_max,
 			 void *cwin, const struct crush_choose_arg *choose_args);
 
+/** @ingroup API
+ *
+ * Map each of the __n__ inputs of __x__ through the rule __ruleno__,
+ * as crush_do_rule() would, sharing __cwin__ between them. The items
+ * of __x[i]__ are stored in __result[i * result_max]__ onwards and
+ * their number in __result_len[i]__.
+ *
+ * @param map the crush_map
+ * @param ruleno a positive integer < __CRUSH_MAX_RULES__
+ * @param x an array of __n__ values to map
+ * @param n the size of the __x__ array
+ * @param result an array of items of size __n__ * __result_max__
+ * @param result_len an array of size __n__
+ * @param result_max the maximum number of items of an input
+ * @param weights an array of weights of size __weight_max__
+ * @param weight_max the size of the __weights__ array
+ * @param cwin must be an char array initialized by crush_init_workspace
+ * @param choose_args weights and ids for each known bucket
+ */
+extern void crush_do_rule_batch(const struct crush_map *map,
+				int ruleno,
+				const int *x, int n,
+				int *result, int *result_len, int result_max,
+				const __u32 *weights, int weight_max,
+				void *cwin,
+				const struct crush_choose_arg *choose_args);
+
 /* Returns enough workspace for any crush rule within map to generate
    result_max outputs. The caller can then allocate this much on its own,
    either on the stack, in a per-thread long-lived buffer, or however it likes.*/
@@ -368,6 +368,54 @@ int ErasureCode::encode(const shard_id_set &want_to_encode,
   return 0;
 }
 
+char *ErasureCode::ChunkScratch::get_zeros(unsigned size)
+{
+  if (!zeros.have_raw() || zeros.length() < size) {
+    zeros = buffer::create_aligned(std::max(size, 1u), SIMD_ALIGN);
+    zeros.zero();
+  }
+  return zeros.c_str();
+}
+
+char *ErasureCode::ChunkScratch::get_shard(unsigned shard, unsigned size)
+{
+  if (shards.size() <= shard) {
+    shards.resize(shard + 1);
+  }
+  bufferptr &bp = shards[shard];
+  if (!bp.have_raw() || bp.length() < size) {
+    bp = buffer::create_aligned(std::max(size, 1u), SIMD_ALIGN);
+  }
+  return bp.c_str();
+}
+
+int ErasureCode::encode_chunks_batch(
+  const vector<shard_id_map<bufferptr>> &in,
+  vector<shard_id_map<bufferptr>> &out)
+{
+  ceph_assert(in.size() == out.size());
+  for (size_t i = 0; i < in.size(); ++i) {
+    if (int r = encode_chunks(in[i], out[i])) {
+      return r;
+    }
+  }
+  return 0;
+}
+
+int ErasureCode::decode_chunks_batch(
+  const shard_id_set &want_to_read,
+  vector<shard_id_map<bufferptr>> &in,
+  vector<shard_id_map<bufferptr>> &out)
+{
+  ceph_assert(in.size() == out.size());
+  for (size_t i = 0; i < in.size(); ++i) {
+    if (int r = decode_chunks(want_to_read, in[i], out[i])) {
+      return r;
+    }
+  }
+  return 0;
+}
+
 IGNORE_DEPRECATED
 [[deprecated]]
 int ErasureCode::_decode(const set<int> &want_to_read,
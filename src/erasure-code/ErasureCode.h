@@ -106,6 +106,15 @@ class ErasureCode : public ErasureCodeInterface {
              const bufferlist &in,
              mini_flat_map<shard_id_t, bufferlist> *encoded) override;
 
+  int encode_chunks_batch(
+    const std::vector<shard_id_map<bufferptr>> &in,
+    std::vector<shard_id_map<bufferptr>> &out) override;
+
+  int decode_chunks_batch(
+    const shard_id_set &want_to_read,
+    std::vector<shard_id_map<bufferptr>> &in,
+    std::vector<shard_id_map<bufferptr>> &out) override;
+
   [[deprecated]]
   int encode(const std::set<int> &want_to_encode,
              const bufferlist &in,
@@ -174,6 +183,21 @@ class ErasureCode : public ErasureCodeInterface {
  protected:
   int parse(const ErasureCodeProfile &profile, std::ostream *ss);
 
+  /**
+   * Buffers standing in for the shards that the caller of encode_chunks
+   * or decode_chunks did not provide. A batch keeps one instance across
+   * all its stripes so that they are allocated once, not per stripe.
+   */
+  class ChunkScratch {
+    bufferptr zeros;
+    std::vector<bufferptr> shards;
+  public:
+    /// read-only buffer of at least size zero bytes, shared by all shards
+    char *get_zeros(unsigned size);
+    /// writable buffer of at least size bytes, private to shard
+    char *get_shard(unsigned shard, unsigned size);
+  };
+
  private:
   [[deprecated]]
   unsigned int chunk_index(unsigned int i) const;
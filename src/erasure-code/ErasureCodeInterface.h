@@ -448,6 +448,26 @@ namespace ceph {
     virtual int encode_chunks(const shard_id_map<bufferptr> &in,
                               shard_id_map<bufferptr> &out) = 0;
 
+    /**
+     * Encode several independent stripes in a single call. Each pair
+     * **in[i]**, **out[i]** follows the rules of encode_chunks and the
+     * result is the same as calling encode_chunks(in[i], out[i]) for
+     * every i, but the plugin only pays its per-call set-up (coding
+     * tables, scratch buffers for absent shards) once for the whole
+     * batch. Buffer lengths may differ between stripes of the batch.
+     *
+     * Returns 0 on success, or the first error returned for a stripe,
+     * in which case the content of the remaining **out** buffers is
+     * undefined.
+     *
+     * @param [in] in one map of data shards to be encoded per stripe
+     * @param [out] out one map of empty parity buffers per stripe
+     * @return **0** on success or a negative errno on error.
+     */
+    virtual int encode_chunks_batch(
+      const std::vector<shard_id_map<bufferptr>> &in,
+      std::vector<shard_id_map<bufferptr>> &out) = 0;
+
     /**
      * Calculate the delta between the old_data and new_data buffers using xor,
      * (or plugin-specific implementation) and returns the result in the
@@ -571,6 +591,25 @@ namespace ceph {
                               shard_id_map<bufferptr> &in,
                               shard_id_map<bufferptr> &out) = 0;
 
+    /**
+     * Decode several independent stripes in a single call. Each pair
+     * **in[i]**, **out[i]** follows the rules of decode_chunks and the
+     * result is the same as calling decode_chunks(want_to_read, in[i],
+     * out[i]) for every i, but the plugin only pays its per-call set-up
+     * (decoding tables, scratch buffers) once for the whole batch.
+     * Buffer lengths and the set of available shards may differ between
+     * stripes of the batch.
+     *
+     * @param [in] want_to_read shard indexes to be decoded
+     * @param [in] in one map of available shards per stripe
+     * @param [out] out one map of shards to be decoded per stripe
+     * @return **0** on success or a negative errno on error.
+     */
+    virtual int decode_chunks_batch(
+      const shard_id_set &want_to_read,
+      std::vector<shard_id_map<bufferptr>> &in,
+      std::vector<shard_id_map<bufferptr>> &out) = 0;
+
     [[deprecated]]
     virtual int decode_chunks(const std::set<int> &want_to_read,
                               const std::map<int, bufferlist> &chunks,
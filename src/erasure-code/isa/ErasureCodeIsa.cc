@@ -117,6 +117,28 @@ int ErasureCodeIsa::decode_chunks(const set<int> &want_to_read,
 
 int ErasureCodeIsa::encode_chunks(const shard_id_map<bufferptr> &in,
                                        shard_id_map<bufferptr> &out)
+{
+  ChunkScratch scratch;
+  return _encode_chunks(in, out, scratch);
+}
+
+int ErasureCodeIsa::encode_chunks_batch(
+  const vector<shard_id_map<bufferptr>> &in,
+  vector<shard_id_map<bufferptr>> &out)
+{
+  ceph_assert(in.size() == out.size());
+  ChunkScratch scratch;
+  for (size_t i = 0; i < in.size(); ++i) {
+    if (int r = _encode_chunks(in[i], out[i], scratch)) {
+      return r;
+    }
+  }
+  return 0;
+}
+
+int ErasureCodeIsa::_encode_chunks(const shard_id_map<bufferptr> &in,
+                                   shard_id_map<bufferptr> &out,
+                                   ChunkScratch &scratch)
 {
   char *chunks[k + m]; //TODO don't use variable length arrays
   memset(chunks, 0, sizeof(char*) * (k + m));
@@ -140,37 +162,54 @@ int ErasureCodeIsa::encode_chunks(const shard_id_map<bufferptr> &in,
     chunks[static_cast<int>(shard)] = ptr.c_str();
   }
 
-  char *zeros = nullptr;
-
   for (shard_id_t i; i < k + m; ++i) {
     if (in.contains(i) || out.contains(i)) {
       continue;
     }
-
-    if (zeros == nullptr) {
-      zeros = (char*)malloc(size);
-      memset(zeros, 0, size);
+    // absent data shards read as zeros, absent parity is computed and
+    // thrown away, so it must not land in the shared zero buffer
+    if (i < k) {
+      chunks[static_cast<int>(i)] = scratch.get_zeros(size);
+    } else {
+      chunks[static_cast<int>(i)] = scratch.get_shard(static_cast<int>(i), size);
     }
-
-    chunks[static_cast<int>(i)] = zeros;
   }
 
   isa_encode(&chunks[0], &chunks[k], size);
 
-  if (zeros != nullptr) {
-    free(zeros);
-  }
-
   return 0;
 }
 
 int ErasureCodeIsa::decode_chunks(const shard_id_set &want_to_read,
                                   shard_id_map<bufferptr> &in,
                                   shard_id_map<bufferptr> &out)
+{
+  ChunkScratch scratch;
+  return _decode_chunks(want_to_read, in, out, scratch);
+}
+
+int ErasureCodeIsa::decode_chunks_batch(
+  const shard_id_set &want_to_read,
+  vector<shard_id_map<bufferptr>> &in,
+  vector<shard_id_map<bufferptr>> &out)
+{
+  ceph_assert(in.size() == out.size());
+  ChunkScratch scratch;
+  for (size_t i = 0; i < in.size(); ++i) {
+    if (int r = _decode_chunks(want_to_read, in[i], out[i], scratch)) {
+      return r;
+    }
+  }
+  return 0;
+}
+
+int ErasureCodeIsa::_decode_chunks(const shard_id_set &want_to_read,
+                                   shard_id_map<bufferptr> &in,
+                                   shard_id_map<bufferptr> &out,
+                                   ChunkScratch &scratch)
 {
   unsigned int size = 0;
   shard_id_set erasures_set;
-  shard_id_set to_free;
   erasures_set.insert_range(shard_id_t(0), k + m);
   int erasures[k + m + 1];
   int erasures_count = 0;
@@ -212,15 +251,14 @@ int ErasureCodeIsa::decode_chunks(const shard_id_set &want_to_read,
   for (int i = 0; i < k + m; i++) {
     char **buf = i < k ? &data[i] : &coding[i - k];
     if (*buf == nullptr) {
-      *buf = (char *)malloc(size);
-      ceph_assert(buf != nullptr);
-      to_free.insert(shard_id_t(i));
       /* If buffer was not provided, is not an erasure (i.e. in the out map),
        * and a data shard, then it can be assumed to be zero. This is most
        * likely due to EC shards being different sizes.
        */
       if (i < k && !erasures_set.contains(shard_id_t(i))) {
-        memset(*buf, 0, size);
+        *buf = scratch.get_zeros(size);
+      } else {
+        *buf = scratch.get_shard(i, size);
       }
     }
   }
@@ -232,14 +270,7 @@ int ErasureCodeIsa::decode_chunks(const shard_id_set &want_to_read,
 
   erasures[erasures_count] = -1;
   ceph_assert(erasures_count > 0);
-  int r = isa_decode(erasures, data, coding, size);
-  for (auto & shard : to_free) {
-    int i = static_cast<int>(shard);
-    char **buf = i < k ? &data[i] : &coding[i - k];
-    free(*buf);
-    *buf = nullptr;
-  }
-  return r;
+  return isa_decode(erasures, data, coding, size);
 }
 
 // -----------------------------------------------------------------------------
@@ -455,96 +486,195 @@ ErasureCodeIsaDefault::isa_decode(int *erasures,
     return 0;
   }
 
-  unsigned char d[k * (m + k)];
   unsigned char decode_tbls[k * (m + k)*32];
   unsigned char *p_tbls = decode_tbls;
+  ceph::buffer::ptr pinned_tbls;
 
   int decode_index[k];
 
-  std::string erasure_signature; // describes a matrix configuration for caching
+  // describes a matrix configuration for caching
+  std::string erasure_signature =
+    make_erasure_signature(k, erasures, nerrs, decode_index);
+
+  // ---------------------------------------------
+  // Try to get an already computed matrix
+  // ---------------------------------------------
+  if (tcache.getPinnedDecodingTable(erasure_signature, matrixtype, &pinned_tbls)) {
+    p_tbls = (unsigned char*) pinned_tbls.c_str();
+  } else if (!tcache.getDecodingTableFromCache(erasure_signature, p_tbls, matrixtype, k, m)) {
+    if (make_decoding_table(encode_coeff, k, erasures, nerrs, decode_index,
+                            decode_tbls) < 0) {
+      dout(0) << "isa_decode: bad matrix" << dendl;
+      return -1;
+    }
+    tcache.putDecodingTableToCache(erasure_signature, p_tbls, matrixtype, k, m);
+  }
+  // Recover data sources
+  ec_encode_data(blocksize,
+                 k, nerrs, p_tbls, recover_source, recover_target);
+
+
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+
+std::string
+ErasureCodeIsaDefault::make_erasure_signature(int k,
+                                              const int *erasures,
+                                              int nerrs,
+                                              int *decode_index)
+{
+  std::string signature;
 
   // ---------------------------------------------
   // Construct b by removing error rows
   // ---------------------------------------------
 
-  for (i = 0, r = 0; i < k; i++, r++) {
+  for (int i = 0, r = 0; i < k; i++, r++) {
     char id[128];
-    while (erasure_contains(erasures, r))
+    while (std::find(erasures, erasures + nerrs, r) != erasures + nerrs)
       r++;
 
     decode_index[i] = r;
 
     snprintf(id, sizeof (id), "+%d", r);
-    erasure_signature += id;
+    signature += id;
   }
 
   for (int p = 0; p < nerrs; p++) {
     char id[128];
     snprintf(id, sizeof (id), "-%d", erasures[p]);
-    erasure_signature += id;
+    signature += id;
   }
+  return signature;
+}
 
+// -----------------------------------------------------------------------------
+
+int
+ErasureCodeIsaDefault::make_decoding_table(const unsigned char *encode_coeff,
+                                           int k,
+                                           const int *erasures,
+                                           int nerrs,
+                                           const int *decode_index,
+                                           unsigned char *decode_tbls)
+{
+  int i, j, r;
+  unsigned char b[k * k];
+  unsigned char c[k * nerrs];
+  unsigned char d[k * k];
+
+  for (i = 0; i < k; i++) {
+    r = decode_index[i];
+    for (j = 0; j < k; j++)
+      b[k * i + j] = encode_coeff[k * r + j];
+  }
   // ---------------------------------------------
-  // Try to get an already computed matrix
+  // Compute inverted matrix
   // ---------------------------------------------
-  if (!tcache.getDecodingTableFromCache(erasure_signature, p_tbls, matrixtype, k, m)) {
-    int j;
-    unsigned char b[k * (m + k)];
-    unsigned char c[k * (m + k)];
-
-    for (i = 0; i < k; i++) {
-      r = decode_index[i];
-      for (j = 0; j < k; j++)
-        b[k * i + j] = encode_coeff[k * r + j];
-    }
-    // ---------------------------------------------
-    // Compute inverted matrix
-    // ---------------------------------------------
-
-    // --------------------------------------------------------
-    // Remark: this may fail for certain Vandermonde matrices !
-    // There is an advanced way trying to use different
-    // source chunks to get an invertible matrix, however
-    // there are also (k,m) combinations which cannot be
-    // inverted when m chunks are lost and this optimizations
-    // does not help. Therefor we keep the code simpler.
-    // --------------------------------------------------------
-    if (gf_invert_matrix(b, d, k) < 0) {
-      dout(0) << "isa_decode: bad matrix" << dendl;
-      return -1;
-    }
 
-    for (int p = 0; p < nerrs; p++) {
-      if (erasures[p] < k) {
-        // decoding matrix elements for data chunks
-        for (j = 0; j < k; j++) {
-          c[k * p + j] = d[k * erasures[p] + j];
-        }
-      } else {
-        // decoding matrix element for coding chunks
-        for (i = 0; i < k; i++) {
-          int s = 0;
-          for (j = 0; j < k; j++)
-            s ^= gf_mul(d[j * k + i],
-                        encode_coeff[k * erasures[p] + j]);
-
-          c[k * p + i] = s;
-        }
+  // --------------------------------------------------------
+  // Remark: this may fail for certain Vandermonde matrices !
+  // There is an advanced way trying to use different
+  // source chunks to get an invertible matrix, however
+  // there are also (k,m) combinations which cannot be
+  // inverted when m chunks are lost and this optimizations
+  // does not help. Therefor we keep the code simpler.
+  // --------------------------------------------------------
+  if (gf_invert_matrix(b, d, k) < 0) {
+    return -1;
+  }
+
+  for (int p = 0; p < nerrs; p++) {
+    if (erasures[p] < k) {
+      // decoding matrix elements for data chunks
+      for (j = 0; j < k; j++) {
+        c[k * p + j] = d[k * erasures[p] + j];
+      }
+    } else {
+      // decoding matrix element for coding chunks
+      for (i = 0; i < k; i++) {
+        int s = 0;
+        for (j = 0; j < k; j++)
+          s ^= gf_mul(d[j * k + i],
+                      encode_coeff[k * erasures[p] + j]);
+
+        c[k * p + i] = s;
       }
     }
+  }
 
-    // ---------------------------------------------
-    // Initialize Decoding Table
-    // ---------------------------------------------
-    ec_init_tables(k, nerrs, c, decode_tbls);
-    tcache.putDecodingTableToCache(erasure_signature, p_tbls, matrixtype, k, m);
+  // ---------------------------------------------
+  // Initialize Decoding Table
+  // ---------------------------------------------
+  ec_init_tables(k, nerrs, c, decode_tbls);
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+
+void
+ErasureCodeIsaDefault::precompute_decoding_tables(uint64_t max_bytes)
+{
+  // with a single parity chunk decoding is done with xor_gen()
+  if (m == 1) {
+    return;
   }
-  // Recover data sources
-  ec_encode_data(blocksize,
-                 k, nerrs, decode_tbls, recover_source, recover_target);
 
+  // A decode either gets all the available chunks, then the erasures are
+  // the lost chunks, or only the first k of them, then every other chunk
+  // is an erasure. Enumerate both for the loss of one or two chunks.
+  tcache.precomputeDecodingTables(
+    matrixtype, k, m,
+    [k = k, m = m, matrixtype = matrixtype, encode_coeff = encode_coeff,
+     max_bytes]
+    (ErasureCodeIsaTableCache::pinned_map_t &tables) {
+      int n = k + m;
+      uint64_t bytes = 0;
+      auto add = [&](const int *erasures, int nerrs) {
+        int decode_index[k];
+        std::string signature =
+          make_erasure_signature(k, erasures, nerrs, decode_index);
+        if (tables.count(signature)) {
+          return;
+        }
+        ceph::buffer::ptr tbls = ceph::buffer::create(k * nerrs * 32);
+        if (make_decoding_table(encode_coeff, k, erasures, nerrs,
+                                decode_index,
+                                (unsigned char*) tbls.c_str()) == 0) {
+          tables[signature] = tbls;
+          bytes += tbls.length();
+        }
+      };
+      // f1 == -1 enumerates the single failures first
+      for (int f1 = -1; f1 < n && bytes < max_bytes; f1++) {
+        for (int f2 = f1 + 1; f2 < n && bytes < max_bytes; f2++) {
+          int lost[2];
+          int nlost = 0;
+          if (f1 >= 0) {
+            lost[nlost++] = f1;
+          }
+          lost[nlost++] = f2;
+          // a single lost chunk up to the first parity is xor decoded
+          if (!(matrixtype == kVandermonde && nlost == 1 && f2 < k + 1)) {
+            add(lost, nlost);
+          }
 
-  return 0;
+          int erasures[n];
+          int nerrs = 0;
+          int avail = 0;
+          for (int i = 0; i < n; i++) {
+            if (i == f1 || i == f2 || avail == k) {
+              erasures[nerrs++] = i;
+            } else {
+              avail++;
+            }
+          }
+          add(erasures, nerrs);
+        }
+      }
+    });
 }
 
 // -----------------------------------------------------------------------------
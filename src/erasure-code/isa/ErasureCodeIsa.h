@@ -116,6 +116,14 @@ public:
                     shard_id_map<bufferptr> &in,
                     shard_id_map<bufferptr> &out) override;
 
+  int encode_chunks_batch(
+    const std::vector<shard_id_map<bufferptr>> &in,
+    std::vector<shard_id_map<bufferptr>> &out) override;
+  int decode_chunks_batch(
+    const shard_id_set &want_to_read,
+    std::vector<shard_id_map<bufferptr>> &in,
+    std::vector<shard_id_map<bufferptr>> &out) override;
+
   int init(ceph::ErasureCodeProfile &profile, std::ostream *ss) override;
 
   void isa_xor(char **data, char *coding, int blocksize, int data_vectors);
@@ -136,6 +144,14 @@ public:
   virtual void prepare() = 0;
 
  private:
+  int _encode_chunks(const shard_id_map<bufferptr> &in,
+                     shard_id_map<bufferptr> &out,
+                     ChunkScratch &scratch);
+  int _decode_chunks(const shard_id_set &want_to_read,
+                     shard_id_map<bufferptr> &in,
+                     shard_id_map<bufferptr> &out,
+                     ChunkScratch &scratch);
+
   virtual int parse(ceph::ErasureCodeProfile &profile,
                     std::ostream *ss) = 0;
 };
@@ -196,9 +212,25 @@ public:
 
   void prepare() override;
 
+  // compute the decoding tables of single and then double failures in the
+  // background, up to max_bytes, and share them through the table cache
+  void precompute_decoding_tables(uint64_t max_bytes);
+
  private:
   int parse(ceph::ErasureCodeProfile &profile,
             std::ostream *ss) override;
+
+  static std::string make_erasure_signature(int k,
+                                            const int *erasures,
+                                            int nerrs,
+                                            int *decode_index);
+
+  static int make_decoding_table(const unsigned char *encode_coeff,
+                                 int k,
+                                 const int *erasures,
+                                 int nerrs,
+                                 const int *decode_index,
+                                 unsigned char *decode_tbls);
 };
 static_assert(!std::is_abstract<ErasureCodeIsaDefault>());
 
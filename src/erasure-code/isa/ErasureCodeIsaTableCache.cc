@@ -26,6 +26,7 @@
 // -----------------------------------------------------------------------------
 #include "ErasureCodeIsaTableCache.h"
 #include "common/debug.h"
+#include "common/Thread.h"
 // -----------------------------------------------------------------------------
 
 // -----------------------------------------------------------------------------
@@ -47,6 +48,9 @@ _tc_prefix(std::ostream* _dout)
 
 ErasureCodeIsaTableCache::~ErasureCodeIsaTableCache()
 {
+  // the precompute threads use the encoding coefficients freed below
+  waitForPrecompute();
+
   std::lock_guard lock{codec_tables_guard};
 
   codec_technique_tables_t::const_iterator ttables_it;
@@ -325,3 +329,102 @@ ErasureCodeIsaTableCache::putDecodingTableToCache(std::string &signature,
   // copy-in the new table
   memcpy(cachetable.c_str(), table, k * (m + k)*32);
 }
+
+// -----------------------------------------------------------------------------
+
+bool
+ErasureCodeIsaTableCache::getPinnedDecodingTable(const std::string &signature,
+                                                 int matrixtype,
+                                                 ceph::buffer::ptr *table)
+{
+  if (matrixtype < 0 || matrixtype >= pinned_matrix_types) {
+    return false;
+  }
+  auto pinned = decoding_tables_pinned[matrixtype].load();
+  if (!pinned) {
+    return false;
+  }
+  auto it = pinned->find(signature);
+  if (it == pinned->end()) {
+    return false;
+  }
+  dout(12) << "[ pinned table ] = " << signature << dendl;
+  *table = it->second;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+
+int
+ErasureCodeIsaTableCache::getPinnedDecodingTableCount(int matrixtype)
+{
+  if (matrixtype < 0 || matrixtype >= pinned_matrix_types) {
+    return -1;
+  }
+  auto pinned = decoding_tables_pinned[matrixtype].load();
+  return pinned ? pinned->size() : 0;
+}
+
+// -----------------------------------------------------------------------------
+
+void
+ErasureCodeIsaTableCache::pinDecodingTables(int matrixtype,
+                                            pinned_map_t &tables)
+{
+  // the caller must hold the guard mutex, it serializes the writers while
+  // readers keep using the map they loaded
+  auto pinned = std::make_shared<pinned_map_t>();
+  if (auto current = decoding_tables_pinned[matrixtype].load(); current) {
+    *pinned = *current;
+  }
+  pinned->merge(tables);
+  dout(10) << "[ pinned tables ] = " << pinned->size() << dendl;
+  decoding_tables_pinned[matrixtype].store(std::move(pinned));
+}
+
+// -----------------------------------------------------------------------------
+
+bool
+ErasureCodeIsaTableCache::precomputeDecodingTables(int matrixtype,
+                                                   int k,
+                                                   int m,
+                                                   std::function<void(pinned_map_t&)> compute)
+{
+  if (matrixtype < 0 || matrixtype >= pinned_matrix_types) {
+    return false;
+  }
+
+  std::lock_guard lock{codec_tables_guard};
+
+  if (!precompute_started.emplace(matrixtype, k, m).second) {
+    return false;
+  }
+
+  dout(10) << "[ precompute   ] matrix=" << matrixtype << " k=" << k
+           << " m=" << m << dendl;
+
+  precompute_threads.push_back(make_named_thread(
+    "isa_precompute",
+    [this, matrixtype, compute = std::move(compute)] {
+      pinned_map_t tables;
+      compute(tables);
+      std::lock_guard lock{codec_tables_guard};
+      pinDecodingTables(matrixtype, tables);
+    }));
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+
+void
+ErasureCodeIsaTableCache::waitForPrecompute()
+{
+  std::vector<std::thread> threads;
+  {
+    std::lock_guard lock{codec_tables_guard};
+    threads.swap(precompute_threads);
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+}
@@ -29,7 +29,14 @@
 #include "common/ceph_mutex.h"
 #include "erasure-code/ErasureCodeInterface.h"
 // -----------------------------------------------------------------------------
+#include <atomic>
+#include <functional>
 #include <list>
+#include <memory>
+#include <set>
+#include <thread>
+#include <tuple>
+#include <vector>
 // -----------------------------------------------------------------------------
 
 class ErasureCodeIsaTableCache {
@@ -39,6 +46,11 @@ class ErasureCodeIsaTableCache {
   // a decoding matrix lru cache which is shared for identical
   // matrix types e.g. there is one cache (lru-list + lru-map) for Cauchy and
   // one for Vandermonde matrices!
+  //
+  // Decoding tables can also be precomputed in a background thread when a
+  // profile is set up. These are kept in an immutable map per matrix type
+  // which is replaced as a whole, so they are never evicted and are looked
+  // up without taking the mutex.
   // ---------------------------------------------------------------------------
 
 public:
@@ -55,6 +67,8 @@ public:
   typedef std::map< std::string, lru_entry_t > lru_map_t;
   typedef std::list< std::string > lru_list_t;
 
+  typedef std::map< std::string, ceph::buffer::ptr > pinned_map_t;
+
   ErasureCodeIsaTableCache() = default;
 
   virtual ~ErasureCodeIsaTableCache();
@@ -85,6 +99,21 @@ public:
 
   int getDecodingTableCacheSize(int matrixtype = 0);
 
+  bool getPinnedDecodingTable(const std::string &signature,
+                              int matrixtype,
+                              ceph::buffer::ptr *table);
+
+  // run compute in a background thread once per (matrixtype,k,m) and
+  // publish the tables it returns, returns false if already started
+  bool precomputeDecodingTables(int matrixtype,
+                                int k,
+                                int m,
+                                std::function<void(pinned_map_t&)> compute);
+
+  void waitForPrecompute();
+
+  int getPinnedDecodingTableCount(int matrixtype = 0);
+
 private:
   codec_technique_tables_t encoding_coefficient; // encoding coefficients accessed via table[matrix][k][m]
   codec_technique_tables_t encoding_table; // encoding coefficients accessed via table[matrix][k][m]
@@ -92,6 +121,17 @@ private:
   std::map<int, lru_map_t*> decoding_tables; // decoding table cache accessed via map[matrixtype]
   std::map<int, lru_list_t*> decoding_tables_lru; // decoding table lru list accessed via list[matrixtype]
 
+  static const int pinned_matrix_types = 2;
+
+  // precomputed decoding tables accessed via pinned[matrixtype]
+  std::atomic<std::shared_ptr<const pinned_map_t>>
+    decoding_tables_pinned[pinned_matrix_types];
+
+  std::set<std::tuple<int, int, int>> precompute_started;
+  std::vector<std::thread> precompute_threads;
+
+  void pinDecodingTables(int matrixtype, pinned_map_t &tables);
+
   lru_map_t* getDecodingTables(int matrix_type);
 
   lru_list_t* getDecodingTablesLru(int matrix_type);
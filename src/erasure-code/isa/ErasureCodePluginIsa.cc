@@ -25,6 +25,8 @@
 
 // -----------------------------------------------------------------------------
 #include "ceph_ver.h"
+#include "common/config.h"
+#include "global/global_context.h"
 #include "include/buffer.h"
 #include "ErasureCodePluginIsa.h"
 #include "ErasureCodeIsa.h"
@@ -35,7 +37,7 @@ int ErasureCodePluginIsa::factory(const std::string &directory,
                                   ceph::ErasureCodeInterfaceRef *erasure_code,
                                   std::ostream *ss)
 {
-  ErasureCodeIsa *interface;
+  ErasureCodeIsaDefault *interface;
     std::string technique;
     technique = profile.find("technique")->second;
     std::string _m = profile.find("m")->second;
@@ -62,6 +64,10 @@ int ErasureCodePluginIsa::factory(const std::string &directory,
       delete interface;
       return r;
     }
+    if (uint64_t max_bytes = g_conf().get_val<Option::size_t>(
+          "erasure_code_isa_precompute_decode_tables"); max_bytes > 0) {
+      interface->precompute_decoding_tables(max_bytes);
+    }
     *erasure_code = ceph::ErasureCodeInterfaceRef(interface);
     return 0;
 }
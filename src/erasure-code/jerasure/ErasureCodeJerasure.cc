@@ -38,6 +38,7 @@ extern "C" {
 using std::ostream;
 using std::map;
 using std::set;
+using std::vector;
 
 using ceph::bufferlist;
 using ceph::ErasureCodeProfile;
@@ -116,6 +117,28 @@ int ErasureCodeJerasure::encode_chunks(const set<int> &want_to_encode,
 
 int ErasureCodeJerasure::encode_chunks(const shard_id_map<bufferptr> &in,
                                        shard_id_map<bufferptr> &out)
+{
+  ChunkScratch scratch;
+  return _encode_chunks(in, out, scratch);
+}
+
+int ErasureCodeJerasure::encode_chunks_batch(
+  const vector<shard_id_map<bufferptr>> &in,
+  vector<shard_id_map<bufferptr>> &out)
+{
+  ceph_assert(in.size() == out.size());
+  ChunkScratch scratch;
+  for (size_t i = 0; i < in.size(); ++i) {
+    if (int r = _encode_chunks(in[i], out[i], scratch)) {
+      return r;
+    }
+  }
+  return 0;
+}
+
+int ErasureCodeJerasure::_encode_chunks(const shard_id_map<bufferptr> &in,
+                                        shard_id_map<bufferptr> &out,
+                                        ChunkScratch &scratch)
 {
   char *chunks[k + m]; //TODO don't use variable length arrays
   memset(chunks, 0, sizeof(char*) * (k + m));
@@ -139,23 +162,19 @@ int ErasureCodeJerasure::encode_chunks(const shard_id_map<bufferptr> &in,
     chunks[static_cast<int>(shard)] = ptr.c_str();
   }
 
-  char *zeros = nullptr;
-
   for (shard_id_t i; i < k + m; ++i) {
     if (in.contains(i) || out.contains(i)) continue;
-
-    if (zeros == nullptr) {
-      zeros = (char*)malloc(size);
-      memset(zeros, 0, size);
+    // absent data shards read as zeros, absent parity is computed and
+    // thrown away, so it must not land in the shared zero buffer
+    if (i < k) {
+      chunks[static_cast<int>(i)] = scratch.get_zeros(size);
+    } else {
+      chunks[static_cast<int>(i)] = scratch.get_shard(static_cast<int>(i), size);
     }
-
-    chunks[static_cast<int>(i)] = zeros;
   }
 
   jerasure_encode(&chunks[0], &chunks[k], size);
 
-  if (zeros != nullptr) free(zeros);
-
   return 0;
 }
 
@@ -189,10 +208,33 @@ int ErasureCodeJerasure::decode_chunks(const set<int> &want_to_read,
 int ErasureCodeJerasure::decode_chunks(const shard_id_set &want_to_read,
                                   shard_id_map<bufferptr> &in,
                                   shard_id_map<bufferptr> &out)
+{
+  ChunkScratch scratch;
+  return _decode_chunks(want_to_read, in, out, scratch);
+}
+
+int ErasureCodeJerasure::decode_chunks_batch(
+  const shard_id_set &want_to_read,
+  vector<shard_id_map<bufferptr>> &in,
+  vector<shard_id_map<bufferptr>> &out)
+{
+  ceph_assert(in.size() == out.size());
+  ChunkScratch scratch;
+  for (size_t i = 0; i < in.size(); ++i) {
+    if (int r = _decode_chunks(want_to_read, in[i], out[i], scratch)) {
+      return r;
+    }
+  }
+  return 0;
+}
+
+int ErasureCodeJerasure::_decode_chunks(const shard_id_set &want_to_read,
+                                        shard_id_map<bufferptr> &in,
+                                        shard_id_map<bufferptr> &out,
+                                        ChunkScratch &scratch)
 {
   unsigned int size = 0;
   shard_id_set erasures_set;
-  shard_id_set to_free;
   erasures_set.insert_range(shard_id_t(0), k + m);
   int erasures[k + m + 1];
   int erasures_count = 0;
@@ -226,11 +268,11 @@ int ErasureCodeJerasure::decode_chunks(const shard_id_set &want_to_read,
   for (int i = 0; i < k + m; i++) {
     char **buf = i < k ? &data[i] : &coding[i - k];
     if (*buf == nullptr) {
-      *buf = (char *)malloc(size);
-      to_free.insert(shard_id_t(i));
       /* If we are inventing a buffer for non-erasure shard, its zeros! */
       if (i < k && !erasures_set.contains(shard_id_t(i))) {
-        memset(*buf, 0, size);
+        *buf = scratch.get_zeros(size);
+      } else {
+        *buf = scratch.get_shard(i, size);
       }
     }
   }
@@ -241,14 +283,7 @@ int ErasureCodeJerasure::decode_chunks(const shard_id_set &want_to_read,
   erasures[erasures_count] = -1;
   ceph_assert(erasures_count > 0);
 
-  int r = jerasure_decode(erasures, data, coding, size);
-  for (auto & shard : to_free) {
-    int i = static_cast<int>(shard);
-    char **buf = i < k ? &data[i] : &coding[i - k];
-    free(*buf);
-    *buf = nullptr;
-  }
-  return r;
+  return jerasure_decode(erasures, data, coding, size);
 }
 
 void ErasureCodeJerasure::encode_delta(const bufferptr &old_data,
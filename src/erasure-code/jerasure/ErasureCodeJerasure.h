@@ -91,6 +91,14 @@ public:
                     shard_id_map<bufferptr> &in,
                     shard_id_map<bufferptr> &out) override;
 
+  int encode_chunks_batch(
+    const std::vector<shard_id_map<bufferptr>> &in,
+    std::vector<shard_id_map<bufferptr>> &out) override;
+  int decode_chunks_batch(
+    const shard_id_set &want_to_read,
+    std::vector<shard_id_map<bufferptr>> &in,
+    std::vector<shard_id_map<bufferptr>> &out) override;
+
   void encode_delta(const ceph::bufferptr &old_data,
                     const ceph::bufferptr &new_data,
                     ceph::bufferptr *delta_maybe_in_place);
@@ -124,6 +132,15 @@ public:
 
 protected:
   virtual int parse(ceph::ErasureCodeProfile &profile, std::ostream *ss);
+
+private:
+  int _encode_chunks(const shard_id_map<bufferptr> &in,
+                     shard_id_map<bufferptr> &out,
+                     ChunkScratch &scratch);
+  int _decode_chunks(const shard_id_set &want_to_read,
+                     shard_id_map<bufferptr> &in,
+                     shard_id_map<bufferptr> &out,
+                     ChunkScratch &scratch);
 };
 class ErasureCodeJerasureReedSolomonVandermonde : public ErasureCodeJerasure {
 public:
@@ -0,0 +1,383 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:nil -*-
+// vim: ts=8 sw=2 sts=2 expandtab
+
+/*
+ * Ceph distributed storage system
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ */
+
+#include "gf8_region.h"
+
+#include <atomic>
+#include <cerrno>
+
+#include "arch/probe.h"
+#if defined(__x86_64__)
+#include <immintrin.h>
+#include "arch/intel.h"
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#include "arch/arm.h"
+#endif
+
+namespace ceph::gf8 {
+
+namespace {
+
+constexpr unsigned PRIM_POLY = 0x11d;
+
+uint8_t slow_multiply(uint8_t a, uint8_t b)
+{
+  unsigned p = 0;
+  unsigned x = a;
+  for (; b; b >>= 1) {
+    if (b & 1) {
+      p ^= x;
+    }
+    x <<= 1;
+    if (x & 0x100) {
+      x ^= PRIM_POLY;
+    }
+  }
+  return p;
+}
+
+/*
+ * Per multiplier tables: the full product row for the scalar kernel, the
+ * products of the low and high nibbles for the shuffle based kernels and
+ * the 8x8 bit matrix of the multiplication for GFNI.
+ */
+struct tables_t {
+  uint8_t mul[256][256];
+  alignas(16) uint8_t lo[256][16];
+  alignas(16) uint8_t hi[256][16];
+  uint64_t affine[256];
+
+  tables_t() {
+    for (unsigned c = 0; c < 256; c++) {
+      for (unsigned x = 0; x < 256; x++) {
+        mul[c][x] = slow_multiply(c, x);
+      }
+      for (unsigned x = 0; x < 16; x++) {
+        lo[c][x] = mul[c][x];
+        hi[c][x] = mul[c][x << 4];
+      }
+      // Bit i of the product is the parity of byte 7 - i of the matrix
+      // and'ed with the input, so that byte holds bit i of c * 2^j in
+      // its bit j.
+      uint64_t m = 0;
+      for (unsigned i = 0; i < 8; i++) {
+        uint64_t row = 0;
+        for (unsigned j = 0; j < 8; j++) {
+          row |= uint64_t((mul[c][1u << j] >> i) & 1) << j;
+        }
+        m |= row << (8 * (7 - i));
+      }
+      affine[c] = m;
+    }
+  }
+};
+
+const tables_t &tables()
+{
+  static const tables_t t;
+  return t;
+}
+
+void region_scalar(const uint8_t *src, uint8_t *dst, size_t len,
+                   uint8_t c, bool add)
+{
+  const uint8_t *row = tables().mul[c];
+  if (add) {
+    for (size_t i = 0; i < len; i++) {
+      dst[i] ^= row[src[i]];
+    }
+  } else {
+    for (size_t i = 0; i < len; i++) {
+      dst[i] = row[src[i]];
+    }
+  }
+}
+
+// The vector kernels return how many bytes they did, the scalar kernel
+// does the tail.
+
+#if defined(__x86_64__)
+
+__attribute__((target("ssse3")))
+size_t region_ssse3(const uint8_t *src, uint8_t *dst, size_t len,
+                    uint8_t c, bool add)
+{
+  const __m128i tlo = _mm_load_si128((const __m128i *)tables().lo[c]);
+  const __m128i thi = _mm_load_si128((const __m128i *)tables().hi[c]);
+  const __m128i mask = _mm_set1_epi8(0x0f);
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    __m128i x = _mm_loadu_si128((const __m128i *)(src + i));
+    __m128i l = _mm_and_si128(x, mask);
+    __m128i h = _mm_and_si128(_mm_srli_epi64(x, 4), mask);
+    __m128i p = _mm_xor_si128(_mm_shuffle_epi8(tlo, l),
+                              _mm_shuffle_epi8(thi, h));
+    if (add) {
+      p = _mm_xor_si128(p, _mm_loadu_si128((const __m128i *)(dst + i)));
+    }
+    _mm_storeu_si128((__m128i *)(dst + i), p);
+  }
+  return i;
+}
+
+__attribute__((target("avx2")))
+size_t region_avx2(const uint8_t *src, uint8_t *dst, size_t len,
+                   uint8_t c, bool add)
+{
+  const __m256i tlo = _mm256_broadcastsi128_si256(
+    _mm_load_si128((const __m128i *)tables().lo[c]));
+  const __m256i thi = _mm256_broadcastsi128_si256(
+    _mm_load_si128((const __m128i *)tables().hi[c]));
+  const __m256i mask = _mm256_set1_epi8(0x0f);
+  size_t i = 0;
+  for (; i + 32 <= len; i += 32) {
+    __m256i x = _mm256_loadu_si256((const __m256i *)(src + i));
+    __m256i l = _mm256_and_si256(x, mask);
+    __m256i h = _mm256_and_si256(_mm256_srli_epi64(x, 4), mask);
+    __m256i p = _mm256_xor_si256(_mm256_shuffle_epi8(tlo, l),
+                                 _mm256_shuffle_epi8(thi, h));
+    if (add) {
+      p = _mm256_xor_si256(p, _mm256_loadu_si256((const __m256i *)(dst + i)));
+    }
+    _mm256_storeu_si256((__m256i *)(dst + i), p);
+  }
+  return i;
+}
+
+__attribute__((target("avx512f,avx512bw")))
+size_t region_avx512(const uint8_t *src, uint8_t *dst, size_t len,
+                     uint8_t c, bool add)
+{
+  // zero masked broadcast and shift: the plain ones start from an undefined
+  // register, which GCC reports as used uninitialized
+  const __m512i tlo = _mm512_maskz_broadcast_i32x4(
+    0xffff, _mm_load_si128((const __m128i *)tables().lo[c]));
+  const __m512i thi = _mm512_maskz_broadcast_i32x4(
+    0xffff, _mm_load_si128((const __m128i *)tables().hi[c]));
+  const __m512i mask = _mm512_set1_epi8(0x0f);
+  size_t i = 0;
+  for (; i + 64 <= len; i += 64) {
+    __m512i x = _mm512_loadu_si512((const void *)(src + i));
+    __m512i l = _mm512_and_si512(x, mask);
+    __m512i h = _mm512_and_si512(_mm512_maskz_srli_epi64(0xff, x, 4), mask);
+    __m512i p = _mm512_xor_si512(_mm512_shuffle_epi8(tlo, l),
+                                 _mm512_shuffle_epi8(thi, h));
+    if (add) {
+      p = _mm512_xor_si512(p, _mm512_loadu_si512((const void *)(dst + i)));
+    }
+    _mm512_storeu_si512((void *)(dst + i), p);
+  }
+  return i;
+}
+
+__attribute__((target("gfni,avx512f,avx512bw")))
+size_t region_gfni(const uint8_t *src, uint8_t *dst, size_t len,
+                   uint8_t c, bool add)
+{
+  const __m512i matrix = _mm512_set1_epi64(tables().affine[c]);
+  size_t i = 0;
+  for (; i + 64 <= len; i += 64) {
+    __m512i x = _mm512_loadu_si512((const void *)(src + i));
+    __m512i p = _mm512_gf2p8affine_epi64_epi8(x, matrix, 0);
+    if (add) {
+      p = _mm512_xor_si512(p, _mm512_loadu_si512((const void *)(dst + i)));
+    }
+    _mm512_storeu_si512((void *)(dst + i), p);
+  }
+  return i;
+}
+
+#elif defined(__aarch64__)
+
+size_t region_neon(const uint8_t *src, uint8_t *dst, size_t len,
+                   uint8_t c, bool add)
+{
+  const uint8x16_t tlo = vld1q_u8(tables().lo[c]);
+  const uint8x16_t thi = vld1q_u8(tables().hi[c]);
+  const uint8x16_t mask = vdupq_n_u8(0x0f);
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    uint8x16_t x = vld1q_u8(src + i);
+    uint8x16_t p = veorq_u8(vqtbl1q_u8(tlo, vandq_u8(x, mask)),
+                            vqtbl1q_u8(thi, vshrq_n_u8(x, 4)));
+    if (add) {
+      p = veorq_u8(p, vld1q_u8(dst + i));
+    }
+    vst1q_u8(dst + i, p);
+  }
+  return i;
+}
+
+#endif
+
+constexpr kernel_t all_kernels[] = {
+  kernel_t::SCALAR,
+  kernel_t::SSSE3,
+  kernel_t::AVX2,
+  kernel_t::AVX512,
+  kernel_t::GFNI,
+  kernel_t::NEON,
+};
+
+std::atomic<kernel_t> &active_kernel()
+{
+  static std::atomic<kernel_t> kernel{best_kernel()};
+  return kernel;
+}
+
+} // anonymous namespace
+
+const char *kernel_name(kernel_t kernel)
+{
+  switch (kernel) {
+  case kernel_t::SCALAR:
+    return "scalar";
+  case kernel_t::SSSE3:
+    return "ssse3";
+  case kernel_t::AVX2:
+    return "avx2";
+  case kernel_t::AVX512:
+    return "avx512";
+  case kernel_t::GFNI:
+    return "gfni";
+  case kernel_t::NEON:
+    return "neon";
+  }
+  return "unknown";
+}
+
+std::optional<kernel_t> kernel_from_name(std::string_view name)
+{
+  for (auto kernel : all_kernels) {
+    if (name == kernel_name(kernel)) {
+      return kernel;
+    }
+  }
+  return std::nullopt;
+}
+
+bool kernel_supported(kernel_t kernel)
+{
+  ceph_arch_probe();
+  switch (kernel) {
+  case kernel_t::SCALAR:
+    return true;
+#if defined(__x86_64__)
+  case kernel_t::SSSE3:
+    return ceph_arch_intel_ssse3;
+  case kernel_t::AVX2:
+    return ceph_arch_intel_avx2;
+  case kernel_t::AVX512:
+    return ceph_arch_intel_avx512bw;
+  case kernel_t::GFNI:
+    return ceph_arch_intel_avx512bw && ceph_arch_intel_gfni;
+#elif defined(__aarch64__)
+  case kernel_t::NEON:
+    return ceph_arch_neon;
+#endif
+  default:
+    return false;
+  }
+}
+
+std::vector<kernel_t> supported_kernels()
+{
+  std::vector<kernel_t> kernels;
+  for (auto kernel : all_kernels) {
+    if (kernel_supported(kernel)) {
+      kernels.push_back(kernel);
+    }
+  }
+  return kernels;
+}
+
+kernel_t best_kernel()
+{
+  return supported_kernels().back();
+}
+
+kernel_t get_kernel()
+{
+  return active_kernel().load(std::memory_order_relaxed);
+}
+
+int set_kernel(kernel_t kernel)
+{
+  if (!kernel_supported(kernel)) {
+    return -EOPNOTSUPP;
+  }
+  active_kernel().store(kernel, std::memory_order_relaxed);
+  return 0;
+}
+
+int set_kernel(std::string_view name, std::ostream *ss)
+{
+  if (name == "auto") {
+    return set_kernel(best_kernel());
+  }
+  auto kernel = kernel_from_name(name);
+  if (kernel && set_kernel(*kernel) == 0) {
+    return 0;
+  }
+  if (ss) {
+    *ss << "erasure_code_gf_kernel=" << name << " must be auto or one of";
+    for (auto k : supported_kernels()) {
+      *ss << " " << kernel_name(k);
+    }
+    *ss << std::endl;
+  }
+  return -EINVAL;
+}
+
+uint8_t multiply(uint8_t a, uint8_t b)
+{
+  return tables().mul[a][b];
+}
+
+void region_multiply(const uint8_t *src, uint8_t *dst, size_t len,
+                     uint8_t c, bool add)
+{
+  region_multiply(get_kernel(), src, dst, len, c, add);
+}
+
+void region_multiply(kernel_t kernel, const uint8_t *src, uint8_t *dst,
+                     size_t len, uint8_t c, bool add)
+{
+  size_t done = 0;
+  switch (kernel) {
+#if defined(__x86_64__)
+  case kernel_t::SSSE3:
+    done = region_ssse3(src, dst, len, c, add);
+    break;
+  case kernel_t::AVX2:
+    done = region_avx2(src, dst, len, c, add);
+    break;
+  case kernel_t::AVX512:
+    done = region_avx512(src, dst, len, c, add);
+    break;
+  case kernel_t::GFNI:
+    done = region_gfni(src, dst, len, c, add);
+    break;
+#elif defined(__aarch64__)
+  case kernel_t::NEON:
+    done = region_neon(src, dst, len, c, add);
+    break;
+#endif
+  default:
+    break;
+  }
+  region_scalar(src + done, dst + done, len - done, c, add);
+}
+
+} // namespace ceph::gf8
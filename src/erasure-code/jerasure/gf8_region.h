@@ -0,0 +1,70 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:nil -*-
+// vim: ts=8 sw=2 sts=2 expandtab
+
+/*
+ * Ceph distributed storage system
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ */
+
+#ifndef CEPH_GF8_REGION_H
+#define CEPH_GF8_REGION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+/*
+ * Region multiply in GF(2^8) with the 0x11d polynomial, which is the w=8
+ * field of jerasure and shec (and of clay through them).  Every kernel
+ * computes the same result, the fastest one the CPU supports is picked at
+ * runtime and can be overridden with the erasure_code_gf_kernel option.
+ */
+namespace ceph::gf8 {
+
+enum class kernel_t {
+  SCALAR,
+  SSSE3,
+  AVX2,
+  AVX512,  // AVX-512 F and BW, nibble table lookups
+  GFNI,    // GFNI affine transform on AVX-512 registers
+  NEON,
+};
+
+const char *kernel_name(kernel_t kernel);
+std::optional<kernel_t> kernel_from_name(std::string_view name);
+bool kernel_supported(kernel_t kernel);
+/// the kernels this CPU supports, fastest last
+std::vector<kernel_t> supported_kernels();
+kernel_t best_kernel();
+
+/// the kernel used by region_multiply() without an explicit kernel
+kernel_t get_kernel();
+/// @return -EOPNOTSUPP if the CPU does not support kernel
+int set_kernel(kernel_t kernel);
+/**
+ * set the kernel named by erasure_code_gf_kernel. "auto" selects
+ * best_kernel().  The kernel is process wide.
+ *
+ * @return -EINVAL if name is not a kernel this CPU supports
+ */
+int set_kernel(std::string_view name, std::ostream *ss);
+
+uint8_t multiply(uint8_t a, uint8_t b);
+
+/// dst = c * src, or dst ^= c * src if add
+void region_multiply(const uint8_t *src, uint8_t *dst, size_t len,
+                     uint8_t c, bool add);
+void region_multiply(kernel_t kernel, const uint8_t *src, uint8_t *dst,
+                     size_t len, uint8_t c, bool add);
+
+} // namespace ceph::gf8
+
+#endif
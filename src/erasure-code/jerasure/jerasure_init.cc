@@ -16,14 +16,58 @@
  * 
  */
 
+#include <sstream>
+
+#include "common/config.h"
 #include "common/debug.h"
+#include "global/global_context.h"
 #include "jerasure_init.h"
+#include "gf8_region.h"
 
 extern "C" {
 #include "galois.h"
 }
 
 #define dout_context g_ceph_context
+#define dout_subsys ceph_subsys_osd
+
+static void gf8_multiply_region(gf_t *gf, void *src, void *dest,
+				gf_val_32_t val, int bytes, int add)
+{
+  ceph::gf8::region_multiply(static_cast<const uint8_t*>(src),
+			     static_cast<uint8_t*>(dest),
+			     bytes, val, add);
+}
+
+// Have the w=8 field use the ceph::gf8 region kernels, unless it is not
+// the field they implement.  The kernel is chosen once, by the first
+// plugin loaded, from erasure_code_gf_kernel.
+static void gf8_install(gf_t *gf)
+{
+  if (gf->multiply_region.w32 == gf8_multiply_region) {
+    return;
+  }
+  static const unsigned samples[] = {2, 0x53, 0x80, 0xca, 0xff};
+  for (auto a : samples) {
+    for (auto b : samples) {
+      if (gf->multiply.w32(gf, a, b) != ceph::gf8::multiply(a, b)) {
+	derr << "w=8 field does not use the 0x11d polynomial, keeping the"
+	     << " gf-complete region multiply" << dendl;
+	return;
+      }
+    }
+  }
+  std::ostringstream ss;
+  if (ceph::gf8::set_kernel(
+	g_conf().get_val<std::string>("erasure_code_gf_kernel"), &ss)) {
+    derr << ss.str() << dendl;
+    ceph::gf8::set_kernel(ceph::gf8::best_kernel());
+  }
+  gf->multiply_region.w32 = gf8_multiply_region;
+  dout(10) << "w=8 region multiply uses the "
+	   << ceph::gf8::kernel_name(ceph::gf8::get_kernel())
+	   << " kernel" << dendl;
+}
 
 extern "C" int jerasure_init(int count, int *words)
 {
@@ -33,6 +77,9 @@ extern "C" int jerasure_init(int count, int *words)
       derr << "failed to galois_init_default_field(" << words[i] << ")" << dendl;
       return -r;
     }
+    if (words[i] == 8) {
+      gf8_install(galois_get_field_ptr(8));
+    }
   }
   return 0;
 }
@@ -1231,6 +1231,9 @@ struct error_code;
 
     uint32_t crc32c(uint32_t crc) const;
     void invalidate_crc();
+    /// record crc32c(base) of a single-buffer list, computed elsewhere, so
+    /// that a later crc32c() can skip hashing the data; no-op otherwise
+    void set_crc32c(uint32_t base, uint32_t crc) const;
 
     // These functions return a bufferlist with a pointer to a single
     // static buffer. They /must/ not outlive the memory they
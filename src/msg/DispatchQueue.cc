@@ -32,11 +32,13 @@ using ceph::ref_t;
 #define dout_prefix *_dout << "-- " << msgr->get_myaddrs() << " "
 
 double DispatchQueue::get_max_age(utime_t now) const {
-  std::lock_guard l{lock};
-  if (marrival.empty())
-    return 0;
-  else
-    return (now - *marrival.begin());
+  double max_age = 0;
+  for (auto &shard : shards) {
+    std::lock_guard l{shard->lock};
+    if (!shard->marrival.empty())
+      max_age = std::max<double>(max_age, now - *shard->marrival.begin());
+  }
+  return max_age;
 }
 
 uint64_t DispatchQueue::pre_dispatch(const ref_t<Message>& m)
@@ -83,19 +85,20 @@ void DispatchQueue::fast_preprocess(const ref_t<Message>& m)
 
 void DispatchQueue::enqueue(const ref_t<Message>& m, int priority, uint64_t id)
 {
-  std::lock_guard l{lock};
+  Shard &shard = get_shard(m->get_connection().get());
+  std::lock_guard l{shard.lock};
   if (stop) {
     return;
   }
   ldout(cct,20) << "queue " << m << " prio " << priority << dendl;
   QueueItem item{m};
-  add_arrival(item);
+  shard.add_arrival(item);
   if (priority >= CEPH_MSG_PRIO_LOW) {
-    mqueue.enqueue_strict(id, priority, std::move(item));
+    shard.mqueue.enqueue_strict(id, priority, std::move(item));
   } else {
-    mqueue.enqueue(id, priority, m->get_cost(), std::move(item));
+    shard.mqueue.enqueue(id, priority, m->get_cost(), std::move(item));
   }
-  cond.notify_one();
+  shard.cond.notify_one();
 }
 
 void DispatchQueue::local_delivery(const ref_t<Message>& m, int priority)
@@ -155,14 +158,14 @@ void DispatchQueue::dispatch_throttle_release(uint64_t msize)
  * end of the queue. If the queue is empty; it's removed.
  * The message is then delivered and the process starts again.
  */
-void DispatchQueue::entry()
+void DispatchQueue::entry(Shard &shard)
 {
-  std::unique_lock l{lock};
+  std::unique_lock l{shard.lock};
   while (true) {
-    while (!mqueue.empty()) {
-      QueueItem qitem = mqueue.dequeue();
+    while (!shard.mqueue.empty()) {
+      QueueItem qitem = shard.mqueue.dequeue();
       if (!qitem.is_code())
-	remove_arrival(qitem);
+	shard.remove_arrival(qitem);
       l.unlock();
 
       if (qitem.is_code()) {
@@ -211,34 +214,52 @@ void DispatchQueue::entry()
       break;
 
     // wait for something to be put on queue
-    cond.wait(l);
+    shard.cond.wait(l);
   }
 }
 
 void DispatchQueue::discard_queue(uint64_t id) {
-  std::lock_guard l{lock};
-  std::list<QueueItem> removed;
-  mqueue.remove_by_class(id, &removed);
-  for (auto i = removed.begin(); i != removed.end(); ++i) {
-    ceph_assert(!(i->is_code())); // We don't discard id 0, ever!
-    const ref_t<Message>& m = i->get_message();
-    remove_arrival(*i);
-    dispatch_throttle_release(m->get_dispatch_throttle_size());
+  // the connection is gone, so look for its messages in every shard
+  for (auto &shard : shards) {
+    std::lock_guard l{shard->lock};
+    std::list<QueueItem> removed;
+    shard->mqueue.remove_by_class(id, &removed);
+    for (auto i = removed.begin(); i != removed.end(); ++i) {
+      ceph_assert(!(i->is_code())); // We don't discard id 0, ever!
+      const ref_t<Message>& m = i->get_message();
+      shard->remove_arrival(*i);
+      dispatch_throttle_release(m->get_dispatch_throttle_size());
+    }
+  }
+}
+
+void DispatchQueue::set_num_shards(unsigned n)
+{
+  ceph_assert(n > 0);
+  ceph_assert(!is_started());
+  shards.clear();
+  for (unsigned i = 0; i < n; i++) {
+    shards.emplace_back(std::make_unique<Shard>(this, name));
   }
 }
 
 void DispatchQueue::start()
 {
   ceph_assert(!stop);
-  ceph_assert(!dispatch_thread.is_started());
-  dispatch_thread.create("ms_dispatch");
+  ceph_assert(!is_started());
+  for (size_t i = 0; i < shards.size(); i++) {
+    shards[i]->dispatch_thread.create(
+      i ? ("ms_dispatch_" + std::to_string(i)).c_str() : "ms_dispatch");
+  }
   local_delivery_thread.create("ms_local");
 }
 
 void DispatchQueue::wait()
 {
   local_delivery_thread.join();
-  dispatch_thread.join();
+  for (auto &shard : shards) {
+    shard->dispatch_thread.join();
+  }
 }
 
 void DispatchQueue::discard_local()
@@ -254,10 +275,10 @@ void DispatchQueue::shutdown()
     stop_local_delivery = true;
     local_delivery_cond.notify_all();
   }
-  // stop my dispatch thread
-  {
-    std::scoped_lock l{lock};
-    stop = true;
-    cond.notify_all();
+  // stop my dispatch threads
+  stop = true;
+  for (auto &shard : shards) {
+    std::scoped_lock l{shard->lock};
+    shard->cond.notify_all();
   }
 }
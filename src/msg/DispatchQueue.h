@@ -17,11 +17,14 @@
 #define CEPH_DISPATCHQUEUE_H
 
 #include <atomic>
+#include <memory>
 #include <set>
 #include <queue>
+#include <vector>
 #include <boost/intrusive_ptr.hpp>
 #include "include/ceph_assert.h"
 #include "include/common_fwd.h"
+#include "include/hash.h"
 #include "common/Throttle.h"
 #include "common/ceph_mutex.h"
 #include "common/Thread.h"
@@ -37,10 +40,14 @@ struct Connection;
  * they want to be dispatched, carefully organized by Message priority
  * and permitted to deliver in a round-robin fashion.
  * See Messenger::dispatch_entry for details.
+ *
+ * With set_num_shards(n > 1) the connections are spread over as many
+ * shards, each with its own queue and dispatch thread. The messages and
+ * events of a connection always go to the same shard and are delivered
+ * in order, those of different connections may be delivered concurrently.
  */
 class DispatchQueue {
   using ArrivalSet = std::multiset<double>;
-  ArrivalSet marrival;
 
   class QueueItem {
     int type;
@@ -75,35 +82,67 @@ class DispatchQueue {
 
   CephContext *cct;
   Messenger *msgr;
-  mutable ceph::mutex lock;
-  ceph::condition_variable cond;
+  const std::string name;
+
+  struct Shard {
+    mutable ceph::mutex lock;
+    ceph::condition_variable cond;
 
-  PrioritizedQueue<QueueItem, uint64_t> mqueue;
+    PrioritizedQueue<QueueItem, uint64_t> mqueue;
+    ArrivalSet marrival;
 
-  void add_arrival(QueueItem &item) {
-    item.arrival = marrival.insert(item.get_message()->get_recv_stamp());
+    void add_arrival(QueueItem &item) {
+      item.arrival = marrival.insert(item.get_message()->get_recv_stamp());
+    }
+    void remove_arrival(QueueItem &item) {
+      marrival.erase(item.arrival);
+    }
+
+    /**
+     * The DispatchThread runs dispatch_entry to empty out the shard.
+     */
+    class DispatchThread : public Thread {
+      DispatchQueue *dq;
+      Shard *shard;
+    public:
+      DispatchThread(DispatchQueue *dq, Shard *shard) : dq(dq), shard(shard) {}
+      void *entry() override {
+        dq->entry(*shard);
+        return 0;
+      }
+    } dispatch_thread;
+
+    Shard(DispatchQueue *dq, const std::string &name)
+      : lock(ceph::make_mutex("Messenger::DispatchQueue::lock" + name)),
+        mqueue(dq->cct->_conf->ms_pq_max_tokens_per_priority,
+               dq->cct->_conf->ms_pq_min_cost),
+        dispatch_thread(dq, this) {}
+    ~Shard() {
+      ceph_assert(mqueue.empty());
+      ceph_assert(marrival.empty());
+    }
+  };
+  std::vector<std::unique_ptr<Shard>> shards;
+
+  Shard &get_shard(const Connection *con) {
+    return *shards[get_shard_index(con)];
   }
-  void remove_arrival(QueueItem &item) {
-    marrival.erase(item.arrival);
+  void queue_code(int code, Connection *con) {
+    Shard &shard = get_shard(con);
+    std::lock_guard l{shard.lock};
+    if (stop)
+      return;
+    shard.mqueue.enqueue_strict(
+      0,
+      CEPH_MSG_PRIO_HIGHEST,
+      QueueItem(code, con));
+    shard.cond.notify_all();
   }
 
   std::atomic<uint64_t> next_id;
 
   enum { D_CONNECT = 1, D_ACCEPT, D_BAD_REMOTE_RESET, D_BAD_RESET, D_CONN_REFUSED, D_NUM_CODES };
 
-  /**
-   * The DispatchThread runs dispatch_entry to empty out the dispatch_queue.
-   */
-  class DispatchThread : public Thread {
-    DispatchQueue *dq;
-  public:
-    explicit DispatchThread(DispatchQueue *dq) : dq(dq) {}
-    void *entry() override {
-      dq->entry();
-      return 0;
-    }
-  } dispatch_thread;
-
   ceph::mutex local_delivery_lock;
   ceph::condition_variable local_delivery_cond;
   bool stop_local_delivery;
@@ -126,7 +165,7 @@ class DispatchQueue {
   /// Throttle preventing us from building up a big backlog waiting for dispatch
   Throttle dispatch_throttler;
 
-  bool stop;
+  std::atomic<bool> stop;
   void local_delivery(const ceph::ref_t<Message>& m, int priority);
   void local_delivery(Message* m, int priority) {
     return local_delivery(ceph::ref_t<Message>(m, false), priority); /* consume ref */
@@ -136,8 +175,12 @@ class DispatchQueue {
   double get_max_age(utime_t now) const;
 
   int get_queue_len() const {
-    std::lock_guard l{lock};
-    return mqueue.length();
+    int len = 0;
+    for (auto &shard : shards) {
+      std::lock_guard l{shard->lock};
+      len += shard->mqueue.length();
+    }
+    return len;
   }
 
   /**
@@ -148,54 +191,19 @@ class DispatchQueue {
   void dispatch_throttle_release(uint64_t msize);
 
   void queue_connect(Connection *con) {
-    std::lock_guard l{lock};
-    if (stop)
-      return;
-    mqueue.enqueue_strict(
-      0,
-      CEPH_MSG_PRIO_HIGHEST,
-      QueueItem(D_CONNECT, con));
-    cond.notify_all();
+    queue_code(D_CONNECT, con);
   }
   void queue_accept(Connection *con) {
-    std::lock_guard l{lock};
-    if (stop)
-      return;
-    mqueue.enqueue_strict(
-      0,
-      CEPH_MSG_PRIO_HIGHEST,
-      QueueItem(D_ACCEPT, con));
-    cond.notify_all();
+    queue_code(D_ACCEPT, con);
   }
   void queue_remote_reset(Connection *con) {
-    std::lock_guard l{lock};
-    if (stop)
-      return;
-    mqueue.enqueue_strict(
-      0,
-      CEPH_MSG_PRIO_HIGHEST,
-      QueueItem(D_BAD_REMOTE_RESET, con));
-    cond.notify_all();
+    queue_code(D_BAD_REMOTE_RESET, con);
   }
   void queue_reset(Connection *con) {
-    std::lock_guard l{lock};
-    if (stop)
-      return;
-    mqueue.enqueue_strict(
-      0,
-      CEPH_MSG_PRIO_HIGHEST,
-      QueueItem(D_BAD_RESET, con));
-    cond.notify_all();
+    queue_code(D_BAD_RESET, con);
   }
   void queue_refused(Connection *con) {
-    std::lock_guard l{lock};
-    if (stop)
-      return;
-    mqueue.enqueue_strict(
-      0,
-      CEPH_MSG_PRIO_HIGHEST,
-      QueueItem(D_CONN_REFUSED, con));
-    cond.notify_all();
+    queue_code(D_CONN_REFUSED, con);
   }
 
   bool can_fast_dispatch(const ceph::cref_t<Message> &m) const;
@@ -214,28 +222,34 @@ class DispatchQueue {
     return next_id++;
   }
   void start();
-  void entry();
+  void entry(Shard &shard);
   void wait();
   void shutdown();
-  bool is_started() const {return dispatch_thread.is_started();}
+  bool is_started() const {return shards.front()->dispatch_thread.is_started();}
+
+  /// split the queue into n shards, each with a dispatch thread of its own
+  void set_num_shards(unsigned n);
+  /// the shard the messages and events of a connection are delivered by
+  unsigned get_shard_index(const Connection *con) const {
+    if (shards.size() == 1) {
+      return 0;
+    }
+    return rjhash64(reinterpret_cast<uintptr_t>(con)) % shards.size();
+  }
 
   DispatchQueue(CephContext *cct, Messenger *msgr, std::string &name)
-    : cct(cct), msgr(msgr),
-      lock(ceph::make_mutex("Messenger::DispatchQueue::lock" + name)),
-      mqueue(cct->_conf->ms_pq_max_tokens_per_priority,
-	     cct->_conf->ms_pq_min_cost),
+    : cct(cct), msgr(msgr), name(name),
       next_id(1),
-      dispatch_thread(this),
       local_delivery_lock(ceph::make_mutex("Messenger::DispatchQueue::local_delivery_lock" + name)),
       stop_local_delivery(false),
       local_delivery_thread(this),
       dispatch_throttler(cct, std::string("msgr_dispatch_throttler-") + name,
                          cct->_conf->ms_dispatch_throttle_bytes),
       stop(false)
-    {}
+  {
+    shards.emplace_back(std::make_unique<Shard>(this, name));
+  }
   ~DispatchQueue() {
-    ceph_assert(mqueue.empty());
-    ceph_assert(marrival.empty());
     ceph_assert(local_messages.empty());
   }
 };
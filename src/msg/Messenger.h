@@ -40,6 +40,7 @@
 #include "auth/AuthRegistry.h"
 #include "compressor_registry.h"
 #include "include/ceph_assert.h"
+#include "include/spinlock.h"
 
 #include <errno.h>
 #include <sstream>
@@ -104,9 +105,27 @@ private:
       return priority < other.priority;
     }
   };
-  std::vector<PriorityDispatcher> dispatchers;
+  // replaced as a whole when a Dispatcher is added, so that the threads
+  // delivering messages can go through them while another one adds one
+  std::shared_ptr<const std::vector<PriorityDispatcher>> dispatchers =
+    std::make_shared<const std::vector<PriorityDispatcher>>();
+  mutable ceph::spinlock dispatchers_lock;
   std::vector<PriorityDispatcher> fast_dispatchers;
 
+  std::shared_ptr<const std::vector<PriorityDispatcher>> get_dispatchers() const {
+    std::lock_guard l{dispatchers_lock};
+    return dispatchers;
+  }
+  template <typename Insert>
+  bool add_dispatcher(Insert&& insert, PriorityDispatcher d) {
+    std::lock_guard l{dispatchers_lock};
+    bool first = dispatchers->empty();
+    auto v = std::make_shared<std::vector<PriorityDispatcher>>(*dispatchers);
+    insert(*v, d);
+    dispatchers = std::move(v);
+    return first;
+  }
+
   ZTracer::Endpoint trace_endpoint;
 
   static void insert_head(std::vector<PriorityDispatcher>& v,
@@ -385,6 +404,16 @@ public:
     ceph_assert(!started);
     default_send_priority = p;
   }
+  /**
+   * Set the number of threads delivering the messages that are not fast
+   * dispatched. The messages and events of a connection are still delivered
+   * in order, but those of different connections may be delivered
+   * concurrently, so the Dispatchers must be safe to call from several
+   * threads. This function must be called before start().
+   *
+   * @param n The number of dispatch threads, at least 1.
+   */
+  virtual void set_dispatch_threads(unsigned n) = 0;
   /**
    * set the priority(SO_PRIORITY) for all packets to be sent on this socket.
    *
@@ -414,9 +443,8 @@ public:
    * @param d The Dispatcher to insert into the list.
    */
   void add_dispatcher_head(Dispatcher *d, PriorityDispatcher::priority_t priority=Dispatcher::PRIORITY_DEFAULT) {
-    bool first = dispatchers.empty();
     const PriorityDispatcher entry{priority, d};
-    insert_head(dispatchers, entry);
+    bool first = add_dispatcher(insert_head, entry);
     if (d->ms_can_fast_dispatch_any()) {
       insert_head(fast_dispatchers, entry);
     }
@@ -431,9 +459,8 @@ public:
    * @param d The Dispatcher to insert into the list.
    */
   void add_dispatcher_tail(Dispatcher *d, PriorityDispatcher::priority_t priority=Dispatcher::PRIORITY_DEFAULT) {
-    bool first = dispatchers.empty();
     const PriorityDispatcher entry{priority, d};
-    insert_tail(dispatchers, entry);
+    bool first = add_dispatcher(insert_tail, entry);
     if (d->ms_can_fast_dispatch_any()) {
       insert_tail(fast_dispatchers, entry);
     }
@@ -744,7 +771,8 @@ public:
   void ms_deliver_dispatch(const ceph::ref_t<Message> &m) {
     m->set_dispatch_stamp(ceph_clock_now());
     bool acked = false;
-    for ([[maybe_unused]] const auto& [priority, dispatcher] : dispatchers) {
+    auto ds = get_dispatchers();
+    for ([[maybe_unused]] const auto& [priority, dispatcher] : *ds) {
       auto r = Dispatcher::fold_dispatch_result(dispatcher->ms_dispatch2(m));
       if (std::holds_alternative<Dispatcher::HANDLED>(r)) {
         return;
@@ -769,7 +797,8 @@ public:
    * @param con Pointer to the new Connection.
    */
   void ms_deliver_handle_connect(Connection *con) {
-    for ([[maybe_unused]] const auto& [priority, dispatcher] : dispatchers) {
+    auto ds = get_dispatchers();
+    for ([[maybe_unused]] const auto& [priority, dispatcher] : *ds) {
       dispatcher->ms_handle_connect(con);
     }
   }
@@ -794,7 +823,8 @@ public:
    * @param con Pointer to the new Connection.
    */
   void ms_deliver_handle_accept(Connection *con) {
-    for ([[maybe_unused]] const auto& [priority, dispatcher] : dispatchers) {
+    auto ds = get_dispatchers();
+    for ([[maybe_unused]] const auto& [priority, dispatcher] : *ds) {
       dispatcher->ms_handle_accept(con);
     }
   }
@@ -819,7 +849,8 @@ public:
    * @param con Pointer to the broken Connection.
    */
   void ms_deliver_handle_reset(Connection *con) {
-    for ([[maybe_unused]] const auto& [priority, dispatcher] : dispatchers) {
+    auto ds = get_dispatchers();
+    for ([[maybe_unused]] const auto& [priority, dispatcher] : *ds) {
       if (dispatcher->ms_handle_reset(con)) {
         return;
       }
@@ -833,7 +864,8 @@ public:
    * @param con Pointer to the broken Connection.
    */
   void ms_deliver_handle_remote_reset(Connection *con) {
-    for ([[maybe_unused]] const auto& [priority, dispatcher] : dispatchers) {
+    auto ds = get_dispatchers();
+    for ([[maybe_unused]] const auto& [priority, dispatcher] : *ds) {
       dispatcher->ms_handle_remote_reset(con);
     }
   }
@@ -847,7 +879,8 @@ public:
    * @param con Pointer to the broken Connection.
    */
   void ms_deliver_handle_refused(Connection *con) {
-    for ([[maybe_unused]] const auto& [priority, dispatcher] : dispatchers) {
+    auto ds = get_dispatchers();
+    for ([[maybe_unused]] const auto& [priority, dispatcher] : *ds) {
       if (dispatcher->ms_handle_refused(con)) {
         return;
       }
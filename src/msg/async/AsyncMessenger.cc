@@ -375,6 +375,10 @@ AsyncMessenger::AsyncMessenger(CephContext *cct, entity_name_t name,
     transport_type = "rdma";
   else if (type.find("dpdk") != std::string::npos)
     transport_type = "dpdk";
+  else if (type.find("io_uring") != std::string::npos)
+    transport_type = "io_uring";
+  else if (type.find("shm") != std::string::npos)
+    transport_type = "shm";
 
   auto single = &cct->lookup_or_create_singleton_object<StackSingleton>(
     "AsyncMessenger::NetworkStack::" + transport_type, true, cct);
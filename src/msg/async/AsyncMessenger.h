@@ -125,6 +125,9 @@ public:
   double get_dispatch_queue_max_age(utime_t now) const override {
     return dispatch_queue.get_max_age(now);
   }
+  unsigned get_dispatch_shard(const Connection *con) const {
+    return dispatch_queue.get_shard_index(con);
+  }
   /** @} Accessors */
 
   /**
@@ -136,6 +139,11 @@ public:
     cluster_protocol = p;
   }
 
+  void set_dispatch_threads(unsigned n) override {
+    ceph_assert(!started);
+    dispatch_queue.set_num_shards(n);
+  }
+
   int bind(const entity_addr_t& bind_addr,
 	   std::optional<entity_addrvec_t> public_addrs=std::nullopt) override;
   int rebind(const std::set<int>& avoid_ports) override;
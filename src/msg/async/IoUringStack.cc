@@ -0,0 +1,900 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:nil -*-
+// vim: ts=8 sw=2 sts=2 expandtab
+
+/*
+ * Ceph - scalable distributed file system
+ *
+ * This is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License version 2.1, as published by the Free Software
+ * Foundation.  See file COPYING.
+ *
+ */
+
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <poll.h>
+#include <errno.h>
+
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <deque>
+
+#include "IoUringStack.h"
+
+#include "include/buffer.h"
+#include "include/compat.h"
+#include "include/intarith.h"
+#include "include/page.h"
+#include "include/sock_compat.h"
+#include "common/errno.h"
+#include "common/dout.h"
+
+#define dout_subsys ceph_subsys_ms
+#undef dout_prefix
+#define dout_prefix *_dout << "IoUringStack "
+
+// what a completion is for, in the low bits of the user_data next to the
+// socket it belongs to; a user_data of 0 is a cancel request
+enum : uint64_t {
+  OP_RECV = 1,
+  OP_SEND = 2,
+  OP_POLL = 3,
+  OP_ACCEPT = 4,
+  OP_MASK = 7,
+};
+
+static uint64_t op_data(IoUringSocket *s, uint64_t op)
+{
+  return reinterpret_cast<uint64_t>(s) | op;
+}
+
+IoUringSocket::IoUringSocket(IoUringWorker *w, int sd)
+  : worker(w), sd(sd)
+{
+  notify_fd = eventfd(0, EFD_CLOEXEC|EFD_NONBLOCK);
+  ceph_assert(notify_fd >= 0);
+}
+
+IoUringSocket::~IoUringSocket()
+{
+  if (registered)
+    worker->remove_socket(this);
+  ::close(sd);
+  ::close(notify_fd);
+}
+
+void IoUringSocket::start()
+{
+  if (!registered) {
+    ceph_assert(worker->center.in_thread());
+    registered = true;
+    worker->add_socket(this);
+  }
+}
+
+void IoUringSocket::put()
+{
+  if (closed && !inflight)
+    delete this;
+}
+
+void IoUringSocket::notify()
+{
+  eventfd_write(notify_fd, 1);
+}
+
+void IoUringSocket::clear_notify()
+{
+  eventfd_t value;
+  eventfd_read(notify_fd, &value);
+}
+
+void IoUringSocket::complete(uint64_t op, int res, unsigned flags)
+{
+  ceph_assert(inflight > 0);
+  --inflight;
+  handle_cqe(op, res, flags);
+  put();
+}
+
+void IoUringSocket::close()
+{
+  if (registered && !worker->center.in_thread()) {
+    // the ring may only be used by the worker's thread
+    worker->center.submit_to(worker->center.get_id(), [this] { close(); },
+                             true);
+    return;
+  }
+  ceph_assert(!closed);
+  closed = true;
+  cancel();
+  put();
+}
+
+void IoUringSocket::ring_gone()
+{
+  inflight = 0;
+  put();
+}
+
+class IoUringConnection : public IoUringSocket {
+  entity_addr_t sa;
+  bool connected;
+  bool shut = false;
+  bool poll_armed = false;
+  bool recv_armed = false;
+  bool flush_queued = false;
+  bool send_inflight = false;
+  // send() turned data away, notify the owner when there is room again
+  bool tx_full = false;
+  // the first error of the socket, reported by the next read or send
+  int error = 0;
+
+  // received data, in provided buffers until it is read
+  struct rx_buf_t {
+    unsigned bid;
+    uint32_t off;
+    uint32_t len;
+  };
+  std::deque<rx_buf_t> rx_bufs;
+  bool rx_eof = false;
+
+  // at most one sendmsg is in flight, what is sent meanwhile is
+  // coalesced into the next one
+  ceph::buffer::list tx_pending;
+  ceph::buffer::list tx_inflight;
+  std::vector<struct iovec> tx_iov;
+  struct msghdr tx_msg;
+
+  void arm_poll() {
+    auto sqe = worker->get_sqe();
+    io_uring_prep_poll_add(sqe, sd, POLLOUT);
+    io_uring_sqe_set_data64(sqe, op_data(this, OP_POLL));
+    ++inflight;
+    poll_armed = true;
+    worker->queue_submit();
+  }
+
+  void post_send() {
+    if (tx_pending.get_num_buffers() > IOV_MAX) {
+      unsigned len = 0, n = 0;
+      for (auto &p : tx_pending.buffers()) {
+        if (n++ == IOV_MAX)
+          break;
+        len += p.length();
+      }
+      tx_pending.splice(0, len, &tx_inflight);
+    } else {
+      tx_inflight.swap(tx_pending);
+    }
+    tx_iov.clear();
+    for (auto &p : tx_inflight.buffers()) {
+      tx_iov.push_back({const_cast<char*>(p.c_str()), p.length()});
+    }
+    // FIPS zeroization audit 20191115: this memset is not security related.
+    memset(&tx_msg, 0, sizeof(tx_msg));
+    tx_msg.msg_iov = tx_iov.data();
+    tx_msg.msg_iovlen = tx_iov.size();
+
+    auto sqe = worker->get_sqe();
+    io_uring_prep_sendmsg(sqe, sd, &tx_msg, MSG_NOSIGNAL | MSG_WAITALL);
+    io_uring_sqe_set_data64(sqe, op_data(this, OP_SEND));
+    ++inflight;
+    send_inflight = true;
+    worker->queue_submit();
+  }
+
+  void handle_cqe(uint64_t op, int res, unsigned flags) override {
+    switch (op) {
+    case OP_POLL:
+      poll_armed = false;
+      if (!closed)
+        notify();
+      break;
+
+    case OP_RECV:
+      if (!(flags & IORING_CQE_F_MORE))
+        recv_armed = false;
+      if (res > 0) {
+        unsigned bid = flags >> IORING_CQE_BUFFER_SHIFT;
+        if (closed) {
+          worker->put_buffer(bid);
+          break;
+        }
+        rx_bufs.push_back({bid, 0, static_cast<uint32_t>(res)});
+        notify();
+        // a multishot receive may also end with data, e.g. when the
+        // completion queue was full
+        arm_recv();
+      } else if (res == 0) {
+        rx_eof = true;
+        notify();
+      } else if (res == -ENOBUFS) {
+        if (!closed)
+          worker->wait_for_buffers(this);
+      } else if (res != -ECANCELED && !closed) {
+        error = res;
+        notify();
+      }
+      break;
+
+    case OP_SEND:
+      send_inflight = false;
+      if (closed) {
+        tx_inflight.clear();
+        break;
+      }
+      if (res < 0) {
+        if (!error)
+          error = res;
+        tx_inflight.clear();
+        tx_pending.clear();
+        notify();
+        break;
+      }
+      if (static_cast<unsigned>(res) < tx_inflight.length()) {
+        tx_inflight.splice(0, res);
+        tx_inflight.claim_append(tx_pending);
+        tx_pending.swap(tx_inflight);
+      }
+      tx_inflight.clear();
+      if (tx_pending.length())
+        post_send();
+      if (tx_full) {
+        tx_full = false;
+        notify();
+      }
+      break;
+
+    default:
+      ceph_abort_msg("unexpected io_uring completion");
+    }
+  }
+
+  void cancel_op(uint64_t op) {
+    auto sqe = worker->get_sqe();
+    io_uring_prep_cancel64(sqe, op_data(this, op), 0);
+    io_uring_sqe_set_data64(sqe, 0);
+    worker->queue_submit();
+  }
+
+  void cancel() override {
+    if (recv_armed)
+      cancel_op(OP_RECV);
+    if (poll_armed)
+      cancel_op(OP_POLL);
+    // a sendmsg in flight is left to complete, like the data a closed
+    // posix socket still has buffered
+    tx_pending.clear();
+    for (auto &b : rx_bufs)
+      worker->put_buffer(b.bid);
+    rx_bufs.clear();
+    worker->stop_waiting_for_buffers(this);
+  }
+
+ public:
+  IoUringConnection(IoUringWorker *w, int sd, const entity_addr_t &sa,
+                    bool connected)
+    : IoUringSocket(w, sd), sa(sa), connected(connected) {}
+
+  void arm_recv() {
+    if (closed || !connected || recv_armed || rx_eof || error)
+      return;
+    auto sqe = worker->get_sqe();
+    io_uring_prep_recv_multishot(sqe, sd, nullptr, 0, 0);
+    sqe->flags |= IOSQE_BUFFER_SELECT;
+    sqe->buf_group = IoUringWorker::BUF_GROUP;
+    io_uring_sqe_set_data64(sqe, op_data(this, OP_RECV));
+    ++inflight;
+    recv_armed = true;
+    worker->queue_submit();
+  }
+
+  int get_sd() const {
+    return sd;
+  }
+
+  int is_connected() {
+    start();
+    if (connected) {
+      arm_recv();
+      return 1;
+    }
+    int r = worker->get_net().reconnect(sa, sd);
+    if (r == 0) {
+      connected = true;
+      arm_recv();
+      return 1;
+    } else if (r < 0) {
+      return r;
+    }
+    if (!poll_armed)
+      arm_poll();
+    return 0;
+  }
+
+  ssize_t read(char *buf, size_t len) {
+    start();
+    arm_recv();
+    size_t copied = 0;
+    while (copied < len && !rx_bufs.empty()) {
+      auto &b = rx_bufs.front();
+      size_t n = std::min<size_t>(len - copied, b.len);
+      memcpy(buf + copied, worker->get_buffer(b.bid) + b.off, n);
+      copied += n;
+      b.off += n;
+      b.len -= n;
+      if (!b.len) {
+        unsigned bid = b.bid;
+        rx_bufs.pop_front();
+        worker->put_buffer(bid);
+      }
+    }
+    if (copied)
+      return copied;
+    if (error)
+      return error;
+    if (rx_eof)
+      return 0;
+    clear_notify();
+    return -EAGAIN;
+  }
+
+  ssize_t send(ceph::buffer::list &bl, bool more) {
+    start();
+    if (error)
+      return error;
+    if (shut)
+      return -EPIPE;
+    // queue no more than ms_async_io_uring_send_queue_size, the caller
+    // keeps the rest until the send in flight completes
+    uint64_t max_queued = worker->get_send_queue_size();
+    size_t len = 0;
+    if (tx_pending.length() < max_queued) {
+      len = std::min<uint64_t>(bl.length(), max_queued - tx_pending.length());
+    }
+    if (len < bl.length()) {
+      tx_full = true;
+    }
+    if (len == bl.length()) {
+      tx_pending.claim_append(bl);
+    } else if (len) {
+      ceph::buffer::list queued;
+      bl.splice(0, len, &queued);
+      tx_pending.claim_append(queued);
+    } else {
+      return 0;
+    }
+    if (!send_inflight && !flush_queued) {
+      // the queued flush holds a reference, like an sqe in flight
+      flush_queued = true;
+      ++inflight;
+      worker->queue_flush(this);
+    }
+    return len;
+  }
+
+  // called by the worker at the end of the round of events that queued it
+  void flush() {
+    ceph_assert(flush_queued);
+    flush_queued = false;
+    --inflight;
+    if (!closed && !error && !send_inflight && tx_pending.length())
+      post_send();
+    put();
+  }
+
+  void shutdown() {
+    ::shutdown(sd, SHUT_RDWR);
+    shut = true;
+  }
+
+  void ring_gone() override {
+    poll_armed = recv_armed = send_inflight = flush_queued = tx_full = false;
+    rx_bufs.clear();
+    tx_inflight.clear();
+    tx_pending.clear();
+    if (!error)
+      error = -ECONNABORTED;
+    notify();
+    IoUringSocket::ring_gone();
+  }
+};
+
+class IoUringListener : public IoUringSocket {
+  bool accept_armed = false;
+  std::deque<int> accepted;
+  int error = 0;
+
+  void handle_cqe(uint64_t op, int res, unsigned flags) override {
+    ceph_assert(op == OP_ACCEPT);
+    if (!(flags & IORING_CQE_F_MORE))
+      accept_armed = false;
+    if (res >= 0) {
+      if (closed) {
+        ::close(res);
+        return;
+      }
+      accepted.push_back(res);
+      notify();
+      arm_accept();
+    } else if (res != -ECANCELED && !closed) {
+      // re-armed by the accept() that picks up the error
+      error = res;
+      notify();
+    }
+  }
+
+  void cancel() override {
+    if (accept_armed) {
+      auto sqe = worker->get_sqe();
+      io_uring_prep_cancel64(sqe, op_data(this, OP_ACCEPT), 0);
+      io_uring_sqe_set_data64(sqe, 0);
+      worker->queue_submit();
+    }
+  }
+
+ public:
+  IoUringListener(IoUringWorker *w, int sd)
+    : IoUringSocket(w, sd) {}
+  ~IoUringListener() override {
+    for (int fd : accepted)
+      ::close(fd);
+  }
+
+  void arm_accept() {
+    start();
+    if (closed || accept_armed)
+      return;
+    auto sqe = worker->get_sqe();
+    io_uring_prep_multishot_accept(sqe, sd, nullptr, nullptr, SOCK_CLOEXEC);
+    io_uring_sqe_set_data64(sqe, op_data(this, OP_ACCEPT));
+    ++inflight;
+    accept_armed = true;
+    worker->queue_submit();
+  }
+
+  int pop(int *fd) {
+    if (!accepted.empty()) {
+      *fd = accepted.front();
+      accepted.pop_front();
+      return 0;
+    }
+    int r = error;
+    error = 0;
+    arm_accept();
+    if (r == 0) {
+      clear_notify();
+      r = -EAGAIN;
+    }
+    return r;
+  }
+
+  void ring_gone() override {
+    accept_armed = false;
+    IoUringSocket::ring_gone();
+  }
+};
+
+class IoUringConnectedSocketImpl final : public ConnectedSocketImpl {
+  IoUringConnection *conn;
+
+ public:
+  explicit IoUringConnectedSocketImpl(IoUringConnection *c) : conn(c) {}
+  ~IoUringConnectedSocketImpl() override {
+    close();
+  }
+
+  int is_connected() override {
+    return conn->is_connected();
+  }
+  ssize_t read(char *buf, size_t len) override {
+    return conn->read(buf, len);
+  }
+  ssize_t send(ceph::buffer::list &bl, bool more) override {
+    return conn->send(bl, more);
+  }
+  void shutdown() override {
+    conn->shutdown();
+  }
+  void close() override {
+    if (conn) {
+      conn->close();
+      conn = nullptr;
+    }
+  }
+  void set_priority(int sd, int prio, int domain) override {
+    // sd is our fd(), which is not the socket
+    conn->get_worker()->get_net().set_priority(conn->get_sd(), prio, domain);
+  }
+  int fd() const override {
+    return conn->fd();
+  }
+};
+
+class IoUringServerSocketImpl : public ServerSocketImpl {
+  IoUringListener *listener;
+
+ public:
+  IoUringServerSocketImpl(IoUringListener *l, const entity_addr_t &listen_addr,
+                          unsigned slot)
+    : ServerSocketImpl(listen_addr.get_type(), slot), listener(l) {}
+  ~IoUringServerSocketImpl() override {
+    abort_accept();
+  }
+  int accept(ConnectedSocket *sock, const SocketOptions &opt, entity_addr_t *out, Worker *w) override;
+  void abort_accept() override {
+    if (listener) {
+      listener->close();
+      listener = nullptr;
+    }
+  }
+  int fd() const override {
+    return listener ? listener->fd() : -1;
+  }
+};
+
+int IoUringServerSocketImpl::accept(ConnectedSocket *sock, const SocketOptions &opt, entity_addr_t *out, Worker *w) {
+  ceph_assert(sock);
+  int sd;
+  int r = listener->pop(&sd);
+  if (r < 0) {
+    return r;
+  }
+
+  ceph::NetHandler &handler = listener->get_worker()->get_net();
+  r = handler.set_nonblock(sd);
+  if (r < 0) {
+    ::close(sd);
+    return -ceph_sock_errno();
+  }
+
+  r = handler.set_socket_options(sd, opt.nodelay, opt.rcbuf_size);
+  if (r < 0) {
+    ::close(sd);
+    return -ceph_sock_errno();
+  }
+
+  sockaddr_storage ss;
+  socklen_t slen = sizeof(ss);
+  if (::getpeername(sd, (sockaddr*)&ss, &slen) < 0) {
+    r = -ceph_sock_errno();
+    ::close(sd);
+    return r;
+  }
+
+  ceph_assert(NULL != out); //out should not be NULL in accept connection
+
+  out->set_type(addr_type);
+  out->set_sockaddr((sockaddr*)&ss);
+  handler.set_priority(sd, opt.priority, out->get_family());
+
+  auto conn = new IoUringConnection(static_cast<IoUringWorker*>(w), sd, *out,
+                                    true);
+  *sock = ConnectedSocket(std::make_unique<IoUringConnectedSocketImpl>(conn));
+  return 0;
+}
+
+class C_handle_ring : public EventCallback {
+  IoUringWorker *worker;
+ public:
+  explicit C_handle_ring(IoUringWorker *w) : worker(w) {}
+  void do_request(uint64_t fd) override {
+    worker->process_completions();
+  }
+};
+
+class C_handle_submit : public EventCallback {
+  IoUringWorker *worker;
+ public:
+  explicit C_handle_submit(IoUringWorker *w) : worker(w) {}
+  void do_request(uint64_t id) override {
+    worker->submit();
+  }
+};
+
+IoUringWorker::IoUringWorker(CephContext *c, unsigned i)
+  : Worker(c, i), net(c),
+    ring_handler(new C_handle_ring(this)),
+    submit_handler(new C_handle_submit(this))
+{
+}
+
+IoUringWorker::~IoUringWorker()
+{
+  delete ring_handler;
+  delete submit_handler;
+}
+
+void IoUringWorker::initialize()
+{
+  send_queue_size =
+    cct->_conf.get_val<Option::size_t>("ms_async_io_uring_send_queue_size");
+  unsigned depth = cct->_conf.get_val<uint64_t>("ms_async_io_uring_queue_depth");
+  int r = io_uring_queue_init(depth, &ring, 0);
+  if (r < 0) {
+    lderr(cct) << __func__ << " io_uring_queue_init failed: "
+               << cpp_strerror(r) << dendl;
+    init_error = r;
+    return;
+  }
+
+  // the ring of provided buffers needs a power of two entries
+  buf_count = std::bit_ceil(
+    cct->_conf.get_val<uint64_t>("ms_async_io_uring_recv_buffers"));
+  buf_size = p2roundup<uint64_t>(
+    cct->_conf.get_val<Option::size_t>("ms_async_io_uring_recv_buffer_size"),
+    CEPH_PAGE_SIZE);
+  r = ::posix_memalign((void**)&buf_base, CEPH_PAGE_SIZE,
+                       (size_t)buf_count * buf_size);
+  if (r != 0) {
+    lderr(cct) << __func__ << " unable to allocate the receive buffers: "
+               << cpp_strerror(r) << dendl;
+    buf_base = nullptr;
+    io_uring_queue_exit(&ring);
+    init_error = -r;
+    return;
+  }
+  buf_ring = io_uring_setup_buf_ring(&ring, buf_count, BUF_GROUP, 0, &r);
+  if (!buf_ring) {
+    lderr(cct) << __func__ << " unable to set up provided buffers: "
+               << cpp_strerror(r) << dendl;
+    ::free(buf_base);
+    buf_base = nullptr;
+    io_uring_queue_exit(&ring);
+    init_error = r;
+    return;
+  }
+  for (unsigned bid = 0; bid < buf_count; bid++) {
+    io_uring_buf_ring_add(buf_ring, get_buffer(bid), buf_size, bid,
+                          io_uring_buf_ring_mask(buf_count), bid);
+  }
+  io_uring_buf_ring_advance(buf_ring, buf_count);
+  ring_ready = true;
+
+  center.create_file_event(ring.ring_fd, EVENT_READABLE, ring_handler);
+  ldout(cct, 10) << __func__ << " queue depth " << depth << ", "
+                 << buf_count << " receive buffers of " << buf_size
+                 << " bytes" << dendl;
+}
+
+void IoUringWorker::destroy()
+{
+  if (!ring_ready)
+    return;
+  center.delete_file_event(ring.ring_fd, EVENT_READABLE);
+
+  // let what is still in flight, e.g. the sends of closed sockets,
+  // complete or be cancelled before the memory it uses goes away
+  submit();
+  if (!sockets.empty()) {
+    auto sqe = get_sqe();
+    io_uring_prep_cancel(sqe, nullptr, IORING_ASYNC_CANCEL_ANY);
+    io_uring_sqe_set_data64(sqe, 0);
+    io_uring_submit(&ring);
+    struct __kernel_timespec ts = {0, 100 * 1000 * 1000};
+    struct io_uring_cqe *cqe;
+    while (!sockets.empty() &&
+           io_uring_wait_cqe_timeout(&ring, &cqe, &ts) == 0) {
+      process_completions();
+    }
+  }
+
+  flushing.clear();
+  starved.clear();
+  submit_queued = false;
+  for (auto s : std::set<IoUringSocket*>(sockets)) {
+    s->ring_gone();
+  }
+  io_uring_free_buf_ring(&ring, buf_ring, buf_count, BUF_GROUP);
+  buf_ring = nullptr;
+  io_uring_queue_exit(&ring);
+  ring_ready = false;
+  ::free(buf_base);
+  buf_base = nullptr;
+}
+
+struct io_uring_sqe *IoUringWorker::get_sqe()
+{
+  ceph_assert(center.in_thread());
+  auto sqe = io_uring_get_sqe(&ring);
+  while (!sqe) {
+    // the submission queue is full, submit what is in it right away
+    int r = io_uring_submit(&ring);
+    if (r < 0) {
+      lderr(cct) << __func__ << " io_uring_submit failed: "
+                 << cpp_strerror(r) << dendl;
+    }
+    sqe = io_uring_get_sqe(&ring);
+  }
+  return sqe;
+}
+
+void IoUringWorker::queue_submit()
+{
+  if (!submit_queued) {
+    submit_queued = true;
+    center.dispatch_event_external(submit_handler);
+  }
+}
+
+void IoUringWorker::queue_flush(IoUringConnection *c)
+{
+  flushing.push_back(c);
+  queue_submit();
+}
+
+void IoUringWorker::submit()
+{
+  submit_queued = false;
+  std::vector<IoUringConnection*> to_flush;
+  to_flush.swap(flushing);
+  for (auto c : to_flush) {
+    c->flush();
+  }
+  if (io_uring_sq_ready(&ring)) {
+    int r = io_uring_submit(&ring);
+    if (r < 0) {
+      lderr(cct) << __func__ << " io_uring_submit failed: "
+                 << cpp_strerror(r) << dendl;
+    }
+  }
+}
+
+void IoUringWorker::process_completions()
+{
+  while (true) {
+    struct io_uring_cqe *cqe;
+    unsigned head;
+    unsigned count = 0;
+    io_uring_for_each_cqe(&ring, head, cqe) {
+      ++count;
+      uint64_t data = io_uring_cqe_get_data64(cqe);
+      if (data && data != LIBURING_UDATA_TIMEOUT) {
+        auto s = reinterpret_cast<IoUringSocket*>(data & ~OP_MASK);
+        s->complete(data & OP_MASK, cqe->res, cqe->flags);
+      }
+    }
+    io_uring_cq_advance(&ring, count);
+    if (!io_uring_cq_has_overflow(&ring))
+      break;
+    io_uring_get_events(&ring);
+  }
+  // send what the completions queued right away, e.g. the rest of a
+  // short send
+  submit();
+}
+
+void IoUringWorker::remove_socket(IoUringSocket *s)
+{
+  sockets.erase(s);
+}
+
+void IoUringWorker::put_buffer(unsigned bid)
+{
+  io_uring_buf_ring_add(buf_ring, get_buffer(bid), buf_size, bid,
+                        io_uring_buf_ring_mask(buf_count), 0);
+  io_uring_buf_ring_advance(buf_ring, 1);
+  if (!starved.empty()) {
+    std::vector<IoUringConnection*> waiting;
+    waiting.swap(starved);
+    for (auto c : waiting)
+      c->arm_recv();
+  }
+}
+
+void IoUringWorker::stop_waiting_for_buffers(IoUringConnection *c)
+{
+  starved.erase(std::remove(starved.begin(), starved.end(), c), starved.end());
+}
+
+int IoUringWorker::listen(entity_addr_t &sa,
+			  unsigned addr_slot,
+			  const SocketOptions &opt,
+			  ServerSocket *sock)
+{
+  if (!ring_ready) {
+    return init_error;
+  }
+  int listen_sd = net.create_socket(sa.get_family(), true);
+  if (listen_sd < 0) {
+    return -ceph_sock_errno();
+  }
+
+  int r = net.set_nonblock(listen_sd);
+  if (r < 0) {
+    ::close(listen_sd);
+    return -ceph_sock_errno();
+  }
+
+  r = net.set_socket_options(listen_sd, opt.nodelay, opt.rcbuf_size);
+  if (r < 0) {
+    ::close(listen_sd);
+    return -ceph_sock_errno();
+  }
+
+  r = ::bind(listen_sd, sa.get_sockaddr(), sa.get_sockaddr_len());
+  if (r < 0) {
+    r = -ceph_sock_errno();
+    ldout(cct, 10) << __func__ << " unable to bind to " << sa.get_sockaddr()
+                   << ": " << cpp_strerror(r) << dendl;
+    ::close(listen_sd);
+    return r;
+  }
+
+  r = ::listen(listen_sd, cct->_conf->ms_tcp_listen_backlog);
+  if (r < 0) {
+    r = -ceph_sock_errno();
+    lderr(cct) << __func__ << " unable to listen on " << sa << ": " << cpp_strerror(r) << dendl;
+    ::close(listen_sd);
+    return r;
+  }
+
+  auto listener = new IoUringListener(this, listen_sd);
+  listener->arm_accept();
+  *sock = ServerSocket(
+          std::make_unique<IoUringServerSocketImpl>(listener, sa, addr_slot));
+  return 0;
+}
+
+int IoUringWorker::connect(const entity_addr_t &addr, const SocketOptions &opts, ConnectedSocket *socket) {
+  if (!ring_ready) {
+    return init_error;
+  }
+  int sd;
+
+  if (opts.nonblock) {
+    sd = net.nonblock_connect(addr, opts.connect_bind_addr);
+  } else {
+    sd = net.connect(addr, opts.connect_bind_addr);
+  }
+
+  if (sd < 0) {
+    return -ceph_sock_errno();
+  }
+
+  net.set_priority(sd, opts.priority, addr.get_family());
+  auto conn = new IoUringConnection(this, sd, addr, !opts.nonblock);
+  *socket = ConnectedSocket(std::make_unique<IoUringConnectedSocketImpl>(conn));
+  return 0;
+}
+
+IoUringStack::IoUringStack(CephContext *c)
+    : NetworkStack(c)
+{
+}
+
+bool IoUringStack::is_supported(CephContext *cct)
+{
+  struct io_uring ring;
+  int r = io_uring_queue_init(8, &ring, 0);
+  if (r < 0) {
+    ldout(cct, 1) << __func__ << " io_uring_queue_init failed: "
+                  << cpp_strerror(r) << dendl;
+    return false;
+  }
+  bool supported = false;
+  // Multishot receives came with Linux 6.0, the probe doesn't report them
+  // but IORING_OP_SEND_ZC, which came along.
+  struct io_uring_probe *probe = io_uring_get_probe_ring(&ring);
+  if (probe && io_uring_opcode_supported(probe, IORING_OP_SEND_ZC)) {
+    auto buf_ring = io_uring_setup_buf_ring(&ring, 1, 0, 0, &r);
+    if (buf_ring) {
+      io_uring_free_buf_ring(&ring, buf_ring, 1, 0);
+      supported = true;
+    } else {
+      ldout(cct, 1) << __func__ << " unable to set up provided buffers: "
+                    << cpp_strerror(r) << dendl;
+    }
+  } else {
+    ldout(cct, 1) << __func__ << " the kernel lacks multishot receives"
+                  << dendl;
+  }
+  if (probe) {
+    io_uring_free_probe(probe);
+  }
+  io_uring_queue_exit(&ring);
+  return supported;
+}
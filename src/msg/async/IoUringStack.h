@@ -0,0 +1,161 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:nil -*-
+// vim: ts=8 sw=2 sts=2 expandtab
+
+/*
+ * Ceph - scalable distributed file system
+ *
+ * This is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License version 2.1, as published by the Free Software
+ * Foundation.  See file COPYING.
+ *
+ */
+
+#ifndef CEPH_MSG_ASYNC_IOURINGSTACK_H
+#define CEPH_MSG_ASYNC_IOURINGSTACK_H
+
+#include <liburing.h>
+
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "msg/msg_types.h"
+#include "msg/async/net_handler.h"
+
+#include "Stack.h"
+
+class IoUringConnection;
+class IoUringWorker;
+
+/*
+ * The part of a socket the ring works with. The sqes of a socket carry a
+ * pointer to it, so it stays around after the socket is closed until the
+ * last of them has completed.
+ *
+ * The event center watches an eventfd instead of the socket itself, which
+ * is signalled when a completion leaves something for the socket's owner
+ * to do.
+ */
+class IoUringSocket {
+ protected:
+  IoUringWorker *worker;
+  int sd;
+  int notify_fd;
+  // sqes of this socket the ring has not completed yet
+  unsigned inflight = 0;
+  bool closed = false;
+  bool registered = false;
+
+  // the first use from the worker's thread
+  void start();
+  void put();
+  virtual void handle_cqe(uint64_t op, int res, unsigned flags) = 0;
+  virtual void cancel() = 0;
+
+ public:
+  IoUringSocket(IoUringWorker *w, int sd);
+  virtual ~IoUringSocket();
+
+  int fd() const {
+    return notify_fd;
+  }
+  IoUringWorker *get_worker() const {
+    return worker;
+  }
+  void notify();
+  void clear_notify();
+  void complete(uint64_t op, int res, unsigned flags);
+  void close();
+  // the ring is gone along with everything that was in flight
+  virtual void ring_gone();
+};
+
+class IoUringWorker : public Worker {
+  ceph::NetHandler net;
+  struct io_uring ring;
+  bool ring_ready = false;
+  // why the ring could not be set up, returned by listen() and connect()
+  int init_error = -ENODEV;
+  uint64_t send_queue_size = 0;
+
+  // provided buffers of the multishot receives
+  struct io_uring_buf_ring *buf_ring = nullptr;
+  char *buf_base = nullptr;
+  unsigned buf_count = 0;
+  unsigned buf_size = 0;
+
+  std::set<IoUringSocket*> sockets;
+  // sockets whose receive stopped for lack of buffers
+  std::vector<IoUringConnection*> starved;
+  // connections with data to send once this round of events is done
+  std::vector<IoUringConnection*> flushing;
+  bool submit_queued = false;
+
+  EventCallbackRef ring_handler;
+  EventCallbackRef submit_handler;
+
+  void initialize() override;
+  void destroy() override;
+
+ public:
+  static constexpr unsigned BUF_GROUP = 0;
+
+  IoUringWorker(CephContext *c, unsigned i);
+  ~IoUringWorker() override;
+  int listen(entity_addr_t &sa,
+	     unsigned addr_slot,
+	     const SocketOptions &opt,
+	     ServerSocket *socks) override;
+  int connect(const entity_addr_t &addr, const SocketOptions &opts, ConnectedSocket *socket) override;
+
+  ceph::NetHandler &get_net() {
+    return net;
+  }
+  uint64_t get_send_queue_size() const {
+    return send_queue_size;
+  }
+  struct io_uring_sqe *get_sqe();
+  void process_completions();
+  void submit();
+  // submit the queued sqes at the end of this round of events
+  void queue_submit();
+  void queue_flush(IoUringConnection *c);
+  void add_socket(IoUringSocket *s) {
+    sockets.insert(s);
+  }
+  void remove_socket(IoUringSocket *s);
+  char *get_buffer(unsigned bid) {
+    return buf_base + (size_t)bid * buf_size;
+  }
+  void put_buffer(unsigned bid);
+  void wait_for_buffers(IoUringConnection *c) {
+    starved.push_back(c);
+  }
+  void stop_waiting_for_buffers(IoUringConnection *c);
+};
+
+class IoUringStack : public NetworkStack {
+  std::vector<std::thread> threads;
+
+  Worker* create_worker(CephContext *c, unsigned worker_id) override {
+    return new IoUringWorker(c, worker_id);
+  }
+
+ public:
+  explicit IoUringStack(CephContext *c);
+
+  // whether the kernel has what the stack needs
+  static bool is_supported(CephContext *cct);
+
+  bool nonblock_connect_need_writable_event() const override { return false; }
+  void spawn_worker(std::function<void ()> &&func) override {
+    threads.emplace_back(std::move(func));
+  }
+  void join_worker(unsigned i) override {
+    ceph_assert(threads.size() > i && threads[i].joinable());
+    threads[i].join();
+  }
+};
+
+#endif //CEPH_MSG_ASYNC_IOURINGSTACK_H
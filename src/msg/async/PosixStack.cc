@@ -20,13 +20,23 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <errno.h>
+#ifdef __linux__
+#include <linux/errqueue.h>
+#include <linux/sockios.h>
+#include <sys/ioctl.h>
+#endif
 
 #include <algorithm>
+#include <chrono>
+#include <deque>
+#include <list>
+#include <memory>
 
 #include "PosixStack.h"
 
 #include "include/buffer.h"
 #include "include/str_list.h"
+#include "common/ceph_time.h"
 #include "common/errno.h"
 #include "common/strtol.h"
 #include "common/dout.h"
@@ -38,16 +48,201 @@
 #undef dout_prefix
 #define dout_prefix *_dout << "PosixStack "
 
+#if defined(__linux__) && defined(MSG_ZEROCOPY) && defined(SO_ZEROCOPY) && \
+    defined(SO_EE_ORIGIN_ZEROCOPY)
+#define HAVE_MSG_ZEROCOPY
+#endif
+
+#ifdef HAVE_MSG_ZEROCOPY
+static bool seq_before_eq(uint32_t a, uint32_t b) {
+  return static_cast<int32_t>(a - b) <= 0;
+}
+
+// The buffers of the MSG_ZEROCOPY sends of a socket the kernel may still
+// read from.
+struct ZerocopySends {
+  struct send_t {
+    // the numbers of the sendmsg calls the buffers were passed to
+    uint32_t first;
+    uint32_t last;
+    // how many of these calls did not complete yet
+    uint32_t left;
+    ceph::buffer::list bl;
+  };
+  // the kernel numbers the MSG_ZEROCOPY sendmsg calls of a socket from 0
+  uint32_t next_seq = 0;
+  std::deque<send_t> pending;
+
+  bool empty() const {
+    return pending.empty();
+  }
+
+  void add(uint32_t calls, ceph::buffer::list&& bl) {
+    pending.push_back({next_seq, next_seq + calls - 1, calls, std::move(bl)});
+    next_seq += calls;
+  }
+
+  // The calls lo..hi completed. The kernel may report the ranges out of
+  // order, so only the buffers of these calls are released.
+  void complete(uint32_t lo, uint32_t hi) {
+    for (auto p = pending.begin(); p != pending.end(); ) {
+      uint32_t first = seq_before_eq(lo, p->first) ? p->first : lo;
+      uint32_t last = seq_before_eq(p->last, hi) ? p->last : hi;
+      if (seq_before_eq(first, last)) {
+        p->left -= last - first + 1;
+      }
+      if (p->left == 0) {
+        p = pending.erase(p);
+      } else {
+        ++p;
+      }
+    }
+  }
+
+  // Release the buffers of the sends the kernel has reported done with on
+  // the error queue of fd. Returns true if it copied the data of some.
+  bool reap(int fd) {
+    bool copied = false;
+    while (!pending.empty()) {
+      char control[CMSG_SPACE(sizeof(struct sock_extended_err) +
+                              sizeof(struct sockaddr_in6))];
+      struct msghdr msg;
+      memset(&msg, 0, sizeof(msg));
+      msg.msg_control = control;
+      msg.msg_controllen = sizeof(control);
+      if (::recvmsg(fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+        break;
+      }
+      for (auto cm = CMSG_FIRSTHDR(&msg); cm; cm = CMSG_NXTHDR(&msg, cm)) {
+        if (!(cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR) &&
+            !(cm->cmsg_level == SOL_IPV6 && cm->cmsg_type == IPV6_RECVERR)) {
+          continue;
+        }
+        struct sock_extended_err serr;
+        memcpy(&serr, CMSG_DATA(cm), sizeof(serr));
+        if (serr.ee_errno != 0 || serr.ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+          continue;
+        }
+        if (serr.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+          copied = true;
+        }
+        complete(serr.ee_info, serr.ee_data);
+      }
+    }
+    return copied;
+  }
+
+  // true once the peer acked all data sent on fd, so the kernel does not
+  // read from the buffers anymore even if it did not report it yet
+  static bool all_acked(int fd) {
+    int unacked = 0;
+    return ::ioctl(fd, SIOCOUTQ, &unacked) == 0 && unacked == 0;
+  }
+};
+
+// Closes the sockets that still have MSG_ZEROCOPY sends pending once the
+// kernel is done with their buffers. It runs off a time event of the
+// worker, so that closing them does not block its event loop.
+class PosixWorker::ZerocopyReaper : public EventCallback {
+  struct closing_t {
+    int fd;
+    ZerocopySends sends;
+    ceph::mono_time deadline;
+  };
+  PosixWorker *worker;
+  std::list<closing_t> closing;
+  uint64_t time_id = 0;
+
+  static constexpr uint64_t interval_us = 10000;
+
+  // The peer did not take the data in time and unsent data still points
+  // into the pending buffers: reset the connection so that it is dropped
+  // instead of sent after they are released.
+  static void reset(int fd) {
+    struct linger l = {1, 0};
+    ::setsockopt(fd, SOL_SOCKET, SO_LINGER, &l, sizeof(l));
+    compat_closesocket(fd);
+  }
+
+ public:
+  explicit ZerocopyReaper(PosixWorker *w) : worker(w) {}
+  ~ZerocopyReaper() override {
+    // the event loop is gone
+    for (auto& c : closing) {
+      reset(c.fd);
+    }
+  }
+
+  void add(int fd, ZerocopySends&& sends) {
+    auto timeout = worker->cct->_conf.get_val<std::chrono::milliseconds>(
+      "ms_async_zerocopy_close_timeout");
+    closing.push_back({fd, std::move(sends), ceph::mono_clock::now() + timeout});
+    if (!time_id) {
+      time_id = worker->center.create_time_event(interval_us, this);
+    }
+  }
+
+  void do_request(uint64_t id) override {
+    time_id = 0;
+    auto now = ceph::mono_clock::now();
+    for (auto c = closing.begin(); c != closing.end(); ) {
+      if (c->sends.reap(c->fd)) {
+        worker->get_perf_counter()->inc(l_msgr_send_zerocopy_copied);
+      }
+      if (c->sends.empty() || ZerocopySends::all_acked(c->fd)) {
+        compat_closesocket(c->fd);
+      } else if (now >= c->deadline) {
+        ldout(worker->cct, 1) << __func__ << " resetting fd " << c->fd
+                              << " with " << c->sends.pending.size()
+                              << " zerocopy sends pending" << dendl;
+        reset(c->fd);
+      } else {
+        ++c;
+        continue;
+      }
+      c = closing.erase(c);
+    }
+    if (!closing.empty()) {
+      time_id = worker->center.create_time_event(interval_us, this);
+    }
+  }
+};
+#else
+class PosixWorker::ZerocopyReaper {};
+#endif
+
 class PosixConnectedSocketImpl final : public ConnectedSocketImpl {
   ceph::NetHandler &handler;
   int _fd;
   entity_addr_t sa;
   bool connected;
+#ifdef HAVE_MSG_ZEROCOPY
+  PosixWorker *worker;
+  PerfCounters *logger;
+  // buffers at least this large are sent with MSG_ZEROCOPY, 0 if disabled
+  uint64_t zc_threshold = 0;
+  ZerocopySends zc_sends;
+#endif
 
  public:
   explicit PosixConnectedSocketImpl(ceph::NetHandler &h, const entity_addr_t &sa,
-				    int f, bool connected)
-      : handler(h), _fd(f), sa(sa), connected(connected) {}
+				    int f, bool connected, Worker *w)
+      : handler(h), _fd(f), sa(sa), connected(connected) {
+#ifdef HAVE_MSG_ZEROCOPY
+    worker = static_cast<PosixWorker*>(w);
+    logger = w->get_perf_counter();
+    uint64_t threshold =
+      w->cct->_conf.get_val<Option::size_t>("ms_async_zerocopy_threshold");
+    int on = 1;
+    if (threshold &&
+        ::setsockopt(_fd, SOL_SOCKET, SO_ZEROCOPY, &on, sizeof(on)) == 0) {
+      zc_threshold = threshold;
+    } else if (threshold) {
+      ldout(w->cct, 1) << __func__ << " unable to enable SO_ZEROCOPY: "
+                       << cpp_strerror(ceph_sock_errno()) << dendl;
+    }
+#endif
+  }
 
   int is_connected() override {
     if (connected)
@@ -65,6 +260,9 @@ class PosixConnectedSocketImpl final : public ConnectedSocketImpl {
   }
 
   ssize_t read(char *buf, size_t len) override {
+    #ifdef HAVE_MSG_ZEROCOPY
+    reap_zerocopy();
+    #endif
     #ifdef _WIN32
     ssize_t r = ::recv(_fd, buf, len, 0);
     #else
@@ -78,13 +276,16 @@ class PosixConnectedSocketImpl final : public ConnectedSocketImpl {
   // return the sent length
   // < 0 means error occurred
   #ifndef _WIN32
-  static ssize_t do_sendmsg(int fd, struct msghdr &msg, unsigned len, bool more)
+  // with flags MSG_ZEROCOPY, *zc_calls is the number of calls that were
+  // made with it
+  static ssize_t do_sendmsg(int fd, struct msghdr &msg, unsigned len, bool more,
+                            int flags = 0, unsigned *zc_calls = nullptr)
   {
     size_t sent = 0;
     while (1) {
       MSGR_SIGPIPE_STOPPER;
       ssize_t r;
-      r = ::sendmsg(fd, &msg, MSG_NOSIGNAL | (more ? MSG_MORE : 0));
+      r = ::sendmsg(fd, &msg, MSG_NOSIGNAL | (more ? MSG_MORE : 0) | flags);
       if (r < 0) {
         int err = ceph_sock_errno();
         if (err == EINTR) {
@@ -92,8 +293,20 @@ class PosixConnectedSocketImpl final : public ConnectedSocketImpl {
         } else if (err == EAGAIN) {
           break;
         }
+        #ifdef HAVE_MSG_ZEROCOPY
+        if (err == ENOBUFS && (flags & MSG_ZEROCOPY)) {
+          // out of locked memory for the pinned pages, copy instead
+          flags &= ~MSG_ZEROCOPY;
+          continue;
+        }
+        #endif
         return -err;
       }
+      #ifdef HAVE_MSG_ZEROCOPY
+      if (flags & MSG_ZEROCOPY) {
+        ++*zc_calls;
+      }
+      #endif
 
       sent += r;
       if (len == sent) break;
@@ -114,7 +327,25 @@ class PosixConnectedSocketImpl final : public ConnectedSocketImpl {
     return (ssize_t)sent;
   }
 
+  #ifdef HAVE_MSG_ZEROCOPY
+  bool use_zerocopy(const ceph::buffer::ptr &p) const {
+    return zc_threshold && p.length() >= zc_threshold;
+  }
+
+  void reap_zerocopy() {
+    if (zc_sends.reap(_fd)) {
+      // the kernel copied the data anyway, so pinning the pages only
+      // costs us; stop doing it on this connection
+      logger->inc(l_msgr_send_zerocopy_copied);
+      zc_threshold = 0;
+    }
+  }
+  #endif
+
   ssize_t send(ceph::buffer::list &bl, bool more) override {
+    #ifdef HAVE_MSG_ZEROCOPY
+    reap_zerocopy();
+    #endif
     size_t sent_bytes = 0;
     auto pb = std::cbegin(bl.buffers());
     uint64_t left_pbrs = bl.get_num_buffers();
@@ -122,6 +353,18 @@ class PosixConnectedSocketImpl final : public ConnectedSocketImpl {
       struct msghdr msg;
       struct iovec msgvec[IOV_MAX];
       uint64_t size = std::min<uint64_t>(left_pbrs, IOV_MAX);
+      #ifdef HAVE_MSG_ZEROCOPY
+      // the buffers of one sendmsg are either all zerocopy or all copied
+      auto first = pb;
+      bool zerocopy = use_zerocopy(*pb);
+      for (uint64_t i = 1; i < size; i++) {
+        if (use_zerocopy(*++first) != zerocopy) {
+          size = i;
+          break;
+        }
+      }
+      first = pb;
+      #endif
       left_pbrs -= size;
       // FIPS zeroization audit 20191115: this memset is not security related.
       memset(&msg, 0, sizeof(msg));
@@ -134,7 +377,24 @@ class PosixConnectedSocketImpl final : public ConnectedSocketImpl {
 	msglen += pb->length();
 	++pb;
       }
+      #ifdef HAVE_MSG_ZEROCOPY
+      unsigned zc_calls = 0;
+      ssize_t r = do_sendmsg(_fd, msg, msglen, left_pbrs || more,
+                             zerocopy ? MSG_ZEROCOPY : 0, &zc_calls);
+      if (zc_calls) {
+        // the kernel reads the pages until it reports the calls done
+        ceph::buffer::list pinned;
+        for (; first != pb; ++first) {
+          pinned.append(*first);
+        }
+        zc_sends.add(zc_calls, std::move(pinned));
+        if (r > 0) {
+          logger->inc(l_msgr_send_zerocopy_bytes, r);
+        }
+      }
+      #else
       ssize_t r = do_sendmsg(_fd, msg, msglen, left_pbrs || more);
+      #endif
       if (r < 0)
         return r;
 
@@ -205,6 +465,16 @@ class PosixConnectedSocketImpl final : public ConnectedSocketImpl {
     ::shutdown(_fd, SHUT_RDWR);
   }
   void close() override {
+    #ifdef HAVE_MSG_ZEROCOPY
+    reap_zerocopy();
+    if (!zc_sends.empty() && !ZerocopySends::all_acked(_fd)) {
+      // the kernel may still read from the buffers, keep them and the fd
+      // until it is done
+      worker->get_zerocopy_reaper()->add(_fd, std::move(zc_sends));
+      zc_sends = ZerocopySends();
+      return;
+    }
+    #endif
     compat_closesocket(_fd);
   }
   void set_priority(int sd, int prio, int domain) override {
@@ -263,11 +533,21 @@ int PosixServerSocketImpl::accept(ConnectedSocket *sock, const SocketOptions &op
   out->set_sockaddr((sockaddr*)&ss);
   handler.set_priority(sd, opt.priority, out->get_family());
 
-  std::unique_ptr<PosixConnectedSocketImpl> csi(new PosixConnectedSocketImpl(handler, *out, sd, true));
+  std::unique_ptr<PosixConnectedSocketImpl> csi(new PosixConnectedSocketImpl(handler, *out, sd, true, w));
   *sock = ConnectedSocket(std::move(csi));
   return 0;
 }
 
+PosixWorker::PosixWorker(CephContext *c, unsigned i)
+  : Worker(c, i), net(c)
+{
+#ifdef HAVE_MSG_ZEROCOPY
+  zc_reaper = std::make_unique<ZerocopyReaper>(this);
+#endif
+}
+
+PosixWorker::~PosixWorker() = default;
+
 void PosixWorker::initialize()
 {
 }
@@ -332,7 +612,7 @@ int PosixWorker::connect(const entity_addr_t &addr, const SocketOptions &opts, C
 
   net.set_priority(sd, opts.priority, addr.get_family());
   *socket = ConnectedSocket(
-      std::unique_ptr<PosixConnectedSocketImpl>(new PosixConnectedSocketImpl(net, addr, sd, !opts.nonblock)));
+      std::unique_ptr<PosixConnectedSocketImpl>(new PosixConnectedSocketImpl(net, addr, sd, !opts.nonblock, this)));
   return 0;
 }
 
@@ -18,6 +18,7 @@
 #ifndef CEPH_MSG_ASYNC_POSIXSTACK_H
 #define CEPH_MSG_ASYNC_POSIXSTACK_H
 
+#include <memory>
 #include <thread>
 
 #include "msg/msg_types.h"
@@ -26,11 +27,18 @@
 #include "Stack.h"
 
 class PosixWorker : public Worker {
+ public:
+  class ZerocopyReaper;
+ private:
   ceph::NetHandler net;
+  std::unique_ptr<ZerocopyReaper> zc_reaper;
   void initialize() override;
  public:
-  PosixWorker(CephContext *c, unsigned i)
-      : Worker(c, i), net(c) {}
+  PosixWorker(CephContext *c, unsigned i);
+  ~PosixWorker() override;
+  ZerocopyReaper* get_zerocopy_reaper() {
+    return zc_reaper.get();
+  }
   int listen(entity_addr_t &sa,
 	     unsigned addr_slot,
 	     const SocketOptions &opt,
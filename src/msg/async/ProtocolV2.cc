@@ -106,7 +106,12 @@ ProtocolV2::ProtocolV2(AsyncConnection *connection)
       rx_frame_asm(&session_stream_handlers, false, cct->_conf->ms_crc_data,
                    &session_compression_handlers),
       next_tag(static_cast<Tag>(0)),
-      keepalive(false) {
+      keepalive(false),
+      send_batch_bytes(cct->_conf.get_val<Option::size_t>(
+        "ms_async_send_batch_bytes")),
+      send_batch_window(std::chrono::microseconds(
+        cct->_conf.get_val<uint64_t>("ms_async_send_batch_window"))),
+      send_gap_avg(2 * send_batch_window) {
 }
 
 ProtocolV2::~ProtocolV2() {
@@ -462,6 +467,13 @@ void ProtocolV2::send_message(Message *m) {
     ldout(cct, 5) << __func__ << " enqueueing message m=" << m
                   << " type=" << m->get_type() << " " << *m << dendl;
     m->queue_start = ceph::mono_clock::now();
+    if (send_batch_window != ceph::timespan::zero()) {
+      // anything further apart than the window is just as sparse
+      const auto gap = std::min<ceph::timespan>(m->queue_start - last_queued,
+                                                2 * send_batch_window);
+      send_gap_avg = (send_gap_avg * 7 + gap) / 8;
+      last_queued = m->queue_start;
+    }
     m->trace.event("async enqueueing message");
     out_queue[m->get_priority()].emplace_back(
       out_queue_entry_t{is_prepared, m});
@@ -525,7 +537,7 @@ ProtocolV2::out_queue_entry_t ProtocolV2::_get_next_outgoing() {
   return out_entry;
 }
 
-ssize_t ProtocolV2::write_message(Message *m, bool more) {
+ssize_t ProtocolV2::write_message(Message *m, bool more, bool hold) {
   FUNCTRACE(cct);
   ceph_assert(connection->center->in_thread());
   m->set_seq(++out_seq);
@@ -546,6 +558,10 @@ ssize_t ProtocolV2::write_message(Message *m, bool more) {
                            footer.flags,      header.compat_version,
                            header.reserved};
 
+  if (session_compression_handlers.tx) {
+    session_compression_handlers.tx->set_msg_type(m->get_type(),
+                                                  m->get_type_name());
+  }
   auto message = MessageFrame::Encode(
 			     header2,
 			     m->get_payload(),
@@ -564,17 +580,16 @@ ssize_t ProtocolV2::write_message(Message *m, bool more) {
                  << " src=" << entity_name_t(messenger->get_myname())
                  << " off=" << header2.data_off
                  << dendl;
-  ssize_t total_send_size = connection->outgoing_bl.length();
-  ssize_t rc = connection->_try_send(more);
-  if (rc < 0) {
+  ssize_t rc = 0;
+  if ((more || hold) && connection->outgoing_bl.length() < send_batch_bytes) {
+    // goes out along with the frames that follow
+    ldout(cct, 20) << __func__ << " holding " << m << ", "
+                   << connection->outgoing_bl.length() << " bytes queued"
+                   << dendl;
+  } else if (rc = send_frames(more); rc < 0) {
     ldout(cct, 1) << __func__ << " error sending " << m << ", "
                   << cpp_strerror(rc) << dendl;
   } else {
-    const auto sent_bytes = total_send_size - connection->outgoing_bl.length();
-    connection->logger->inc(l_msgr_send_bytes, sent_bytes);
-    if (session_stream_handlers.tx) {
-      connection->logger->inc(l_msgr_send_encrypted_bytes, sent_bytes);
-    }
     ldout(cct, 10) << __func__ << " sending " << m
                    << (rc ? " continuely." : " done.") << dendl;
   }
@@ -603,9 +618,28 @@ bool ProtocolV2::append_frame(F& frame) {
   ldout(cct, 25) << __func__ << " assembled frame " << bl.length()
                  << " bytes " << tx_frame_asm << dendl;
   connection->outgoing_bl.claim_append(bl);
+  unsent_frames++;
   return true;
 }
 
+ssize_t ProtocolV2::send_frames(bool more) {
+  if (unsent_frames) {
+    connection->logger->inc(l_msgr_send_batch_frames, unsent_frames);
+    unsent_frames = 0;
+  }
+
+  const auto total_send_size = connection->outgoing_bl.length();
+  const ssize_t r = connection->_try_send(more);
+  if (r >= 0) {
+    const auto sent_bytes = total_send_size - connection->outgoing_bl.length();
+    connection->logger->inc(l_msgr_send_bytes, sent_bytes);
+    if (session_stream_handlers.tx) {
+      connection->logger->inc(l_msgr_send_encrypted_bytes, sent_bytes);
+    }
+  }
+  return r;
+}
+
 void ProtocolV2::handle_message_ack(uint64_t seq) {
   if (connection->policy.lossy) {  // lossy connections don't keep sent messages
     return;
@@ -646,6 +680,11 @@ void ProtocolV2::write_event() {
   ldout(cct, 10) << __func__ << dendl;
   ssize_t r = 0;
 
+  // frames held back in the previous pass of the event loop go out now,
+  // along with the messages queued since, and are not held back again
+  const bool was_held = frames_held;
+  frames_held = false;
+
   connection->write_lock.lock();
   if (can_write) {
     if (keepalive) {
@@ -662,15 +701,13 @@ void ProtocolV2::write_event() {
     }
 
     auto start = ceph::mono_clock::now();
+    bool hold = false;
+    if (!was_held && connection->is_queued()) {
+      // either fails to send or not all queued buffer is sent
+      r = send_frames(false);
+    }
     bool more;
-    do {
-      if (connection->is_queued()) {
-	if (r = connection->_try_send(); r!= 0) {
-	  // either fails to send or not all queued buffer is sent
-	  break;
-	}
-      }
-
+    while (r == 0 && can_write) {
       const auto out_entry = _get_next_outgoing();
       if (!out_entry.m) {
         break;
@@ -682,6 +719,10 @@ void ProtocolV2::write_event() {
         out_entry.m->get();
       }
       more = !out_queue.empty();
+      if (!more && !hold && !was_held && send_gap_avg < send_batch_window) {
+        // more messages are likely to be queued by the end of this pass
+        hold = true;
+      }
       connection->write_lock.unlock();
 
       // send_message or requeue messages may not encode message
@@ -695,7 +736,7 @@ void ProtocolV2::write_event() {
 				 out_entry.m->queue_start);
       }
 
-      r = write_message(out_entry.m, more);
+      r = write_message(out_entry.m, more, hold);
 
       connection->write_lock.lock();
       if (r == 0) {
@@ -708,11 +749,16 @@ void ProtocolV2::write_event() {
 	// when the outbound socket is writeable again
         break;
       }
-    } while (can_write);
+    }
     write_in_progress = false;
 
     // if r > 0 mean data still lefted, so no need _try_send.
-    if (r == 0) {
+    if (r == 0 && hold && connection->is_queued()) {
+      // back for the held frames once the current pass of the event loop
+      // is over. No time event: those are millisecond grained
+      frames_held = true;
+      connection->center->dispatch_event_external(connection->write_handler);
+    } else if (r == 0) {
       uint64_t left = ack_left;
       if (left) {
         ldout(cct, 10) << __func__ << " try send msg ack, acked " << left
@@ -721,12 +767,12 @@ void ProtocolV2::write_event() {
         if (append_frame(ack_frame)) {
           ack_left -= left;
           left = ack_left;
-          r = connection->_try_send(left);
+          r = send_frames(left);
         } else {
           r = -EILSEQ;
         }
       } else if (is_queued()) {
-        r = connection->_try_send();
+        r = send_frames(false);
       }
     }
     connection->write_lock.unlock();
@@ -753,7 +799,7 @@ void ProtocolV2::write_event() {
       connection->_connect();
     } else if (connection->cs && state != NONE && state != CLOSED &&
                state != START_CONNECT) {
-      r = connection->_try_send();
+      r = send_frames(false);
       if (r < 0) {
         ldout(cct, 1) << __func__ << " send outcoming bl failed" << dendl;
         connection->write_lock.unlock();
@@ -1231,8 +1277,15 @@ CtPtr ProtocolV2::read_frame_segment() {
   rx_buffer_t rx_buffer;
   uint16_t align = rx_frame_asm.get_segment_align(seg_idx);
   try {
-    rx_buffer = ceph::buffer::ptr_node::create(ceph::buffer::create_aligned(
-        onwire_len, align));
+    auto &pool = connection->worker->rx_buffer_pool;
+    if (pool && next_tag == Tag::MESSAGE &&
+        seg_idx == SegmentIndex::Msg::DATA) {
+      // the data may well end up with the objectstore as is
+      rx_buffer = ceph::buffer::ptr_node::create(pool->get(onwire_len, align));
+    } else {
+      rx_buffer = ceph::buffer::ptr_node::create(ceph::buffer::create_aligned(
+          onwire_len, align));
+    }
   } catch (const ceph::buffer::bad_alloc&) {
     // Catching because of potential issues with satisfying alignment.
     ldout(cct, 1) << __func__ << " can't allocate aligned rx_buffer"
@@ -2192,7 +2245,15 @@ CtPtr ProtocolV2::send_compression_request() {
   comp_meta.con_mode =
     static_cast<Compressor::CompressionMode>(
       messenger->comp_registry.get_mode(peer_type, auth_meta->is_mode_secure()));
-  const auto preferred_methods = messenger->comp_registry.get_methods(peer_type);
+  const auto preferred_methods =
+    messenger->comp_registry.get_request_methods(peer_type);
+  // remember the zstd dictionary offered, if any
+  comp_meta.con_zstd_dict_id = 0;
+  if (auto p = std::find(preferred_methods.begin(), preferred_methods.end(),
+                         CompressorRegistry::ZSTD_DICT_METHOD);
+      p != preferred_methods.end()) {
+    comp_meta.con_zstd_dict_id = *std::next(p);
+  }
   auto comp_req_frame = CompressionRequestFrame::Encode(comp_meta.is_compress(), preferred_methods);
 
   INTERCEPT(19);
@@ -2210,11 +2271,22 @@ CtPtr ProtocolV2::handle_compression_done(ceph::bufferlist &payload) {
 		 << ", method=" << response.method() << ")" << dendl;
 
   comp_meta.con_method = static_cast<Compressor::CompressionAlgorithm>(response.method());
+  if (response.method() == CompressorRegistry::ZSTD_DICT_METHOD) {
+    // the server took the zstd dictionary we offered
+    if (!comp_meta.con_zstd_dict_id) {
+      lderr(cct) << __func__ << " server picked a zstd dictionary we did not offer"
+                 << dendl;
+      return _fault();
+    }
+    comp_meta.con_method = Compressor::COMP_ALG_ZSTD;
+  } else {
+    comp_meta.con_zstd_dict_id = 0;
+  }
   if (comp_meta.is_compress() != response.is_compress()) {
     comp_meta.con_mode = Compressor::COMP_NONE;
   }
   session_compression_handlers = ceph::compression::onwire::rxtx_t::create_handler_pair(
-    cct, comp_meta, messenger->comp_registry.get_min_compression_size(connection->get_peer_type()));
+    cct, comp_meta, messenger->comp_registry, connection->get_peer_type());
 
   return start_session_connect();
 }
@@ -3085,7 +3157,8 @@ CtPtr ProtocolV2::handle_compression_request(ceph::bufferlist &payload) {
   if (Compressor::CompressionMode mode = messenger->comp_registry.get_mode(
         peer_type, auth_meta->is_mode_secure());
       mode != Compressor::COMP_NONE && request.is_compress()) {
-    comp_meta.con_method = messenger->comp_registry.pick_method(peer_type, request.preferred_methods());
+    comp_meta.con_method = messenger->comp_registry.pick_method(
+      peer_type, request.preferred_methods(), &comp_meta.con_zstd_dict_id);
     ldout(cct, 10) << __func__ << " Compressor(pick_method=" 
                    << Compressor::get_comp_alg_name(comp_meta.get_method())
                    << ")" << dendl;
@@ -3094,9 +3167,13 @@ CtPtr ProtocolV2::handle_compression_request(ceph::bufferlist &payload) {
     }
   } else {
     comp_meta.con_method = Compressor::COMP_ALG_NONE;
+    comp_meta.con_zstd_dict_id = 0;
   }
   
-  auto response = CompressionDoneFrame::Encode(comp_meta.is_compress(), comp_meta.get_method());
+  auto response = CompressionDoneFrame::Encode(
+    comp_meta.is_compress(),
+    comp_meta.con_zstd_dict_id ? CompressorRegistry::ZSTD_DICT_METHOD
+                               : comp_meta.get_method());
 
   INTERCEPT(20);
   return WRITE(response, "compression done", finish_compression);
@@ -3107,7 +3184,7 @@ CtPtr ProtocolV2::finish_compression() {
   // allow reusing finish_compression().
   
   session_compression_handlers = ceph::compression::onwire::rxtx_t::create_handler_pair(
-    cct, comp_meta, messenger->comp_registry.get_min_compression_size(connection->get_peer_type()));
+    cct, comp_meta, messenger->comp_registry, connection->get_peer_type());
 
   state = SESSION_ACCEPTING;
   return CONTINUE(read_frame);
@@ -128,6 +128,20 @@ private:
   bool keepalive;
   bool write_in_progress = false;
 
+  // The frames of queued messages are sent together, up to
+  // send_batch_bytes. When messages are queued closer together than
+  // send_batch_window on average, the frames are held back until the end
+  // of the current pass of the event loop for the ones that follow.
+  const uint64_t send_batch_bytes;
+  const ceph::timespan send_batch_window;
+  // protected by write_lock
+  ceph::timespan send_gap_avg;
+  ceph::mono_time last_queued;
+  // only used from the connection's event center thread
+  bool frames_held = false;
+  // frames appended since the last send
+  uint32_t unsent_frames = 0;
+
   CompConnectionMeta comp_meta;
   std::ostream& _conn_prefix(std::ostream *_dout);
   void run_continuation(Ct<ProtocolV2> *pcontinuation);
@@ -156,7 +170,8 @@ private:
   void reset_session();
   void prepare_send_message(uint64_t features, Message *m);
   out_queue_entry_t _get_next_outgoing();
-  ssize_t write_message(Message *m, bool more);
+  ssize_t write_message(Message *m, bool more, bool hold);
+  ssize_t send_frames(bool more);
   void handle_message_ack(uint64_t seq);
   void reset_compression();
 
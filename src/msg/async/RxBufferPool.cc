@@ -0,0 +1,142 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:nil -*-
+// vim: ts=8 sw=2 sts=2 expandtab
+
+/*
+ * Ceph - scalable distributed file system
+ *
+ * This is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License version 2.1, as published by the Free Software
+ * Foundation.  See file COPYING.
+ *
+ */
+
+#include <bit>
+#include <stdlib.h>
+#include <sys/mman.h>
+
+#include "RxBufferPool.h"
+#include "Stack.h"
+#include "common/ceph_context.h"
+#include "common/perf_counters.h"
+#include "include/buffer_raw.h"
+#include "include/compat.h"
+#include "include/intarith.h"
+
+static constexpr unsigned HUGE_PAGE_SIZE = 2 << 20;
+
+class RxBufferPool::raw_pooled : public ceph::buffer::raw {
+  std::shared_ptr<RxBufferPool> pool;
+  unsigned cls;
+
+ public:
+  raw_pooled(std::shared_ptr<RxBufferPool> pool, unsigned cls,
+             char *data, unsigned size)
+    : raw(data, size), pool(std::move(pool)), cls(cls) {}
+  ~raw_pooled() override {
+    pool->put(cls, data, len);
+  }
+};
+
+std::pair<unsigned, unsigned> RxBufferPool::size_class(unsigned len)
+{
+  if (len <= (1u << MIN_SHIFT)) {
+    return {0, 1u << MIN_SHIFT};
+  }
+  // 2^(b-1) < len <= 2^b, split into four steps
+  const unsigned b = std::bit_width(len - 1);
+  const unsigned step = 1u << (b - 3);
+  const unsigned q = (len + step - 1) / step;
+  return {1 + (b - MIN_SHIFT - 1) * 4 + (q - 5), q * step};
+}
+
+RxBufferPool::RxBufferPool(CephContext *cct, PerfCounters *logger)
+  : logger(logger),
+    max_buffer_size(std::max<uint64_t>(
+      cct->_conf.get_val<Option::size_t>("ms_async_rx_buffer_pool_max_buffer"),
+      1u << MIN_SHIFT)),
+    max_cached(cct->_conf.get_val<Option::size_t>("ms_async_rx_buffer_pool_size")),
+    hugepages(cct->_conf.get_val<bool>("ms_async_rx_buffer_pool_hugepages")),
+    cached(size_class(max_buffer_size).first + 1)
+{
+}
+
+RxBufferPool::~RxBufferPool()
+{
+  shutdown();
+}
+
+char *RxBufferPool::allocate(unsigned size)
+{
+  const bool huge = hugepages && size >= HUGE_PAGE_SIZE;
+  void *data = nullptr;
+  if (::posix_memalign(&data, huge ? HUGE_PAGE_SIZE : CEPH_PAGE_SIZE, size)) {
+    throw ceph::buffer::bad_alloc();
+  }
+#ifdef MADV_HUGEPAGE
+  if (huge) {
+    // best effort, the buffer works all the same without
+    ::madvise(data, size, MADV_HUGEPAGE);
+  }
+#endif
+  return static_cast<char*>(data);
+}
+
+void RxBufferPool::put(unsigned cls, char *data, unsigned size)
+{
+  {
+    std::lock_guard l{lock};
+    if (!closed && cached_bytes + size <= max_cached) {
+      cached[cls].push_back(data);
+      cached_bytes += size;
+      return;
+    }
+  }
+  ::free(data);
+}
+
+ceph::bufferptr RxBufferPool::get(unsigned len, unsigned align)
+{
+  if (len < (1u << MIN_SHIFT) || len > max_buffer_size ||
+      align > CEPH_PAGE_SIZE) {
+    return ceph::bufferptr(ceph::buffer::create_aligned(len, align));
+  }
+
+  const auto [cls, size] = size_class(len);
+  char *data = nullptr;
+  {
+    std::lock_guard l{lock};
+    if (!closed && !cached[cls].empty()) {
+      data = cached[cls].back();
+      cached[cls].pop_back();
+      cached_bytes -= size;
+    }
+  }
+  if (data) {
+    logger->inc(l_msgr_rx_buffer_pool_hits);
+  } else {
+    logger->inc(l_msgr_rx_buffer_pool_misses);
+    data = allocate(size);
+  }
+
+  ceph::bufferptr bp(ceph::unique_leakable_ptr<ceph::buffer::raw>(
+    new raw_pooled(shared_from_this(), cls, data, size)));
+  bp.set_length(len);
+  return bp;
+}
+
+void RxBufferPool::shutdown()
+{
+  std::vector<std::vector<char*>> to_free;
+  {
+    std::lock_guard l{lock};
+    closed = true;
+    to_free.swap(cached);
+    cached_bytes = 0;
+  }
+  for (auto &bufs : to_free) {
+    for (auto data : bufs) {
+      ::free(data);
+    }
+  }
+}
@@ -0,0 +1,68 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:nil -*-
+// vim: ts=8 sw=2 sts=2 expandtab
+
+/*
+ * Ceph - scalable distributed file system
+ *
+ * This is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License version 2.1, as published by the Free Software
+ * Foundation.  See file COPYING.
+ *
+ */
+
+#ifndef CEPH_MSG_ASYNC_RXBUFFERPOOL_H
+#define CEPH_MSG_ASYNC_RXBUFFERPOOL_H
+
+#include <memory>
+#include <vector>
+
+#include "include/buffer.h"
+#include "include/common_fwd.h"
+#include "include/spinlock.h"
+
+/*
+ * Page aligned buffers for the data segments a worker receives. Freed
+ * buffers are kept for reuse by size class, up to a total size, rather
+ * than handed back to the allocator, which saves the allocation and the
+ * page faults of the next message. A buffer goes back to the pool of the
+ * worker it was received by whichever thread releases it, so it stays on
+ * the NUMA node of that worker.
+ *
+ * The size classes are 4K and then four classes between each power of two
+ * and the next, which wastes at most a quarter of a buffer.
+ */
+class RxBufferPool : public std::enable_shared_from_this<RxBufferPool> {
+  class raw_pooled;
+
+  static constexpr unsigned MIN_SHIFT = 12;
+
+  PerfCounters *logger;
+  const unsigned max_buffer_size;
+  const uint64_t max_cached;
+  const bool hugepages;
+
+  ceph::spinlock lock;
+  // the cached buffers of each size class
+  std::vector<std::vector<char*>> cached;
+  uint64_t cached_bytes = 0;
+  bool closed = false;
+
+  char *allocate(unsigned size);
+  void put(unsigned cls, char *data, unsigned size);
+
+ public:
+  // the size class of len and its buffer size
+  static std::pair<unsigned, unsigned> size_class(unsigned len);
+
+  RxBufferPool(CephContext *cct, PerfCounters *logger);
+  ~RxBufferPool();
+
+  // a buffer of len bytes aligned to align, from the pool when len is
+  // within its size classes
+  ceph::bufferptr get(unsigned len, unsigned align);
+  // drop the cached buffers, buffers released afterwards are freed
+  void shutdown();
+};
+
+#endif
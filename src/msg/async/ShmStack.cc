@@ -0,0 +1,717 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:nil -*-
+// vim: ts=8 sw=2 sts=2 expandtab
+
+/*
+ * Ceph - scalable distributed file system
+ *
+ * This is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License version 2.1, as published by the Free Software
+ * Foundation.  See file COPYING.
+ *
+ */
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+
+#include "ShmStack.h"
+
+#include "common/dout.h"
+#include "common/errno.h"
+#include "include/stringify.h"
+
+#define dout_subsys ceph_subsys_ms
+#undef dout_prefix
+#define dout_prefix *_dout << "ShmStack "
+
+namespace {
+
+constexpr uint32_t SHM_MAGIC = 0x6d736873;
+// the rings' positions, their data follows
+constexpr uint64_t SHM_HEADER_SIZE = 4096;
+constexpr uint64_t SHM_MIN_RING_SIZE = 4096;
+constexpr uint64_t SHM_MAX_RING_SIZE = 1ull << 30;
+// neither side can resize the region under the other one's mapping
+constexpr int SHM_SEALS = F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL;
+// the connector binds its unix socket to this abstract name followed by
+// its address, which is how the listener learns it
+constexpr std::string_view SHM_PEER_PREFIX = "ceph-msgr-shm ";
+
+// One direction of a connection. The positions only grow, the data of a
+// position is at position % size.
+struct shm_ring {
+  // written by the producer only
+  alignas(64) std::atomic<uint64_t> head;
+  // written by the consumer only
+  alignas(64) std::atomic<uint64_t> tail;
+  // the consumer found the ring empty, and waits for a byte on the unix
+  // socket
+  alignas(64) std::atomic<uint32_t> consumer_waiting;
+  // the producer found the ring full, and waits for its eventfd
+  alignas(64) std::atomic<uint32_t> producer_waiting;
+};
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+struct shm_header {
+  uint32_t magic;
+  uint64_t ring_size;
+  // from the connector to the listener, and back
+  shm_ring rings[2];
+};
+static_assert(sizeof(shm_header) <= SHM_HEADER_SIZE);
+
+// what the connector sends first, along with the fds below
+struct shm_hello {
+  uint32_t magic;
+  uint32_t reserved;
+  uint64_t ring_size;
+};
+
+enum {
+  FD_REGION,
+  FD_CONNECTOR_SPACE,
+  FD_LISTENER_SPACE,
+  FD_COUNT
+};
+
+} // anonymous namespace
+
+class ShmConnectedSocketImpl final : public ConnectedSocketImpl {
+  class C_handle_space : public EventCallback {
+    ShmConnectedSocketImpl *s;
+   public:
+    explicit C_handle_space(ShmConnectedSocketImpl *s) : s(s) {}
+    void do_request(uint64_t fd) override {
+      s->handle_space();
+    }
+  };
+
+  Worker *worker;
+  CephContext *cct;
+  int sd;
+  // the connector's side holds the port of its address
+  int port_sd;
+  // the listener's side is until the connector's hello arrives
+  bool established = false;
+  bool registered = false;
+  bool peer_closed = false;
+  int error = 0;
+
+  char *region = nullptr;
+  uint64_t region_size = 0;
+  uint64_t ring_size = 0;
+  shm_ring *tx = nullptr;
+  shm_ring *rx = nullptr;
+  char *tx_data = nullptr;
+  char *rx_data = nullptr;
+  // our copies of tx->head and rx->tail
+  uint64_t tx_head = 0;
+  uint64_t rx_tail = 0;
+  // signalled by the peer once it made room in tx
+  int space_fd = -1;
+  // signalled by us once we made room in rx
+  int peer_space_fd = -1;
+  C_handle_space space_handler;
+  // what did not fit into tx yet
+  ceph::buffer::list tx_pending;
+
+  int map(int memfd, uint64_t size, bool connector) {
+    void *p = ::mmap(nullptr, SHM_HEADER_SIZE + 2 * size,
+                     PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+    if (p == MAP_FAILED) {
+      return -errno;
+    }
+    region = static_cast<char*>(p);
+    region_size = SHM_HEADER_SIZE + 2 * size;
+    ring_size = size;
+
+    auto header = reinterpret_cast<shm_header*>(region);
+    if (connector) {
+      header->magic = SHM_MAGIC;
+      header->ring_size = size;
+    } else if (header->magic != SHM_MAGIC || header->ring_size != size) {
+      return -EINVAL;
+    }
+    tx = &header->rings[connector ? 0 : 1];
+    rx = &header->rings[connector ? 1 : 0];
+    tx_data = region + SHM_HEADER_SIZE + (connector ? 0 : size);
+    rx_data = region + SHM_HEADER_SIZE + (connector ? size : 0);
+    tx_head = tx->head.load();
+    rx_tail = rx->tail.load();
+    established = true;
+    return 0;
+  }
+
+  int send_hello(int memfd) {
+    shm_hello hello = {SHM_MAGIC, 0, ring_size};
+    int fds[FD_COUNT];
+    fds[FD_REGION] = memfd;
+    fds[FD_CONNECTOR_SPACE] = space_fd;
+    fds[FD_LISTENER_SPACE] = peer_space_fd;
+
+    struct iovec iov = {&hello, sizeof(hello)};
+    union {
+      char buf[CMSG_SPACE(sizeof(fds))];
+      struct cmsghdr align;
+    } control;
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    memset(&control, 0, sizeof(control));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+    struct cmsghdr *cm = CMSG_FIRSTHDR(&msg);
+    cm->cmsg_level = SOL_SOCKET;
+    cm->cmsg_type = SCM_RIGHTS;
+    cm->cmsg_len = CMSG_LEN(sizeof(fds));
+    memcpy(CMSG_DATA(cm), fds, sizeof(fds));
+
+    ssize_t r = ::sendmsg(sd, &msg, MSG_DONTWAIT | MSG_NOSIGNAL);
+    if (r < 0) {
+      return -errno;
+    }
+    return r == sizeof(hello) ? 0 : -EIO;
+  }
+
+  static bool is_sealed(int memfd) {
+    int seals = ::fcntl(memfd, F_GET_SEALS);
+    return seals >= 0 && (seals & SHM_SEALS) == SHM_SEALS;
+  }
+
+  // 1 once the connector's hello is in, 0 if the connector went away
+  int receive_hello() {
+    shm_hello hello;
+    struct iovec iov = {&hello, sizeof(hello)};
+    union {
+      char buf[CMSG_SPACE(sizeof(int) * FD_COUNT)];
+      struct cmsghdr align;
+    } control;
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+    ssize_t r = ::recvmsg(sd, &msg, MSG_DONTWAIT | MSG_CMSG_CLOEXEC);
+    if (r < 0) {
+      return -errno;
+    } else if (r == 0) {
+      return 0;
+    }
+
+    int fds[FD_COUNT];
+    int nfds = 0;
+    for (auto cm = CMSG_FIRSTHDR(&msg); cm; cm = CMSG_NXTHDR(&msg, cm)) {
+      if (cm->cmsg_level == SOL_SOCKET && cm->cmsg_type == SCM_RIGHTS) {
+        nfds = std::min<int>((cm->cmsg_len - CMSG_LEN(0)) / sizeof(int),
+                             FD_COUNT);
+        memcpy(fds, CMSG_DATA(cm), sizeof(int) * nfds);
+      }
+    }
+    if (nfds == FD_COUNT) {
+      space_fd = fds[FD_LISTENER_SPACE];
+      peer_space_fd = fds[FD_CONNECTOR_SPACE];
+    } else {
+      for (int i = 0; i < nfds; i++) {
+        ::close(fds[i]);
+      }
+    }
+
+    struct stat st;
+    int ret = -EINVAL;
+    if (r == sizeof(hello) && nfds == FD_COUNT &&
+        hello.magic == SHM_MAGIC &&
+        std::has_single_bit(hello.ring_size) &&
+        hello.ring_size >= SHM_MIN_RING_SIZE &&
+        hello.ring_size <= SHM_MAX_RING_SIZE &&
+        ::fstat(fds[FD_REGION], &st) == 0 &&
+        (uint64_t)st.st_size == SHM_HEADER_SIZE + 2 * hello.ring_size &&
+        is_sealed(fds[FD_REGION])) {
+      ret = map(fds[FD_REGION], hello.ring_size, false);
+    }
+    if (nfds == FD_COUNT) {
+      ::close(fds[FD_REGION]);
+    }
+    if (ret < 0) {
+      ldout(cct, 1) << __func__ << " bad hello on sd=" << sd << ": "
+                    << cpp_strerror(ret) << dendl;
+      return ret;
+    }
+    ldout(cct, 10) << __func__ << " sd=" << sd << " ring_size=" << ring_size
+                   << dendl;
+    return 1;
+  }
+
+  void start() {
+    if (!registered) {
+      ceph_assert(worker->center.in_thread());
+      registered = true;
+      worker->center.create_file_event(space_fd, EVENT_READABLE,
+                                       &space_handler);
+    }
+  }
+
+  // the bytes on the unix socket only say there is something in rx
+  void drain_doorbells() {
+    char buf[64];
+    while (!peer_closed) {
+      ssize_t r = ::recv(sd, buf, sizeof(buf), MSG_DONTWAIT);
+      if (r > 0) {
+        continue;
+      } else if (r < 0 && errno == EINTR) {
+        continue;
+      } else if (r < 0 && errno == EAGAIN) {
+        break;
+      }
+      peer_closed = true;
+    }
+  }
+
+  void ring_doorbell() {
+    char c = 0;
+    // a full socket means the peer has doorbells it did not look at yet
+    if (::send(sd, &c, 1, MSG_DONTWAIT | MSG_NOSIGNAL) < 0 &&
+        errno != EAGAIN) {
+      error = -errno;
+    }
+  }
+
+  // the positions come from the peer, which could have them say that
+  // more than the ring holds is in it
+  bool is_valid(uint64_t head, uint64_t tail) const {
+    return head - tail <= ring_size;
+  }
+
+  ssize_t consume(char *buf, size_t len) {
+    const uint64_t head = rx->head.load();
+    if (!is_valid(head, rx_tail)) {
+      ldout(cct, 1) << __func__ << " sd=" << sd << " bad rx ring head " << head
+                    << " tail " << rx_tail << dendl;
+      return error = -EIO;
+    }
+    size_t n = std::min<uint64_t>(head - rx_tail, len);
+    if (!n) {
+      return 0;
+    }
+    uint64_t off = rx_tail & (ring_size - 1);
+    uint64_t first = std::min<uint64_t>(n, ring_size - off);
+    memcpy(buf, rx_data + off, first);
+    memcpy(buf + first, rx_data, n - first);
+    rx_tail += n;
+    rx->tail.store(rx_tail);
+    if (rx->producer_waiting.load() && rx->producer_waiting.exchange(0)) {
+      eventfd_write(peer_space_fd, 1);
+    }
+    return n;
+  }
+
+  uint64_t get_tx_room() {
+    const uint64_t tail = tx->tail.load();
+    if (!is_valid(tx_head, tail)) {
+      ldout(cct, 1) << __func__ << " sd=" << sd << " bad tx ring head "
+                    << tx_head << " tail " << tail << dendl;
+      error = -EIO;
+      return 0;
+    }
+    return ring_size - (tx_head - tail);
+  }
+
+  void flush() {
+    bool produced = false;
+    while (tx_pending.length() && !error) {
+      uint64_t room = get_tx_room();
+      if (!room) {
+        // ask for a signal, unless the peer made room meanwhile
+        tx->producer_waiting.store(1);
+        room = get_tx_room();
+        if (!room) {
+          break;
+        }
+        tx->producer_waiting.store(0);
+      }
+      uint64_t n = std::min<uint64_t>(room, tx_pending.length());
+      uint64_t off = tx_head & (ring_size - 1);
+      uint64_t first = std::min<uint64_t>(n, ring_size - off);
+      auto p = tx_pending.cbegin();
+      p.copy(first, tx_data + off);
+      p.copy(n - first, tx_data);
+      tx_pending.splice(0, n);
+      tx_head += n;
+      tx->head.store(tx_head);
+      produced = true;
+    }
+    if (produced && tx->consumer_waiting.load() &&
+        tx->consumer_waiting.exchange(0)) {
+      ring_doorbell();
+    }
+  }
+
+  void handle_space() {
+    eventfd_t value;
+    eventfd_read(space_fd, &value);
+    flush();
+  }
+
+ public:
+  ShmConnectedSocketImpl(Worker *w, int sd, int port_sd = -1)
+    : worker(w), cct(w->cct), sd(sd), port_sd(port_sd), space_handler(this) {}
+  ~ShmConnectedSocketImpl() override {
+    close();
+  }
+
+  // the connector's side: create the region and hand it to the listener
+  int start_connect(uint64_t size) {
+    space_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    peer_space_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    int memfd = ::memfd_create("ceph-msgr", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    int r = 0;
+    if (space_fd < 0 || peer_space_fd < 0 || memfd < 0) {
+      r = -errno;
+    } else if (::ftruncate(memfd, SHM_HEADER_SIZE + 2 * size) < 0 ||
+               ::fcntl(memfd, F_ADD_SEALS, SHM_SEALS) < 0) {
+      r = -errno;
+    } else if (r = map(memfd, size, true); r == 0) {
+      r = send_hello(memfd);
+    }
+    if (memfd >= 0) {
+      ::close(memfd);
+    }
+    return r;
+  }
+
+  int is_connected() override {
+    return 1;
+  }
+
+  ssize_t read(char *buf, size_t len) override {
+    if (error) {
+      return error;
+    }
+    if (!established) {
+      if (int r = receive_hello(); r <= 0) {
+        return r;
+      }
+    }
+    start();
+    drain_doorbells();
+    ssize_t n = consume(buf, len);
+    if (!n && !peer_closed) {
+      // ask for a doorbell, unless something came in meanwhile
+      rx->consumer_waiting.store(1);
+      n = consume(buf, len);
+      if (n) {
+        rx->consumer_waiting.store(0);
+      }
+    }
+    if (n) {
+      return n;
+    }
+    return peer_closed ? 0 : -EAGAIN;
+  }
+
+  // everything is taken, what does not fit into the ring goes out once
+  // the peer makes room
+  ssize_t send(ceph::buffer::list &bl, bool more) override {
+    if (error) {
+      return error;
+    } else if (peer_closed) {
+      return -EPIPE;
+    }
+    ssize_t len = bl.length();
+    tx_pending.claim_append(bl);
+    if (established) {
+      start();
+      flush();
+    }
+    return error ? error : len;
+  }
+
+  void shutdown() override {
+    ::shutdown(sd, SHUT_RDWR);
+    error = -EPIPE;
+  }
+
+  void close() override {
+    if (registered) {
+      worker->center.delete_file_event(space_fd, EVENT_READABLE);
+      registered = false;
+    }
+    for (int *fd : {&sd, &port_sd, &space_fd, &peer_space_fd}) {
+      if (*fd >= 0) {
+        ::close(*fd);
+        *fd = -1;
+      }
+    }
+    if (region) {
+      ::munmap(region, region_size);
+      region = nullptr;
+    }
+    established = false;
+    tx_pending.clear();
+  }
+
+  void set_priority(int sd, int prio, int domain) override {
+  }
+
+  int fd() const override {
+    return sd;
+  }
+};
+
+class ShmServerSocketImpl : public ServerSocketImpl {
+  ServerSocket tcp;
+  entity_addr_t listen_addr;
+  std::string path;
+  int unix_sd;
+  // readable when either of the sockets is
+  int epfd;
+
+  // the address the connector bound its unix socket to
+  static bool get_peer_addr(const struct sockaddr_un &un, socklen_t len,
+                            entity_addr_t *addr) {
+    const size_t off = offsetof(struct sockaddr_un, sun_path);
+    if (len <= off + 1 || un.sun_path[0] != '\0') {
+      return false;
+    }
+    std::string_view name(un.sun_path + 1, len - off - 1);
+    if (!name.starts_with(SHM_PEER_PREFIX)) {
+      return false;
+    }
+    name.remove_prefix(SHM_PEER_PREFIX.size());
+    return addr->parse(name) && addr->is_ip() && addr->get_port();
+  }
+
+ public:
+  ShmServerSocketImpl(ServerSocket &&tcp, const entity_addr_t &sa,
+                      unsigned slot, const std::string &path,
+                      int unix_sd, int epfd)
+    : ServerSocketImpl(sa.get_type(), slot),
+      tcp(std::move(tcp)), listen_addr(sa), path(path),
+      unix_sd(unix_sd), epfd(epfd) {}
+
+  int accept(ConnectedSocket *sock, const SocketOptions &opt,
+             entity_addr_t *out, Worker *w) override {
+    ceph_assert(sock);
+    ceph_assert(out);
+    // consume the edges first, so that a connection coming in after
+    // the accepts below makes a new one
+    struct epoll_event events[2];
+    ::epoll_wait(epfd, events, 2, 0);
+
+    struct sockaddr_un un;
+    socklen_t len = sizeof(un);
+    int sd;
+    while ((sd = ::accept4(unix_sd, (struct sockaddr*)&un, &len,
+                           SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+      if (get_peer_addr(un, len, out)) {
+        out->set_type(listen_addr.get_type());
+        out->set_nonce(0);
+        *sock = ConnectedSocket(std::make_unique<ShmConnectedSocketImpl>(w, sd));
+        return 0;
+      }
+      ldout(w->cct, 1) << __func__ << " dropping a connection on " << path
+                       << " without a peer address" << dendl;
+      ::close(sd);
+      len = sizeof(un);
+    }
+    if (errno != EAGAIN) {
+      return -errno;
+    }
+    return tcp.accept(sock, opt, out, w);
+  }
+
+  void abort_accept() override {
+    if (unix_sd >= 0) {
+      ::unlink(path.c_str());
+      ::close(unix_sd);
+      unix_sd = -1;
+    }
+    if (epfd >= 0) {
+      ::close(epfd);
+      epfd = -1;
+    }
+    if (tcp) {
+      tcp.abort_accept();
+    }
+  }
+
+  int fd() const override {
+    return epfd;
+  }
+};
+
+std::string ShmWorker::get_path(const entity_addr_t &addr) const
+{
+  const auto dir = cct->_conf.get_val<std::string>("ms_async_shm_dir");
+  if (dir.empty() || addr.is_blank_ip() || !addr.get_port()) {
+    return {};
+  }
+  return dir + "/" + addr.ip_only_to_str() + ":" +
+    std::to_string(addr.get_port());
+}
+
+int ShmWorker::listen(entity_addr_t &sa,
+                      unsigned addr_slot,
+                      const SocketOptions &opt,
+                      ServerSocket *sock)
+{
+  ServerSocket tcp;
+  int r = PosixWorker::listen(sa, addr_slot, opt, &tcp);
+  if (r < 0) {
+    return r;
+  }
+
+  const auto path = get_path(sa);
+  struct sockaddr_un un;
+  memset(&un, 0, sizeof(un));
+  un.sun_family = AF_UNIX;
+  if (path.empty() || path.size() >= sizeof(un.sun_path)) {
+    ldout(cct, 10) << __func__ << " peers on this host connect to " << sa
+                   << " over TCP" << dendl;
+    *sock = std::move(tcp);
+    return 0;
+  }
+  path.copy(un.sun_path, path.size());
+
+  int unix_sd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  int epfd = ::epoll_create1(EPOLL_CLOEXEC);
+  if (unix_sd >= 0 && epfd >= 0) {
+    // left behind by whoever listened on this address before
+    ::unlink(path.c_str());
+    r = ::bind(unix_sd, (struct sockaddr*)&un, sizeof(un));
+    if (r == 0) {
+      r = ::listen(unix_sd, cct->_conf->ms_tcp_listen_backlog);
+    }
+    for (int fd : {unix_sd, tcp.fd()}) {
+      struct epoll_event ee;
+      ee.events = EPOLLIN | EPOLLET;
+      ee.data.fd = fd;
+      if (r == 0) {
+        r = ::epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ee);
+      }
+    }
+  } else {
+    r = -1;
+  }
+  if (r < 0) {
+    r = -errno;
+    ldout(cct, 1) << __func__ << " unable to listen on " << path << ": "
+                  << cpp_strerror(r) << ", peers on this host connect to "
+                  << sa << " over TCP" << dendl;
+    if (unix_sd >= 0) {
+      ::close(unix_sd);
+    }
+    if (epfd >= 0) {
+      ::close(epfd);
+    }
+    *sock = std::move(tcp);
+    return 0;
+  }
+
+  ldout(cct, 10) << __func__ << " peers on this host connect to " << sa
+                 << " through " << path << dendl;
+  *sock = ServerSocket(
+    std::make_unique<ShmServerSocketImpl>(std::move(tcp), sa, addr_slot, path,
+                                          unix_sd, epfd));
+  return 0;
+}
+
+int ShmWorker::connect_local(const entity_addr_t &addr,
+                             const SocketOptions &opts,
+                             ConnectedSocket *socket)
+{
+  const auto path = get_path(addr);
+  struct sockaddr_un un;
+  memset(&un, 0, sizeof(un));
+  un.sun_family = AF_UNIX;
+  if (path.empty() || path.size() >= sizeof(un.sun_path)) {
+    return -ENOENT;
+  }
+  path.copy(un.sun_path, path.size());
+
+  // the listener sees us at its IP, being on its host, and at a port of
+  // our own, held for as long as the connection is
+  entity_addr_t local_addr = addr;
+  local_addr.set_port(0);
+  local_addr.set_nonce(0);
+  int port_sd = ::socket(addr.get_family(), SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (port_sd < 0) {
+    return -errno;
+  }
+  struct sockaddr_storage ss;
+  socklen_t sslen = sizeof(ss);
+  if (::bind(port_sd, local_addr.get_sockaddr(),
+             local_addr.get_sockaddr_len()) < 0 ||
+      ::getsockname(port_sd, (struct sockaddr*)&ss, &sslen) < 0) {
+    int r = -errno;
+    ::close(port_sd);
+    return r;
+  }
+  local_addr.set_sockaddr((struct sockaddr*)&ss);
+
+  int sd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (sd < 0) {
+    int r = -errno;
+    ::close(port_sd);
+    return r;
+  }
+  struct sockaddr_un local_un;
+  memset(&local_un, 0, sizeof(local_un));
+  local_un.sun_family = AF_UNIX;
+  const auto name = std::string(SHM_PEER_PREFIX) + stringify(local_addr);
+  if (name.size() + 1 >= sizeof(local_un.sun_path)) {
+    ::close(sd);
+    ::close(port_sd);
+    return -ENAMETOOLONG;
+  }
+  // an abstract name, the first byte of it stays 0
+  name.copy(local_un.sun_path + 1, name.size());
+  if (::bind(sd, (struct sockaddr*)&local_un,
+             offsetof(struct sockaddr_un, sun_path) + 1 + name.size()) < 0 ||
+      ::connect(sd, (struct sockaddr*)&un, sizeof(un)) < 0) {
+    // nobody listens there on this host, or nobody anymore
+    int r = -errno;
+    ::close(sd);
+    ::close(port_sd);
+    return r;
+  }
+
+  auto csi = std::make_unique<ShmConnectedSocketImpl>(this, sd, port_sd);
+  uint64_t ring_size = std::clamp<uint64_t>(
+    std::bit_ceil<uint64_t>(
+      cct->_conf.get_val<Option::size_t>("ms_async_shm_ring_size")),
+    SHM_MIN_RING_SIZE, SHM_MAX_RING_SIZE);
+  if (int r = csi->start_connect(ring_size); r < 0) {
+    ldout(cct, 1) << __func__ << " unable to share memory with " << addr
+                  << " through " << path << ": " << cpp_strerror(r) << dendl;
+    return r;
+  }
+  ldout(cct, 10) << __func__ << " connected to " << addr << " through "
+                 << path << dendl;
+  *socket = ConnectedSocket(std::move(csi));
+  return 0;
+}
+
+int ShmWorker::connect(const entity_addr_t &addr, const SocketOptions &opts,
+                       ConnectedSocket *socket)
+{
+  if (connect_local(addr, opts, socket) == 0) {
+    return 0;
+  }
+  return PosixWorker::connect(addr, opts, socket);
+}
@@ -0,0 +1,60 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:nil -*-
+// vim: ts=8 sw=2 sts=2 expandtab
+
+/*
+ * Ceph - scalable distributed file system
+ *
+ * This is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License version 2.1, as published by the Free Software
+ * Foundation.  See file COPYING.
+ *
+ */
+
+#ifndef CEPH_MSG_ASYNC_SHMSTACK_H
+#define CEPH_MSG_ASYNC_SHMSTACK_H
+
+#include <string>
+
+#include "PosixStack.h"
+
+/*
+ * TCP for remote peers and shared memory for the peers on the same host.
+ *
+ * Besides its TCP socket, a listener listens on a unix socket named after
+ * its address in ms_async_shm_dir. A connector that finds the unix socket
+ * of the address it connects to is on the same host as the listener, and
+ * sends it a sealed memfd holding a ring for each direction of the
+ * connection instead of connecting over TCP. The connector's unix socket is
+ * bound to an abstract name holding its address, with a port it reserves.
+ * The unix socket stays around to tell the peer there is something to read
+ * and when the other side is gone.
+ */
+class ShmWorker : public PosixWorker {
+  int connect_local(const entity_addr_t &addr, const SocketOptions &opts,
+                    ConnectedSocket *socket);
+
+ public:
+  ShmWorker(CephContext *c, unsigned i)
+    : PosixWorker(c, i) {}
+  int listen(entity_addr_t &sa,
+             unsigned addr_slot,
+             const SocketOptions &opt,
+             ServerSocket *socks) override;
+  int connect(const entity_addr_t &addr, const SocketOptions &opts, ConnectedSocket *socket) override;
+
+  // the unix socket of the listener on addr, empty if there is none
+  std::string get_path(const entity_addr_t &addr) const;
+};
+
+class ShmStack : public PosixNetworkStack {
+  Worker* create_worker(CephContext *c, unsigned worker_id) override {
+    return new ShmWorker(c, worker_id);
+  }
+
+ public:
+  explicit ShmStack(CephContext *c)
+    : PosixNetworkStack(c) {}
+};
+
+#endif //CEPH_MSG_ASYNC_SHMSTACK_H
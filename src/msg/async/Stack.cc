@@ -20,6 +20,12 @@
 #include "common/Cond.h"
 #include "common/errno.h"
 #include "PosixStack.h"
+#ifdef __linux__
+#include "ShmStack.h"
+#endif
+#ifdef HAVE_LIBURING
+#include "IoUringStack.h"
+#endif
 #ifdef HAVE_RDMA
 #include "rdma/RDMAStack.h"
 #endif
@@ -67,6 +73,21 @@ std::shared_ptr<NetworkStack> NetworkStack::create(CephContext *c,
 
   if (t == "posix")
     stack.reset(new PosixNetworkStack(c));
+#ifdef __linux__
+  else if (t == "shm")
+    stack.reset(new ShmStack(c));
+#endif
+#ifdef HAVE_LIBURING
+  else if (t == "io_uring") {
+    if (IoUringStack::is_supported(c)) {
+      stack.reset(new IoUringStack(c));
+    } else {
+      lderr(c) << __func__ << " io_uring is not supported by this kernel,"
+               << " falling back to posix" << dendl;
+      stack.reset(new PosixNetworkStack(c));
+    }
+  }
+#endif
 #ifdef HAVE_RDMA
   else if (t == "rdma")
     stack.reset(new RDMAStack(c));
@@ -22,6 +22,7 @@
 #include "common/perf_counters_key.h"
 #include "include/spinlock.h"
 #include "msg/async/Event.h"
+#include "msg/async/RxBufferPool.h"
 #include "msg/msg_types.h"
 
 #ifdef WITH_CRIMSON
@@ -225,6 +226,14 @@ enum {
   l_msgr_recv_encrypted_bytes,
   l_msgr_send_encrypted_bytes,
 
+  l_msgr_send_zerocopy_bytes,
+  l_msgr_send_zerocopy_copied,
+
+  l_msgr_send_batch_frames,
+
+  l_msgr_rx_buffer_pool_hits,
+  l_msgr_rx_buffer_pool_misses,
+
   l_msgr_last,
 };
 
@@ -252,6 +261,8 @@ class Worker {
 
   std::atomic_uint references;
   EventCenter center;
+  // for the data segments received, if enabled
+  std::shared_ptr<RxBufferPool> rx_buffer_pool;
 
   Worker(const Worker&) = delete;
   Worker& operator=(const Worker&) = delete;
@@ -283,6 +294,14 @@ class Worker {
     plb.add_u64_counter(l_msgr_recv_encrypted_bytes, "msgr_recv_encrypted_bytes", "Network received encrypted bytes", NULL, 0, unit_t(UNIT_BYTES));
     plb.add_u64_counter(l_msgr_send_encrypted_bytes, "msgr_send_encrypted_bytes", "Network sent encrypted bytes", NULL, 0, unit_t(UNIT_BYTES));
 
+    plb.add_u64_counter(l_msgr_send_zerocopy_bytes, "msgr_send_zerocopy_bytes", "Network sent bytes with MSG_ZEROCOPY", NULL, 0, unit_t(UNIT_BYTES));
+    plb.add_u64_counter(l_msgr_send_zerocopy_copied, "msgr_send_zerocopy_copied", "MSG_ZEROCOPY sends the kernel copied anyway");
+
+    plb.add_u64_avg(l_msgr_send_batch_frames, "msgr_send_batch_frames", "Frames handed to the socket at once");
+
+    plb.add_u64_counter(l_msgr_rx_buffer_pool_hits, "msgr_rx_buffer_pool_hits", "Received data segments in a reused buffer");
+    plb.add_u64_counter(l_msgr_rx_buffer_pool_misses, "msgr_rx_buffer_pool_misses", "Received data segments in a newly allocated pool buffer");
+
     perf_logger = plb.create_perf_counters();
     cct->get_perfcounters_collection()->add(perf_logger);
 
@@ -304,8 +323,15 @@ class Worker {
 
     perf_labeled_logger = plb_labeled.create_perf_counters();
     cct->get_perfcounters_collection()->add(perf_labeled_logger);
+
+    if (cct->_conf.get_val<Option::size_t>("ms_async_rx_buffer_pool_size")) {
+      rx_buffer_pool = std::make_shared<RxBufferPool>(cct, perf_logger);
+    }
   }
   virtual ~Worker() {
+    if (rx_buffer_pool) {
+      rx_buffer_pool->shutdown();
+    }
     if (perf_logger) {
       cct->get_perfcounters_collection()->remove(perf_logger);
       delete perf_logger;
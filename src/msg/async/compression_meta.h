@@ -8,6 +8,7 @@ struct CompConnectionMeta {
     TOPNSPC::Compressor::COMP_NONE;  // negotiated mode
   TOPNSPC::Compressor::CompressionAlgorithm con_method =
     TOPNSPC::Compressor::COMP_ALG_NONE; // negotiated method
+  uint32_t con_zstd_dict_id = 0; // negotiated zstd dictionary, 0 for none
 
   bool is_compress() const {
     return con_mode != TOPNSPC::Compressor::COMP_NONE;
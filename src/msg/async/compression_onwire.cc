@@ -26,8 +26,35 @@ rxtx_t rxtx_t::create_handler_pair(
   return {};
 }
 
+rxtx_t rxtx_t::create_handler_pair(
+    CephContext* ctx,
+    const CompConnectionMeta& comp_meta,
+    CompressorRegistry& registry,
+    uint32_t peer_type)
+{
+  if (comp_meta.is_compress()) {
+    CompressorRef compressor = registry.create_compressor(
+      comp_meta.get_method(), comp_meta.con_zstd_dict_id);
+    if (compressor) {
+      return {std::make_unique<RxHandler>(ctx, compressor),
+	      std::make_unique<TxHandler>(ctx, compressor,
+					  comp_meta.get_mode(),
+					  registry.get_min_compression_size(peer_type),
+					  registry.get_msg_types(peer_type))};
+    }
+  }
+  return {};
+}
+
 std::optional<ceph::bufferlist> TxHandler::compress(const ceph::bufferlist &input)
 {
+  if (!m_selected) {
+    ldout(m_cct, 20) << __func__
+		     << " discovered a message type not to compress, aborting compression"
+		     << dendl;
+    return {};
+  }
+
   if (m_init_onwire_size < m_min_size) {
     ldout(m_cct, 20) << __func__ 
 		     << " discovered frame that is smaller than threshold, aborting compression"
@@ -5,10 +5,12 @@
 #define CEPH_COMPRESSION_ONWIRE_H
 
 #include <cstdint>
+#include <memory>
 #include <optional>
 
 #include "compressor/Compressor.h"
 #include "include/buffer.h"
+#include "msg/compressor_registry.h"
 
 class CompConnectionMeta;
 
@@ -47,10 +49,12 @@ namespace ceph::compression::onwire {
 
   class TxHandler final : private Handler {
   public:
-    TxHandler(CephContext* const cct, CompressorRef compressor, int mode, std::uint64_t min_size)
+    TxHandler(CephContext* const cct, CompressorRef compressor, int mode, std::uint64_t min_size,
+	      std::shared_ptr<const MsgTypeSet> msg_types = {})
       : Handler(cct, compressor),
 	m_min_size(min_size),
-	m_mode(static_cast<Compressor::CompressionMode>(mode))
+	m_mode(static_cast<Compressor::CompressionMode>(mode)),
+	m_msg_types(std::move(msg_types))
     {}
     ~TxHandler() {}
 
@@ -58,6 +62,18 @@ namespace ceph::compression::onwire {
       m_init_onwire_size = size;
       m_compress_potential = size;
       m_onwire_size = 0;
+      // frames not carrying a message are compressed unless only some
+      // message types are
+      m_selected = m_next_selected.value_or(!m_msg_types);
+      m_next_selected.reset();
+    }
+
+    /**
+     * Tells the type of the message in the next frame, which is sent
+     * as is if it is not among the message types to compress.
+     */
+    void set_msg_type(int type, std::string_view name) {
+      m_next_selected = !m_msg_types || m_msg_types->contains(type, name);
     }
 
     void done();
@@ -93,6 +109,10 @@ namespace ceph::compression::onwire {
     uint64_t m_init_onwire_size;
     uint64_t m_onwire_size;
     uint64_t m_compress_potential;
+
+    std::shared_ptr<const MsgTypeSet> m_msg_types;
+    std::optional<bool> m_next_selected;
+    bool m_selected = true;
   };
 
   struct rxtx_t {
@@ -103,6 +123,13 @@ namespace ceph::compression::onwire {
       CephContext* ctx,
       const CompConnectionMeta& comp_meta,
       std::uint64_t compress_min_size);
+
+    // with the compressor and the policy the registry has for peer_type
+    static rxtx_t create_handler_pair(
+      CephContext* ctx,
+      const CompConnectionMeta& comp_meta,
+      CompressorRegistry& registry,
+      uint32_t peer_type);
   };
 }
 
@@ -5,10 +5,12 @@
 #include "common/debug.h"
 #include "common/ceph_crypto.h"
 #include "include/buffer.h"
+#include "include/intarith.h"
 #include "include/types.h"
 
 #include <openssl/evp.h>
 
+#include <algorithm>
 #include <array>
 #include <numeric> // for std::accumulate()
 
@@ -40,12 +42,28 @@ using key_t = std::array<std::uint8_t, AESGCM_KEY_LEN>;
 class AES128GCM_OnWireTxHandler : public ceph::crypto::onwire::TxHandler {
   CephContext* const cct;
   std::unique_ptr<EVP_CIPHER_CTX, decltype(&::EVP_CIPHER_CTX_free)> ectx;
-  ceph::bufferlist buffer;
   nonce_t nonce, initial_nonce;
   bool used_initial_nonce;
   bool new_nonce_format;  // 64-bit counter?
   static_assert(sizeof(nonce) == AESGCM_IV_LEN);
 
+  // plaintext buffers shorter than this are copied to the output and
+  // encrypted there together in a single pass
+  const uint64_t coalesce_max;
+  // the output of the frames is carved out of buffers of this size
+  const uint64_t chunk_size;
+  // the part of the current chunk no frame has used yet
+  ceph::bufferptr chunk;
+  // the output of the current frame, filled up to out_len
+  ceph::bufferptr out;
+  uint32_t out_len = 0;
+  // the plaintext copied to the end of the output but not encrypted yet
+  uint32_t run_len = 0;
+
+  void get_output(uint32_t len);
+  void encrypt(const char* in, char* out, uint32_t len);
+  void encrypt_run();
+
 public:
   AES128GCM_OnWireTxHandler(CephContext* const cct,
 			    const key_t& key,
@@ -54,7 +72,11 @@ public:
     : cct(cct),
       ectx(EVP_CIPHER_CTX_new(), EVP_CIPHER_CTX_free),
       nonce(nonce), initial_nonce(nonce), used_initial_nonce(false),
-      new_nonce_format(new_nonce_format) {
+      new_nonce_format(new_nonce_format),
+      coalesce_max(cct->_conf.get_val<Option::size_t>(
+        "ms_crypto_tx_coalesce_max")),
+      chunk_size(cct->_conf.get_val<Option::size_t>(
+        "ms_crypto_tx_buffer_size")) {
     ceph_assert_always(ectx);
     ceph_assert_always(key.size() * CHAR_BIT == 128);
 
@@ -84,6 +106,48 @@ public:
   };
 };
 
+void AES128GCM_OnWireTxHandler::get_output(const uint32_t len)
+{
+  if (len > chunk_size) {
+    out = ceph::buffer::create_page_aligned(len);
+    return;
+  }
+  if (chunk.length() < len) {
+    chunk = ceph::buffer::create_page_aligned(chunk_size);
+  }
+  out = ceph::bufferptr(chunk, 0, len);
+  // the next frame starts on a cache line of its own
+  const uint32_t used = std::min<uint32_t>(p2roundup<uint32_t>(len, 64),
+                                           chunk.length());
+  chunk = ceph::bufferptr(chunk, used, chunk.length() - used);
+}
+
+void AES128GCM_OnWireTxHandler::encrypt(const char* const in,
+                                        char* const out,
+                                        const uint32_t len)
+{
+  int update_len = 0;
+
+  if(1 != EVP_EncryptUpdate(ectx.get(),
+      reinterpret_cast<unsigned char*>(out),
+      &update_len,
+      reinterpret_cast<const unsigned char*>(in),
+      len)) {
+    throw std::runtime_error("EVP_EncryptUpdate failed");
+  }
+  ceph_assert_always(update_len >= 0);
+  ceph_assert(static_cast<unsigned>(update_len) == len);
+}
+
+void AES128GCM_OnWireTxHandler::encrypt_run()
+{
+  if (run_len > 0) {
+    char* const run = out.c_str() + out_len - run_len;
+    encrypt(run, run, run_len);
+    run_len = 0;
+  }
+}
+
 void AES128GCM_OnWireTxHandler::reset_tx_handler(const uint32_t* first,
                                                  const uint32_t* last)
 {
@@ -99,8 +163,10 @@ void AES128GCM_OnWireTxHandler::reset_tx_handler(const uint32_t* first,
     throw std::runtime_error("EVP_EncryptInit_ex failed");
   }
 
-  ceph_assert(buffer.get_append_buffer_unused_tail_length() == 0);
-  buffer.reserve(std::accumulate(first, last, AESGCM_TAG_LEN));
+  ceph_assert(out.length() == 0);
+  get_output(std::accumulate(first, last, AESGCM_TAG_LEN));
+  out_len = 0;
+  run_len = 0;
 
   if (!new_nonce_format) {
     // msgr2.0: 32-bit counter followed by 64-bit fixed field,
@@ -114,39 +180,41 @@ void AES128GCM_OnWireTxHandler::reset_tx_handler(const uint32_t* first,
 void AES128GCM_OnWireTxHandler::authenticated_encrypt_update(
   const ceph::bufferlist& plaintext)
 {
-  ceph_assert(buffer.get_append_buffer_unused_tail_length() >=
-              plaintext.length());
-  auto filler = buffer.append_hole(plaintext.length());
+  ceph_assert(out.length() - out_len >= plaintext.length() + AESGCM_TAG_LEN);
 
+  // Copying small buffers costs less than an EVP_EncryptUpdate() for each
+  // of them, and the whole run (the preamble, the headers and the small
+  // segments of a frame) is then encrypted in place in one go. Large ones
+  // are encrypted straight from the plaintext.
   for (const auto& plainbuf : plaintext.buffers()) {
-    int update_len = 0;
-
-    if(1 != EVP_EncryptUpdate(ectx.get(),
-	reinterpret_cast<unsigned char*>(filler.c_str()),
-	&update_len,
-	reinterpret_cast<const unsigned char*>(plainbuf.c_str()),
-	plainbuf.length())) {
-      throw std::runtime_error("EVP_EncryptUpdate failed");
+    const uint32_t len = plainbuf.length();
+    char* const dst = out.c_str() + out_len;
+    if (len < coalesce_max) {
+      memcpy(dst, plainbuf.c_str(), len);
+      run_len += len;
+    } else {
+      encrypt_run();
+      encrypt(plainbuf.c_str(), dst, len);
     }
-    ceph_assert_always(update_len >= 0);
-    ceph_assert(static_cast<unsigned>(update_len) == plainbuf.length());
-    filler.advance(update_len);
+    out_len += len;
   }
 
   ldout(cct, 15) << __func__
 		 << " plaintext.length()=" << plaintext.length()
-		 << " buffer.length()=" << buffer.length()
+		 << " buffer.length()=" << out_len
+		 << " run_len=" << run_len
 		 << dendl;
 }
 
 ceph::bufferlist AES128GCM_OnWireTxHandler::authenticated_encrypt_final()
 {
+  encrypt_run();
+
   int final_len = 0;
-  ceph_assert(buffer.get_append_buffer_unused_tail_length() ==
-              AESGCM_BLOCK_LEN);
-  auto filler = buffer.append_hole(AESGCM_BLOCK_LEN);
+  ceph_assert(out.length() - out_len == AESGCM_BLOCK_LEN);
+  char* const filler = out.c_str() + out_len;
   if(1 != EVP_EncryptFinal_ex(ectx.get(),
-	reinterpret_cast<unsigned char*>(filler.c_str()),
+	reinterpret_cast<unsigned char*>(filler),
 	&final_len)) {
     throw std::runtime_error("EVP_EncryptFinal_ex failed");
   }
@@ -155,15 +223,18 @@ ceph::bufferlist AES128GCM_OnWireTxHandler::authenticated_encrypt_final()
   static_assert(AESGCM_BLOCK_LEN == AESGCM_TAG_LEN);
   if(1 != EVP_CIPHER_CTX_ctrl(ectx.get(),
 	EVP_CTRL_GCM_GET_TAG, AESGCM_TAG_LEN,
-	filler.c_str())) {
+	filler)) {
     throw std::runtime_error("EVP_CIPHER_CTX_ctrl failed");
   }
 
   ldout(cct, 15) << __func__
-		 << " buffer.length()=" << buffer.length()
+		 << " buffer.length()=" << out.length()
 		 << " final_len=" << final_len
 		 << dendl;
-  return std::move(buffer);
+  ceph::bufferlist buffer;
+  buffer.append(std::move(out));
+  out = ceph::bufferptr();
+  return buffer;
 }
 
 // RX PART
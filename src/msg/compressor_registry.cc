@@ -2,7 +2,11 @@
 // vim: ts=8 sw=2 sts=2 expandtab
 
 #include "compressor_registry.h"
+
+#include <charconv>
+
 #include "common/dout.h"
+#include "common/errno.h"
 #include "include/types.h" // for operator<<(std::vector)
 
 using namespace std::literals;
@@ -28,6 +32,8 @@ std::vector<std::string> CompressorRegistry::get_tracked_keys() const noexcept
     "ms_osd_compress_mode"s,
     "ms_osd_compression_algorithm"s,
     "ms_osd_compress_min_size"s,
+    "ms_osd_compress_msg_types"s,
+    "ms_compress_zstd_dictionary"s,
     "ms_compress_secure"s
   };
 }
@@ -40,6 +46,27 @@ void CompressorRegistry::handle_conf_change(
   _refresh_config();
 }
 
+MsgTypeSet MsgTypeSet::parse(std::string_view s,
+                              std::vector<std::string>* invalid)
+{
+  MsgTypeSet set;
+  for_each_substr(s, ";, \t", [&] (auto t) {
+    if (t.find_first_not_of("0123456789") != std::string_view::npos) {
+      set.names.emplace(t);
+      return;
+    }
+    // the type of a message is 16 bits on the wire
+    uint16_t type;
+    if (auto [p, ec] = std::from_chars(t.data(), t.data() + t.size(), type);
+        ec == std::errc{} && p == t.data() + t.size()) {
+      set.types.insert(type);
+    } else if (invalid) {
+      invalid->emplace_back(t);
+    }
+  });
+  return set;
+}
+
 std::vector<uint32_t> CompressorRegistry::_parse_method_list(const std::string& s)
 {
   std::vector<uint32_t> methods;
@@ -81,30 +108,149 @@ void CompressorRegistry::_refresh_config()
 
   ms_compress_secure = cct->_conf.get_val<bool>("ms_compress_secure");
 
+  std::vector<std::string> invalid_types;
+  auto types = MsgTypeSet::parse(
+    cct->_conf.get_val<std::string>("ms_osd_compress_msg_types"),
+    &invalid_types);
+  for (const auto& t : invalid_types) {
+    ldout(cct,1) << __func__ << " WARNING: invalid message type " << t
+                 << " in ms_osd_compress_msg_types" << dendl;
+  }
+  if (types.empty()) {
+    ms_osd_compress_msg_types.reset();
+  } else {
+    ms_osd_compress_msg_types =
+      std::make_shared<const MsgTypeSet>(std::move(types));
+  }
+
+  if (auto path = cct->_conf.get_val<std::string>("ms_compress_zstd_dictionary");
+      path != zstd_dictionary_path) {
+    zstd_dictionary_path = path;
+    _load_zstd_dictionary();
+  }
+
   ldout(cct,10) << __func__ << " ms_osd_compression_mode " << ms_osd_compress_mode
     << " ms_osd_compression_methods " << ms_osd_compression_methods
     << " ms_osd_compress_above_min_size " << ms_osd_compress_min_size
     << " ms_compress_secure " << ms_compress_secure
+    << " ms_osd_compress_msg_types "
+    << cct->_conf.get_val<std::string>("ms_osd_compress_msg_types")
     << dendl;
 }
 
+void CompressorRegistry::_load_zstd_dictionary()
+{
+  zstd_dictionary_compressor.reset();
+  if (zstd_dictionary_path.empty()) {
+    return;
+  }
+
+  ceph::bufferlist dict;
+  std::string error;
+  if (int r = dict.read_file(zstd_dictionary_path.c_str(), &error); r < 0) {
+    lderr(cct) << __func__ << " unable to read " << zstd_dictionary_path
+	       << ": " << error << dendl;
+    return;
+  }
+  auto compressor = Compressor::create(cct, Compressor::COMP_ALG_ZSTD);
+  if (!compressor) {
+    lderr(cct) << __func__ << " zstd is not available" << dendl;
+    return;
+  }
+  if (int r = compressor->set_dictionary(dict); r < 0) {
+    lderr(cct) << __func__ << " unable to use " << zstd_dictionary_path
+	       << " as a zstd dictionary: " << cpp_strerror(r) << dendl;
+    return;
+  }
+  if (compressor->get_dictionary_id() < ZSTD_DICT_MIN_ID) {
+    lderr(cct) << __func__ << " unable to use " << zstd_dictionary_path
+	       << " as a zstd dictionary: its id "
+	       << compressor->get_dictionary_id() << " is below "
+	       << ZSTD_DICT_MIN_ID << dendl;
+    return;
+  }
+  ldout(cct, 1) << __func__ << " using " << zstd_dictionary_path
+		<< " with id " << compressor->get_dictionary_id()
+		<< " for zstd" << dendl;
+  zstd_dictionary_compressor = std::move(compressor);
+}
+
+TOPNSPC::CompressorRef
+CompressorRegistry::create_compressor(Compressor::CompressionAlgorithm method,
+                                      uint32_t zstd_dict_id)
+{
+  if (zstd_dict_id) {
+    std::scoped_lock l(lock);
+    if (method != Compressor::COMP_ALG_ZSTD ||
+        !zstd_dictionary_compressor ||
+        zstd_dictionary_compressor->get_dictionary_id() != zstd_dict_id) {
+      ldout(cct,1) << __func__ << " zstd dictionary " << zstd_dict_id
+                   << " is gone" << dendl;
+      return {};
+    }
+    return zstd_dictionary_compressor;
+  }
+  return Compressor::create(cct, method);
+}
+
+std::vector<uint32_t>
+CompressorRegistry::get_request_methods(uint32_t peer_type)
+{
+  std::vector<uint32_t> methods = get_methods(peer_type);
+  std::scoped_lock l(lock);
+  if (zstd_dictionary_compressor &&
+      std::find(methods.begin(), methods.end(),
+                Compressor::COMP_ALG_ZSTD) != methods.end()) {
+    methods.push_back(ZSTD_DICT_METHOD);
+    methods.push_back(zstd_dictionary_compressor->get_dictionary_id());
+  }
+  return methods;
+}
+
 Compressor::CompressionAlgorithm
 CompressorRegistry::pick_method(uint32_t peer_type,
-                                const std::vector<uint32_t>& preferred_methods)
+                                const std::vector<uint32_t>& preferred_methods,
+                                uint32_t *zstd_dict_id)
 {
+  std::vector<uint32_t> methods = preferred_methods;
+  uint32_t peer_dict_id = 0;
+  if (auto p = std::find(methods.begin(), methods.end(), ZSTD_DICT_METHOD);
+      p != methods.end()) {
+    if (std::next(p) != methods.end()) {
+      peer_dict_id = *std::next(p);
+    }
+    methods.erase(p, methods.end());
+  }
+  if (zstd_dict_id) {
+    *zstd_dict_id = 0;
+  }
+
   std::vector<uint32_t> allowed_methods = get_methods(peer_type);
-  auto preferred = std::find_first_of(preferred_methods.begin(),
-                                      preferred_methods.end(),
+  auto preferred = std::find_first_of(methods.begin(),
+                                      methods.end(),
                                       allowed_methods.begin(),
                                       allowed_methods.end());
-  if (preferred == preferred_methods.end()) {
+  if (preferred == methods.end()) {
     ldout(cct,1) << "failed to pick compression method from client's "
                  << preferred_methods
                  << " and our " << allowed_methods << dendl;
     return Compressor::COMP_ALG_NONE;
-  } else {
-    return static_cast<Compressor::CompressionAlgorithm>(*preferred);
   }
+
+  auto method = static_cast<Compressor::CompressionAlgorithm>(*preferred);
+  if (method == Compressor::COMP_ALG_ZSTD && peer_dict_id && zstd_dict_id) {
+    std::scoped_lock l(lock);
+    const uint32_t our_dict_id = zstd_dictionary_compressor ?
+      zstd_dictionary_compressor->get_dictionary_id() : 0;
+    if (our_dict_id == peer_dict_id) {
+      *zstd_dict_id = peer_dict_id;
+    } else {
+      ldout(cct,1) << "client's zstd dictionary " << peer_dict_id
+                   << " is not ours (" << our_dict_id
+                   << "), compressing without one" << dendl;
+    }
+  }
+  return method;
 }
 
 Compressor::CompressionMode
@@ -4,7 +4,11 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <mutex> // for std::scoped_lock
+#include <set>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include "compressor/Compressor.h"
@@ -15,6 +19,26 @@
 #include "include/common_fwd.h" // for CephContext
 #include "include/msgr.h" // for CEPH_ENTITY_TYPE_OSD
 
+// Message types picked by number or by the name Message::get_type_name()
+// gives them.
+class MsgTypeSet {
+  std::set<int> types;
+  std::set<std::string, std::less<>> names;
+
+public:
+  /// entries that are neither a name nor a message type number are
+  /// skipped, and added to \p invalid if given
+  static MsgTypeSet parse(std::string_view s,
+                          std::vector<std::string>* invalid = nullptr);
+
+  bool empty() const {
+    return types.empty() && names.empty();
+  }
+  bool contains(int type, std::string_view name) const {
+    return types.count(type) || names.find(name) != names.end();
+  }
+};
+
 class CompressorRegistry : public md_config_obs_t {
 public:
   CompressorRegistry(CephContext *cct);
@@ -29,8 +53,25 @@ public:
   void handle_conf_change(const ConfigProxy& conf,
                           const std::set<std::string>& changed) override;
 
+  // Appended to the preferred methods of a compression request, followed by
+  // the id of the zstd dictionary of the client, and sent back as the method
+  // by a server that compresses zstd with the same dictionary. Peers unaware
+  // of it skip both values, as neither is a compression method.
+  static constexpr uint32_t ZSTD_DICT_METHOD = 0x7a640000;
+  // the zstd dictionaries accepted have ids at least this large, so that
+  // the id cannot be mistaken for a compression method
+  static constexpr uint32_t ZSTD_DICT_MIN_ID = 32768;
+
+  // the preferred methods to request for peer_type, with the zstd
+  // dictionary offered if zstd is among them
+  std::vector<uint32_t> get_request_methods(uint32_t peer_type);
+
+  // the method to use out of the ones the client prefers, and in
+  // *zstd_dict_id the id of the dictionary it offered if it is zstd and
+  // the dictionary is ours, 0 otherwise
   TOPNSPC::Compressor::CompressionAlgorithm pick_method(uint32_t peer_type,
-					       const std::vector<uint32_t>& preferred_methods);
+					       const std::vector<uint32_t>& preferred_methods,
+					       uint32_t *zstd_dict_id = nullptr);
 
   TOPNSPC::Compressor::CompressionMode get_mode(uint32_t peer_type, bool is_secure);
 
@@ -54,6 +95,24 @@ public:
     }
   }
 
+  // the message types to compress for peer_type, null for all of them
+  std::shared_ptr<const MsgTypeSet> get_msg_types(uint32_t peer_type) const {
+    std::scoped_lock l(lock);
+    switch (peer_type) {
+      case CEPH_ENTITY_TYPE_OSD:
+        return ms_osd_compress_msg_types;
+      default:
+        return {};
+    }
+  }
+
+  // the compressor of a new connection using method, with the zstd
+  // dictionary negotiated if zstd_dict_id isn't 0; null if that dictionary
+  // is no longer ours
+  TOPNSPC::CompressorRef create_compressor(
+    TOPNSPC::Compressor::CompressionAlgorithm method,
+    uint32_t zstd_dict_id = 0);
+
   bool get_is_compress_secure() const { 
     std::scoped_lock l(lock);
     return ms_compress_secure; 
@@ -67,6 +126,14 @@ private:
   bool ms_compress_secure;
   std::uint64_t ms_osd_compress_min_size;
   std::vector<uint32_t> ms_osd_compression_methods;
+  std::shared_ptr<const MsgTypeSet> ms_osd_compress_msg_types;
+
+  std::string zstd_dictionary_path;
+  // shared by all the connections using zstd with the dictionary, so that
+  // it is only digested once
+  TOPNSPC::CompressorRef zstd_dictionary_compressor;
+
+  void _load_zstd_dictionary();
 
   void _refresh_config();
   std::vector<uint32_t> _parse_method_list(const std::string& s);
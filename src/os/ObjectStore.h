@@ -45,6 +45,10 @@ namespace ceph {
   class Formatter;
 }
 
+namespace PriorityCache {
+  struct PriCache;
+}
+
 /*
  * low-level interface to the local OSD file system
  */
@@ -289,6 +293,15 @@ public:
 
   virtual void set_cache_shards(unsigned num) { }
 
+  /**
+   * Let a cache outside of the store compete for the memory the store
+   * balances between its own caches.  Stores that do not autotune their
+   * caches ignore it.
+   */
+  virtual void add_pri_cache(const std::string& name,
+                             std::shared_ptr<PriorityCache::PriCache> cache) { }
+  virtual void remove_pri_cache(const std::string& name) { }
+
   /**
    * Returns 0 if the hobject is valid, -error otherwise
    *
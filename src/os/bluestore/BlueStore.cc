@@ -5495,6 +5495,9 @@ void *BlueStore::MempoolThread::entry()
     if (binned_kv_onode_cache != nullptr) {
       pcm->insert("kv_onode", binned_kv_onode_cache, true);
     }
+    for (auto& [name, cache] : other_caches) {
+      pcm->insert(name, cache, true);
+    }
   }
 
   utime_t next_balance = ceph_clock_now();
@@ -6338,6 +6341,9 @@ void BlueStore::_init_logger()
   b.add_u64_counter(l_bluestore_reads_with_retries, "reads_with_retries",
                     "Read operations that required at least one retry due to failed checksum validation",
 		    "rd_r", PerfCountersBuilder::PRIO_USEFUL);
+  b.add_u64_counter(l_bluestore_csum_reused_bytes, "csum_reused_bytes",
+                    "Bytes read whose crc32c was derived from verified blob checksums",
+                    NULL, 0, unit_t(UNIT_BYTES));
   b.add_time_avg(l_bluestore_read_lat, "read_lat",
 		 "Average read latency",
 		 "r_l", PerfCountersBuilder::PRIO_CRITICAL);
@@ -9250,6 +9256,28 @@ void BlueStore::set_cache_shards(unsigned num)
   }
 }
 
+void BlueStore::add_pri_cache(const std::string& name,
+                              std::shared_ptr<PriorityCache::PriCache> cache)
+{
+  dout(10) << __func__ << " " << name << dendl;
+  std::lock_guard l{mempool_thread.lock};
+  ceph_assert(!mempool_thread.other_caches.contains(name));
+  mempool_thread.other_caches.emplace(name, cache);
+  if (mempool_thread.pcm != nullptr) {
+    mempool_thread.pcm->insert(name, cache, true);
+  }
+}
+
+void BlueStore::remove_pri_cache(const std::string& name)
+{
+  dout(10) << __func__ << " " << name << dendl;
+  std::lock_guard l{mempool_thread.lock};
+  if (mempool_thread.other_caches.erase(name) &&
+      mempool_thread.pcm != nullptr) {
+    mempool_thread.pcm->erase(name);
+  }
+}
+
 //---------------------------------------------
 bool BlueStore::has_null_manager() const
 {
@@ -12794,6 +12822,7 @@ int BlueStore::_generate_read_result_bl(
   vector<bufferlist>& compressed_blob_bls,
   blobs2read_t& blobs2read,
   bool buffered,
+  bool reuse_csum,
   bool* csum_error,
   bufferlist& bl)
 {
@@ -12846,7 +12875,17 @@ int BlueStore::_generate_read_result_bl(
             // need offset before padding
             o->bc.did_read(o->c->cache, r.logical_offset, std::move(region_buffer));
           }
-          ready_regions[r.logical_offset].substr_of(req.bl, r.front, r.length);
+          bufferlist& region = ready_regions[r.logical_offset];
+          region.substr_of(req.bl, r.front, r.length);
+          uint32_t crc;
+          if (reuse_csum &&
+              bptr->get_blob().get_crc32c_from_csum(
+                req.r_off + r.front, r.length, &crc)) {
+            // the data was just verified against these csums, so the
+            // caller's crc32c() of it needn't hash it again
+            region.set_crc32c(-1, crc);
+            logger->inc(l_bluestore_csum_reused_bytes, r.length);
+          }
         }
       }
     }
@@ -12884,6 +12923,15 @@ int BlueStore::_generate_read_result_bl(
   return 0;
 }
 
+bool BlueStore::_reuse_csum_for_read(uint32_t op_flags) const
+{
+  // deep scrub hashes all the data it reads, which we have just hashed too
+  // when verifying the blob checksums
+  return (op_flags & CEPH_OSD_OP_FLAG_BYPASS_CLEAN_CACHE) &&
+    !cct->_conf->bluestore_ignore_data_csum &&
+    cct->_conf.get_val<bool>("bluestore_deep_scrub_reuse_csum");
+}
+
 int BlueStore::_do_read(
   Collection *c,
   OnodeRef& o,
@@ -12980,6 +13028,7 @@ int BlueStore::_do_read(
   r = _generate_read_result_bl(o, offset, length, ready_regions,
                               compressed_blob_bls, blobs2read,
                               buffered && !ioc.skip_cache(),
+                              _reuse_csum_for_read(op_flags),
                               &csum_error, bl);
   if (csum_error) {
     // Handles spurious read errors caused by a kernel bug.
@@ -13363,7 +13412,8 @@ int BlueStore::_do_readv(
                                  std::get<0>(raw_results[i]),
                                  std::get<1>(raw_results[i]),
                                  std::get<2>(raw_results[i]),
-                                 buffered, &csum_error, t);
+                                 buffered, _reuse_csum_for_read(op_flags),
+                                 &csum_error, t);
     if (csum_error) {
       // Handles spurious read errors caused by a kernel bug.
       // We sometimes get all-zero pages as a result of the read under
@@ -118,6 +118,7 @@ enum {
   l_bluestore_csum_lat,
   l_bluestore_read_eio,
   l_bluestore_reads_with_retries,
+  l_bluestore_csum_reused_bytes,
   l_bluestore_read_lat,
   //****************************************
 
@@ -2526,6 +2527,8 @@ private:
     std::shared_ptr<PriorityCache::PriCache> binned_kv_cache = nullptr;
     std::shared_ptr<PriorityCache::PriCache> binned_kv_onode_cache = nullptr;
     std::shared_ptr<PriorityCache::Manager> pcm = nullptr;
+    // caches from outside of BlueStore, see add_pri_cache()
+    std::map<std::string, std::shared_ptr<PriorityCache::PriCache>> other_caches;
 
     struct MempoolCache : public PriorityCache::PriCache {
       BlueStore *store;
@@ -3133,6 +3136,9 @@ public:
   }
 
   void set_cache_shards(unsigned num) override;
+  void add_pri_cache(const std::string& name,
+                     std::shared_ptr<PriorityCache::PriCache> cache) override;
+  void remove_pri_cache(const std::string& name) override;
   void dump_cache_stats(ceph::Formatter *f) override {
     int onode_count = 0, buffers_bytes = 0;
     for (auto i: onode_cache_shards) {
@@ -3287,9 +3293,12 @@ private:
     std::vector<ceph::buffer::list>& compressed_blob_bls,
     blobs2read_t& blobs2read,
     bool buffered,
+    bool reuse_csum,
     bool* csum_error,
     ceph::buffer::list& bl);
 
+  bool _reuse_csum_for_read(uint32_t op_flags) const;
+
   int _do_read(
     Collection *c,
     OnodeRef& o,
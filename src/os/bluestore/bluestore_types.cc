@@ -945,6 +945,29 @@ int bluestore_blob_t::verify_csum(uint64_t b_off, const bufferlist& bl,
     return 0;
 }
 
+bool bluestore_blob_t::get_crc32c_from_csum(uint64_t b_off, uint64_t length,
+					    uint32_t *crc) const
+{
+  if (csum_type != Checksummer::CSUM_CRC32C || length == 0) {
+    return false;
+  }
+  const uint64_t chunk = get_csum_chunk_size();
+  if (b_off % chunk || length % chunk ||
+      (b_off + length) / chunk > get_csum_count()) {
+    return false;
+  }
+  // Each item is crc32c(-1, chunk).  Chain them the way bufferlist::crc32c
+  // adjusts cached values: crc32c(v', buf) = crc32c(v, buf) ^
+  // crc32c(v ^ v', 0*len(buf)).
+  uint32_t r = -1;
+  for (uint64_t i = b_off / chunk; i < (b_off + length) / chunk; ++i) {
+    r = static_cast<uint32_t>(get_csum_item(i)) ^
+      ceph_crc32c(r ^ 0xffffffff, NULL, chunk);
+  }
+  *crc = r;
+  return true;
+}
+
 void bluestore_blob_t::allocated(uint32_t b_off, uint32_t length, const PExtentVector& allocs)
 {
   if (extents.size() == 0) {
@@ -979,6 +979,11 @@ public:
   /// calculate csum for the buffer at the given b_off
   void calc_csum(uint64_t b_off, const ceph::buffer::list& bl);
 
+  /// derive crc32c(-1) of the data at [b_off, b_off+length) from the stored
+  /// per-chunk crc32c csums; false if the csum type or alignment don't allow
+  bool get_crc32c_from_csum(uint64_t b_off, uint64_t length,
+			    uint32_t *crc) const;
+
   /// verify csum: return -EOPNOTSUPP for unsupported checksum type;
   /// return -1 and valid(nonnegative) b_bad_off for checksum error;
   /// return 0 if all is well.
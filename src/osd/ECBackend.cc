@@ -631,6 +631,7 @@ void ECBackend::handle_sub_read_reply(
     return;
   }
   ReadOp &rop = iter->second;
+  read_pipeline.note_sub_read_reply(rop, from);
   if (cct->_conf->bluestore_debug_inject_read_err) {
     for (auto i = op.buffers_read.begin();
          i != op.buffers_read.end();
@@ -727,23 +728,18 @@ void ECBackend::handle_sub_read_reply(
   unsigned is_complete = 0;
   bool need_resend = false;
   bool all_sub_reads_done = rop.in_progress.empty();
-  // For redundant reads check for completion as each shard comes in,
-  // or in a non-recovery read check for completion once all the shards read.
-  if (rop.do_redundant_reads || all_sub_reads_done) {
+  // For redundant and hedged reads check for completion as each shard comes
+  // in, otherwise check for completion once all the shards read.
+  if (rop.do_redundant_reads || rop.hedged || all_sub_reads_done) {
     for (auto &&[oid, read_result]: rop.complete) {
-      shard_id_set have;
-      read_result.processed_read_requests.populate_shard_id_set(have);
+      shard_id_set have =
+        read_pipeline.get_decode_shards(rop, oid, read_result);
       shard_id_set dummy_minimum;
       shard_id_set want_to_read;
       rop.to_read.at(oid).shard_want_to_read.
           populate_shard_id_set(want_to_read);
 
       dout(20) << __func__ << " read_result: " << read_result << dendl;
-      // If all reads are done, we can safely assume that zero buffers can
-      // be applied.
-      if (all_sub_reads_done) {
-        rop.to_read.at(oid).zeros_for_decode.populate_shard_id_set(have);
-      }
 
       int err = -EIO; // If attributes needed but not read.
       if (!rop.to_read.at(oid).want_attrs || rop.complete.at(oid).attrs) {
@@ -811,8 +807,8 @@ void ECBackend::handle_sub_read_reply(
     rop.trace.event("ec read complete");
     rop.debug_log.emplace_back(ECUtil::COMPLETE, op.from);
 
-    /* If do_redundant_reads is set then there might be some in progress
-     * reads remaining.  We need to make sure that these non-read shards
+    /* If do_redundant_reads or hedged is set then there might be some in
+     * progress reads remaining.  We need to make sure that these non-read shards
      * do not get padded. If there was no in progress read, then the zero
      * padding is allowed to stay.
      */
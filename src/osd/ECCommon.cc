@@ -15,6 +15,7 @@
 
 #include "ECCommon.h"
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <ranges>
@@ -118,6 +119,9 @@ void ECCommon::ReadPipeline::complete_read_op(ReadOp &&rop) {
   // if the read op is over. clean all the data of this tid.
   for (auto &pg_shard: rop.in_progress) {
     shard_to_read_map[pg_shard].erase(rop.tid);
+    // The reply would be dropped, but a peer which is slow enough to be
+    // hedged must not look fast, so account at least the time waited.
+    note_sub_read_reply(rop, pg_shard);
   }
   rop.in_progress.clear();
   tid_to_read_map.erase(rop.tid);
@@ -130,6 +134,11 @@ void ECCommon::ReadPipeline::on_change() {
   tid_to_read_map.clear();
   shard_to_read_map.clear();
   in_progress_client_reads.clear();
+#ifndef WITH_CRIMSON
+  if (hedge_callback.is_scheduled()) {
+    get_parent()->get_pg_timer().cancel(hedge_callback);
+  }
+#endif
 }
 
 std::pair<const shard_id_set, const shard_id_set>
@@ -238,20 +247,37 @@ int ECCommon::ReadPipeline::get_min_avail_to_read_shards(
 
   read_request.shard_want_to_read.populate_shard_id_set(want);
 
-  int r = 0;
+  // If we support partial reads, we are making the assumption that only
+  // K shards need to be read to recover data.  We opt here for minimising
+  // the number of reads over minimising the amount of parity calculations
+  // that are needed.
+  shard_id_set want_for_plugin = want;
   auto kth_iter = want.find_nth(sinfo.get_k());
   if (kth_iter != want.end()) {
-    // If we support partial reads, we are making the assumption that only
-    // K shards need to be read to recover data.  We opt here for minimising
-    // the number of reads over minimising the amount of parity calculations
-    // that are needed.
-    shard_id_set want_for_plugin = want;
     shard_id_t kth = *kth_iter;
     want_for_plugin.erase_range(kth, sinfo.get_k_plus_m() - (int)kth);
-    r = ec_impl->minimum_to_decode(want_for_plugin, have, need_set,
+  }
+
+  int r = -EIO;
+  shard_id_set fast_have = have;
+  if (!for_recovery && !do_redundant_reads &&
+      avoid_slow_shards(fast_have, shards)) {
+    r = ec_impl->minimum_to_decode(want_for_plugin, fast_have, need_set,
                                      need_sub_chunks.get());
-  } else {
-    r = ec_impl->minimum_to_decode(want, have, need_set,
+    if (r == 0) {
+      // Treat the slow shards as missing for the reads below.
+      have = fast_have;
+    } else {
+      dout(20) << __func__ << " cannot avoid slow shards, have: " << have
+               << " fast: " << fast_have << dendl;
+      need_set.clear();
+      if (need_sub_chunks) {
+        need_sub_chunks->clear();
+      }
+    }
+  }
+  if (r < 0) {
+    r = ec_impl->minimum_to_decode(want_for_plugin, have, need_set,
                                      need_sub_chunks.get());
   }
 
@@ -357,8 +383,9 @@ int ECCommon::ReadPipeline::get_remaining_shards(
     read_result_t &read_result,
     read_request_t &read_request,
     const bool for_recovery,
-    bool want_attrs) {
-  set<pg_shard_t> error_shards;
+    bool want_attrs,
+    const set<pg_shard_t> &busy_shards) {
+  set<pg_shard_t> error_shards = busy_shards;
   for (auto &shard: std::views::keys(read_result.errors)) {
     error_shards.insert(shard);
   }
@@ -455,18 +482,28 @@ void ECCommon::ReadPipeline::start_read_op(
     op.trace.event("start ec read");
   }
   do_read_op(op);
+  if (!for_recovery && !do_redundant_reads) {
+    schedule_hedge(op);
+  }
 }
 
 void ECCommon::ReadPipeline::do_read_op(ReadOp &rop) {
+  dout(10) << __func__ << ": starting read " << rop << dendl;
+  ceph_assert(!rop.to_read.empty());
+  send_sub_reads(rop, rop.to_read);
+}
+
+void ECCommon::ReadPipeline::send_sub_reads(
+    ReadOp &rop,
+    const map<hobject_t, read_request_t> &reads) {
   const int priority = rop.priority;
   const ceph_tid_t tid = rop.tid;
   bool reads_sent = false;
-
-  dout(10) << __func__ << ": starting read " << rop << dendl;
-  ceph_assert(!rop.to_read.empty());
+  const bool track_latency = !rop.for_recovery && hedge_enabled();
+  const auto now = ceph::mono_clock::now();
 
   map<pg_shard_t, ECSubRead> messages;
-  for (auto &&[hoid, read_request]: rop.to_read) {
+  for (auto &&[hoid, read_request]: reads) {
     bool need_attrs = read_request.want_attrs;
 
     for (auto &&[shard, shard_read]: read_request.shard_reads) {
@@ -503,6 +540,9 @@ void ECCommon::ReadPipeline::do_read_op(ReadOp &rop) {
   for (auto &&[pg_shard, read]: messages) {
     rop.in_progress.insert(pg_shard);
     shard_to_read_map[pg_shard].insert(rop.tid);
+    if (track_latency) {
+      rop.sent_at[pg_shard] = now;
+    }
     read.tid = tid;
 #ifdef WITH_CRIMSON // crimson only
     if (pg_shard == get_parent()->whoami_shard()) {
@@ -543,6 +583,218 @@ void ECCommon::ReadPipeline::do_read_op(ReadOp &rop) {
   dout(10) << __func__ << ": started " << rop << dendl;
 }
 
+bool ECCommon::ReadPipeline::hedge_enabled() const {
+#ifdef WITH_CRIMSON
+  return false;
+#else
+  return cct->_conf.get_val<bool>("osd_ec_read_hedge");
+#endif
+}
+
+void ECCommon::ReadPipeline::note_sub_read_reply(
+    ReadOp &rop,
+    pg_shard_t from) {
+  auto i = rop.sent_at.find(from);
+  if (i == rop.sent_at.end()) {
+    return;
+  }
+  std::chrono::duration<double, std::nano> latency =
+    ceph::mono_clock::now() - i->second;
+  rop.sent_at.erase(i);
+  auto &estimate = osd_read_latency[from.osd];
+  estimate.add_sample(latency.count());
+  dout(20) << __func__ << ": osd." << from.osd << " latency "
+           << latency.count() << "ns avg " << estimate.avg_ns
+           << "ns dev " << estimate.dev_ns << "ns" << dendl;
+}
+
+bool ECCommon::ReadPipeline::avoid_slow_shards(
+    shard_id_set &have,
+    const shard_id_map<pg_shard_t> &shards) const {
+  if (!hedge_enabled() || have.size() <= sinfo.get_k()) {
+    return false;
+  }
+
+  // A peer is slow if it takes more than twice as long as the median one.
+  vector<pair<double, shard_id_t>> by_latency;
+  for (auto shard : have) {
+    auto i = osd_read_latency.find(shards.at(shard).osd);
+    if (i == osd_read_latency.end() || !i->second.valid) {
+      return false;
+    }
+    by_latency.emplace_back(i->second.avg_ns, shard);
+  }
+  std::sort(by_latency.begin(), by_latency.end());
+  const double median = by_latency[by_latency.size() / 2].first;
+
+  bool changed = false;
+  size_t spare = have.size() - sinfo.get_k();
+  for (auto i = by_latency.rbegin(); i != by_latency.rend() && spare > 0;
+       ++i, --spare) {
+    if (i->first <= 2 * median) {
+      break;
+    }
+    dout(20) << __func__ << ": avoiding shard " << i->second << " on osd."
+             << shards.at(i->second).osd << dendl;
+    have.erase(i->second);
+    changed = true;
+  }
+  return changed;
+}
+
+void ECCommon::ReadPipeline::schedule_hedge(ReadOp &rop) {
+#ifndef WITH_CRIMSON
+  if (!hedge_enabled() || rop.in_progress.empty()) {
+    return;
+  }
+  double deadline_ns = 0;
+  for (auto &pg_shard : rop.in_progress) {
+    auto i = osd_read_latency.find(pg_shard.osd);
+    if (i == osd_read_latency.end() || !i->second.valid) {
+      // Nothing to tell a late shard from a normal one yet.
+      return;
+    }
+    deadline_ns = std::max(deadline_ns, i->second.deadline_ns());
+  }
+  auto delay = std::max<ceph::timespan>(
+    cct->_conf.get_val<std::chrono::milliseconds>(
+      "osd_ec_read_hedge_min_delay"),
+    std::chrono::duration_cast<ceph::timespan>(
+      std::chrono::duration<double, std::nano>(deadline_ns)));
+  rop.hedge_at = ceph::mono_clock::now() + delay;
+  dout(20) << __func__ << ": tid " << rop.tid << " hedge after "
+           << delay << dendl;
+  arm_hedge_timer(*rop.hedge_at);
+#endif
+}
+
+#ifndef WITH_CRIMSON
+void ECCommon::ReadPipeline::arm_hedge_timer(
+    ceph::mono_clock::time_point when) {
+  if (hedge_callback.is_scheduled()) {
+    if (hedge_callback_at <= when) {
+      return;
+    }
+    get_parent()->get_pg_timer().cancel(hedge_callback);
+  }
+  hedge_callback_at = when;
+  get_parent()->get_pg_timer().schedule_after(
+    hedge_callback,
+    std::max<ceph::timespan>(ceph::timespan::zero(),
+                             when - ceph::mono_clock::now()));
+}
+#endif
+
+void ECCommon::ReadPipeline::hedge_reads() {
+#ifndef WITH_CRIMSON
+  const auto now = ceph::mono_clock::now();
+  std::optional<ceph::mono_clock::time_point> next;
+  for (auto &&[tid, rop] : tid_to_read_map) {
+    if (!rop.hedge_at) {
+      continue;
+    }
+    if (*rop.hedge_at > now) {
+      next = next ? std::min(*next, *rop.hedge_at) : *rop.hedge_at;
+      continue;
+    }
+    rop.hedge_at.reset();
+    if (!hedge_read_op(rop)) {
+      dout(20) << __func__ << ": cannot hedge " << rop << dendl;
+    }
+  }
+  if (next) {
+    arm_hedge_timer(*next);
+  }
+#endif
+}
+
+bool ECCommon::ReadPipeline::hedge_read_op(ReadOp &rop) {
+  if (rop.in_progress.empty() || rop.hedged) {
+    return false;
+  }
+  if (std::ranges::all_of(get_parent()->get_acting_shards(),
+                          [&rop](const pg_shard_t &pg_shard) {
+                            return rop.source_to_obj.contains(pg_shard);
+                          })) {
+    // Every shard is being read already.
+    return false;
+  }
+
+  map<hobject_t, read_request_t> hedges;
+  set<pg_shard_t> new_sources;
+  for (auto &&[hoid, read_request] : rop.to_read) {
+    if (read_request.shard_reads.empty()) {
+      // Already decodable.
+      continue;
+    }
+    auto complete = rop.complete.find(hoid);
+    if (read_request.want_attrs &&
+        (complete == rop.complete.end() || !complete->second.attrs)) {
+      // The late shard may be the one reading the attributes.
+      return false;
+    }
+    if (complete == rop.complete.end()) {
+      complete = rop.complete.emplace(hoid, &sinfo).first;
+    }
+
+    read_request_t hedge = read_request;
+    hedge.shard_reads.clear();
+    if (get_remaining_shards(hoid, complete->second, hedge, false, false,
+                             rop.in_progress) != 0) {
+      return false;
+    }
+    for (auto &&[_, shard_read] : hedge.shard_reads) {
+      if (rop.source_to_obj.contains(shard_read.pg_shard)) {
+        // Would need more from a peer which was already read from.
+        return false;
+      }
+      new_sources.insert(shard_read.pg_shard);
+    }
+    if (!hedge.shard_reads.empty()) {
+      hedges.emplace(hoid, std::move(hedge));
+    }
+  }
+  // Bound the cost of hedging to a single extra sub read.
+  if (hedges.empty() || new_sources.size() > 1) {
+    return false;
+  }
+
+  dout(10) << __func__ << ": tid " << rop.tid << " late " << rop.in_progress
+           << " hedging to " << new_sources << dendl;
+  send_sub_reads(rop, hedges);
+  for (auto &&[hoid, hedge] : hedges) {
+    auto &read_request = rop.to_read.at(hoid);
+    for (auto &&[shard, shard_read] : hedge.shard_reads) {
+      read_request.shard_reads[shard] = std::move(shard_read);
+    }
+    read_request.zeros_for_decode.insert(hedge.zeros_for_decode);
+  }
+  rop.hedged = true;
+  return true;
+}
+
+shard_id_set ECCommon::ReadPipeline::get_decode_shards(
+    const ReadOp &rop,
+    const hobject_t &oid,
+    const read_result_t &read_result) const {
+  shard_id_set have;
+  read_result.processed_read_requests.populate_shard_id_set(have);
+  shard_id_set zeros;
+  rop.to_read.at(oid).zeros_for_decode.populate_shard_id_set(zeros);
+  // If all reads are done, we can safely assume that zero buffers can
+  // be applied.  A hedged read can apply those of the shards it is no
+  // longer waiting for.
+  if (rop.in_progress.empty()) {
+    have.insert(zeros);
+  } else if (rop.hedged) {
+    for (auto &pg_shard : rop.in_progress) {
+      zeros.erase(pg_shard.shard);
+    }
+    have.insert(zeros);
+  }
+  return have;
+}
+
 void ECCommon::ReadPipeline::get_want_to_read_shards(
     const list<ec_align_t> &to_read,
     ECUtil::shard_extent_set_t &want_shard_reads) {
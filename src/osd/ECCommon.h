@@ -18,6 +18,7 @@
 #include <boost/intrusive/list.hpp>
 #include <fmt/format.h>
 
+#include "common/ceph_time.h"
 #include "common/sharedptr_registry.hpp"
 #include "erasure-code/ErasureCodeInterface.h"
 #include "ECUtil.h"
@@ -42,6 +43,7 @@ typedef void* OpRequestRef;
 typedef crimson::osd::ObjectContextRef ObjectContextRef;
 #else
 #include "common/WorkQueue.h"
+#include "common/intrusive_timer.h"
 #endif
 
 #include "ECTransaction.h"
@@ -275,6 +277,14 @@ struct ECCommon {
 
     std::set<pg_shard_t> in_progress;
 
+    /// when the sub read to each shard of in_progress was sent, kept for
+    /// the peer latency estimates of hedged reads
+    std::map<pg_shard_t, ceph::mono_clock::time_point> sent_at;
+    /// deadline after which a late shard is hedged, unset if never
+    std::optional<ceph::mono_clock::time_point> hedge_at;
+    /// an extra shard read was issued because a shard was late
+    bool hedged = false;
+
     std::list<ECUtil::log_entry_t> debug_log;
 
     ReadOp(
@@ -307,6 +317,7 @@ struct ECCommon {
           << ", priority=" << priority << ", obj_to_source=" << obj_to_source
           << ", source_to_obj=" << source_to_obj << ", in_progress=" <<
           in_progress
+          << ", hedged=" << hedged
           << ", debug_log=" << debug_log << ")";
     }
   };
@@ -346,6 +357,11 @@ struct ECCommon {
 
     void do_read_op(ReadOp &rop);
 
+    /// send the shard_reads of reads, which belong to rop
+    void send_sub_reads(
+        ReadOp &rop,
+        const std::map<hobject_t, read_request_t> &reads);
+
     int send_all_remaining_reads(
         const hobject_t &hoid,
         ReadOp &rop);
@@ -354,6 +370,87 @@ struct ECCommon {
 
     void kick_reads();
 
+    /**
+     * Hedged reads (osd_ec_read_hedge)
+     *
+     * Each peer OSD gets an estimate of its client sub read latency,
+     * smoothed like a TCP round trip time (mean and mean deviation).
+     * Shard selection avoids peers that are much slower than the rest,
+     * and every client read gets a deadline of mean + 4 * deviation of
+     * its slowest peer, a cheap stand-in for a high percentile.  A read
+     * still waiting on a shard at its deadline reads one extra shard and
+     * completes with whichever shards are enough to decode first.
+     */
+    struct read_latency_t {
+      double avg_ns = 0;
+      double dev_ns = 0;
+      bool valid = false;
+
+      void add_sample(double ns) {
+        if (!valid) {
+          avg_ns = ns;
+          dev_ns = ns / 2;
+          valid = true;
+        } else {
+          double err = ns - avg_ns;
+          avg_ns += err / 8;
+          dev_ns += (std::abs(err) - dev_ns) / 4;
+        }
+      }
+      double deadline_ns() const {
+        return avg_ns + 4 * dev_ns;
+      }
+    };
+    std::map<int, read_latency_t> osd_read_latency;
+
+    bool hedge_enabled() const;
+    /// account the reply of from to rop in the latency estimates
+    void note_sub_read_reply(ReadOp &rop, pg_shard_t from);
+    /// drop shards on slow peers from have while k others remain
+    bool avoid_slow_shards(
+        shard_id_set &have,
+        const shard_id_map<pg_shard_t> &shards) const;
+    /// set the hedge deadline of a freshly sent rop
+    void schedule_hedge(ReadOp &rop);
+    /// hedge the reads whose deadline passed, called from hedge_callback
+    void hedge_reads();
+    /// issue one extra shard read for rop, false if that is not possible
+    bool hedge_read_op(ReadOp &rop);
+    /// the shards read by rop that oid can be decoded from so far
+    shard_id_set get_decode_shards(
+        const ReadOp &rop,
+        const hobject_t &oid,
+        const read_result_t &read_result) const;
+
+#ifndef WITH_CRIMSON
+    void arm_hedge_timer(ceph::mono_clock::time_point when);
+
+    struct hedge_callback_t final
+      : public common::intrusive_timer::callback_t {
+      ReadPipeline *pipeline;
+
+      explicit hedge_callback_t(ReadPipeline *pipeline)
+        : pipeline(pipeline) {}
+
+      void lock() override {
+        return pipeline->get_parent()->pg_lock();
+      }
+      void unlock() override {
+        return pipeline->get_parent()->pg_unlock();
+      }
+      void add_ref() override {
+        return pipeline->get_parent()->pg_add_ref();
+      }
+      void dec_ref() override {
+        return pipeline->get_parent()->pg_dec_ref();
+      }
+      void invoke() override {
+        return pipeline->hedge_reads();
+      }
+    } hedge_callback{this};
+    ceph::mono_clock::time_point hedge_callback_at;
+#endif
+
     std::map<ceph_tid_t, ReadOp> tid_to_read_map;
     std::map<pg_shard_t, std::set<ceph_tid_t>> shard_to_read_map;
     std::list<ClientAsyncReadStatus> in_progress_client_reads;
@@ -416,7 +513,8 @@ struct ECCommon {
         read_result_t &read_result,
         read_request_t &read_request,
         bool for_recovery,
-        bool want_attrs);
+        bool want_attrs,
+        const std::set<pg_shard_t> &busy_shards = {});
 
     void get_all_avail_shards(
         const hobject_t &hoid,
@@ -3,6 +3,7 @@
 
 #include "ECExtentCache.h"
 #include "ECUtil.h"
+#include "osd_perf_counters.h"
 
 #include <mutex>
 #include <ranges>
@@ -49,11 +50,15 @@ void ECExtentCache::Object::request(OpRef &op) {
    * post-invalidate ops are honoured.
    */
   if (op->reads && !cache_invalidate_expected) {
+    uint64_t wanted = 0;
+    uint64_t read = 0;
     for (auto &&[shard, eset] : *(op->reads)) {
       extent_set request = eset;
       if (do_not_read.contains(shard)) {
         request.subtract(do_not_read.at(shard));
       }
+      wanted += eset.size();
+      read += request.size();
 
       if (!request.empty()) {
         requesting[shard].union_of(request);
@@ -61,6 +66,7 @@ void ECExtentCache::Object::request(OpRef &op) {
         requesting_ops.emplace_back(op);
       }
     }
+    pg.lru.count_reads(wanted, read);
   }
 
 
@@ -404,6 +410,35 @@ void ECExtentCache::LRU::free_maybe() {
   }
 }
 
+void ECExtentCache::LRU::set_max_size(uint64_t new_max_size) {
+  std::lock_guard lock{mutex};
+  max_size = new_max_size;
+  free_maybe();
+}
+
+uint64_t ECExtentCache::LRU::get_max_size() {
+  std::lock_guard lock{mutex};
+  return max_size;
+}
+
+uint64_t ECExtentCache::LRU::get_size() {
+  std::lock_guard lock{mutex};
+  return size;
+}
+
+/* Reads which the cache (or a read already in flight for the object) covers
+ * are not sent to the shards.
+ */
+void ECExtentCache::LRU::count_reads(uint64_t wanted, uint64_t read) {
+  if (!logger || wanted == 0) {
+    return;
+  }
+  logger->inc(read ? l_osd_ec_extent_cache_miss : l_osd_ec_extent_cache_hit);
+  if (wanted > read) {
+    logger->inc(l_osd_ec_extent_cache_bytes_saved, wanted - read);
+  }
+}
+
 void ECExtentCache::LRU::discard() {
   std::lock_guard lock{mutex};
   lru.clear();
@@ -468,3 +503,44 @@ shard_extent_map_t ECExtentCache::Object::get_cache(
   }
   return shard_extent_map_t(&pg.sinfo, std::move(res));
 }
+
+uint64_t ECExtentCache::PriCache::get_used_bytes() const {
+  uint64_t used = 0;
+  for (auto lru : lrus) {
+    used += lru->get_size();
+  }
+  return used;
+}
+
+int64_t ECExtentCache::PriCache::request_cache_bytes(
+    PriorityCache::Priority pri, uint64_t total_cache) const {
+  if (pri != PriorityCache::Priority::LAST) {
+    return 0;
+  }
+  int64_t request = get_used_bytes();
+  int64_t assigned = get_cache_bytes(pri);
+  return request > assigned ? request - assigned : 0;
+}
+
+int64_t ECExtentCache::PriCache::get_cache_bytes() const {
+  int64_t total = 0;
+  for (int i = 0; i < PriorityCache::Priority::LAST + 1; i++) {
+    total += cache_bytes[i];
+  }
+  return total;
+}
+
+int64_t ECExtentCache::PriCache::commit_cache_size(uint64_t total_cache) {
+  /* get_chunk() rounds up, the headroom is what lets the LRUs fill beyond
+   * what they currently use, and so ask for more at the next balance.
+   */
+  committed_bytes = PriorityCache::get_chunk(get_cache_bytes(), total_cache);
+  if (!lrus.empty()) {
+    uint64_t per_lru = std::max<uint64_t>(min_size,
+                                          committed_bytes / lrus.size());
+    for (auto lru : lrus) {
+      lru->set_max_size(per_lru);
+    }
+  }
+  return committed_bytes;
+}
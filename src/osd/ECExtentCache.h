@@ -31,7 +31,9 @@
  * taken.
  *
  * The LRU has a maximum size (defined in the constructor) and will keep its
- * usage below this amount.
+ * usage below this amount. When the object store autotunes its caches against
+ * osd_memory_target, ECExtentCache::PriCache lets the LRUs of all OSD-shards
+ * grow beyond that size into the memory the autotuner hands out to them.
  *
  * Cache Lines
  *
@@ -76,6 +78,7 @@
 #pragma once
 
 #include "ECUtil.h"
+#include "common/PriorityCache.h"
 #include "include/Context.h"
 
 class ECExtentCache {
@@ -130,6 +133,7 @@ class ECExtentCache {
     uint64_t max_size = 0;
     uint64_t size = 0;
     ceph::mutex mutex = ceph::make_mutex("ECExtentCache::LRU");
+    PerfCounters *logger;
 
     void free_maybe();
     void discard();
@@ -140,9 +144,66 @@ class ECExtentCache {
     std::shared_ptr<ECUtil::shard_extent_map_t> find(
         const hobject_t &oid, uint64_t offset);
     void remove_object(const hobject_t &oid);
+    void count_reads(uint64_t wanted, uint64_t read);
 
    public:
-    explicit LRU(uint64_t max_size) : map(), max_size(max_size) {}
+    explicit LRU(uint64_t max_size, PerfCounters *logger = nullptr) :
+      map(), max_size(max_size), logger(logger) {}
+
+    void set_max_size(uint64_t new_max_size);
+    uint64_t get_max_size();
+    uint64_t get_size();
+  };
+
+  /* Offers the LRUs of all OSD-shards to the PriorityCache manager of the
+   * object store as a single cache. Memory committed to it is split evenly
+   * between the LRUs, none of which shrinks below min_size.
+   */
+  class PriCache : public PriorityCache::PriCache {
+    std::vector<LRU*> lrus;
+    uint64_t min_size;
+    int64_t cache_bytes[PriorityCache::Priority::LAST+1] = {0};
+    int64_t committed_bytes = 0;
+    double cache_ratio;
+
+   public:
+    PriCache(std::vector<LRU*> lrus, uint64_t min_size, double cache_ratio) :
+      lrus(std::move(lrus)), min_size(min_size), cache_ratio(cache_ratio) {}
+
+    uint64_t get_used_bytes() const;
+
+    int64_t request_cache_bytes(PriorityCache::Priority pri,
+                                uint64_t total_cache) const override;
+    int64_t get_cache_bytes(PriorityCache::Priority pri) const override {
+      return cache_bytes[pri];
+    }
+    int64_t get_cache_bytes() const override;
+    void set_cache_bytes(PriorityCache::Priority pri, int64_t bytes) override {
+      cache_bytes[pri] = bytes;
+    }
+    void add_cache_bytes(PriorityCache::Priority pri, int64_t bytes) override {
+      cache_bytes[pri] += bytes;
+    }
+    int64_t commit_cache_size(uint64_t total_cache) override;
+    int64_t get_committed_size() const override {
+      return committed_bytes;
+    }
+    double get_cache_ratio() const override {
+      return cache_ratio;
+    }
+    void set_cache_ratio(double ratio) override {
+      cache_ratio = ratio;
+    }
+    std::string get_cache_name() const override {
+      return "EC Extent Cache";
+    }
+    // The LRU is not age binned, everything it holds is requested at LAST.
+    void shift_bins() override {}
+    void import_bins(const std::vector<uint64_t> &bins) override {}
+    void set_bins(PriorityCache::Priority pri, uint64_t end_bin) override {}
+    uint64_t get_bins(PriorityCache::Priority pri) const override {
+      return 0;
+    }
   };
 
   class Op {
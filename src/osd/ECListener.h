@@ -18,6 +18,7 @@
 #include "osd_internal_types.h"
 #include "OSDMap.h"
 #include "common/WorkQueue.h"
+#include "common/intrusive_timer.h"
 #include "PGLog.h"
 #include "messages/MOSDPGPush.h"
 
@@ -117,6 +118,14 @@ struct ECListener {
   virtual void schedule_recovery_work(
     GenContext<ThreadPool::TPHandle&> *c,
     uint64_t cost) = 0;
+
+  /// for the timer callbacks of the pipelines, see get_pg_timer()
+  virtual void pg_lock() = 0;
+  virtual void pg_unlock() = 0;
+  virtual void pg_add_ref() = 0;
+  virtual void pg_dec_ref() = 0;
+
+  virtual common::intrusive_timer &get_pg_timer() = 0;
 #endif
 
   virtual epoch_t get_interval_start_epoch() const = 0;
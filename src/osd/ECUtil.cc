@@ -490,6 +490,8 @@ int shard_extent_map_t::encode(const ErasureCodeInterfaceRef &ec_impl,
     shard_id_set *dedup_zeros) {
   shard_id_set out_set = sinfo->get_parity_shards();
   bool rebuild_req = false;
+  std::vector<shard_id_map<bufferptr>> in_batch;
+  std::vector<shard_id_map<bufferptr>> out_batch;
 
   for (auto iter = begin_slice_iterator(out_set, dpp, dedup_zeros); !iter.is_end(); ++iter) {
     if (!iter.is_page_aligned()) {
@@ -500,8 +502,17 @@ int shard_extent_map_t::encode(const ErasureCodeInterfaceRef &ec_impl,
     shard_id_map<bufferptr> &in = iter.get_in_bufferptrs();
     shard_id_map<bufferptr> &out = iter.get_out_bufferptrs();
 
-    if (int ret = ec_impl->encode_chunks(in, out)) {
-      return ret;
+    if (dedup_zeros) {
+      // The iterator looks for zero parity as it advances, so each slice
+      // has to be encoded before moving on.
+      if (int ret = ec_impl->encode_chunks(in, out)) {
+        return ret;
+      }
+    } else {
+      // Otherwise hand all the slices (typically one per stripe) to the
+      // plugin in a single call.
+      in_batch.push_back(in);
+      out_batch.push_back(out);
     }
   }
 
@@ -510,11 +521,22 @@ int shard_extent_map_t::encode(const ErasureCodeInterfaceRef &ec_impl,
     return encode(ec_impl, dpp, dedup_zeros);
   }
 
+  if (!in_batch.empty()) {
+    if (int ret = ec_impl->encode_chunks_batch(in_batch, out_batch)) {
+      return ret;
+    }
+  }
+
   return 0;
 }
 
 /* Encode parity chunks, using the parity delta write interfaces on plugins
  * that support them.
+ *
+ * The deltas of all the data shards are computed first, so that the parity
+ * is then updated in a single pass with every delta of a slice applied by
+ * one apply_delta() call, rather than one pass over the parity per data
+ * shard.
  */
 int shard_extent_map_t::encode_parity_delta(
     const ErasureCodeInterfaceRef &ec_impl,
@@ -525,39 +547,56 @@ int shard_extent_map_t::encode_parity_delta(
   pad_and_rebuild_to_ec_align();
   old_sem.pad_and_rebuild_to_ec_align();
 
+  shard_extent_map_t deltas(sinfo);
   for (auto data_shard : sinfo->get_data_shards()) {
-    shard_extent_map_t s(sinfo);
-    if (!contains_shard(data_shard)) {
+    if (!contains_shard(data_shard) || !old_sem.contains_shard(data_shard)) {
       continue;
     }
-    s.extent_maps[shard_id_t(0)] = old_sem.extent_maps[data_shard];
-    s.extent_maps[shard_id_t(1)] = extent_maps[data_shard];
-    for (shard_id_t parity_shard : sinfo->get_parity_shards()) {
-      if (extent_maps.contains(parity_shard)) {
-        s.extent_maps[parity_shard] = extent_maps[parity_shard];
+    extent_set overlap = get_extent_set(data_shard);
+    overlap.intersection_of(old_sem.get_extent_set(data_shard));
+
+    for (auto &&[off, len] : overlap) {
+      ceph_assert(len % EC_ALIGN_SIZE == 0);
+      bufferptr delta = buffer::create_aligned(len, EC_ALIGN_SIZE);
+      bufferlist old_bl;
+      old_sem.get_buffer(data_shard, off, len, old_bl);
+      old_bl.begin().copy(len, delta.c_str());
+
+      bufferlist new_bl;
+      get_buffer(data_shard, off, len, new_bl);
+      bufferptr new_data;
+      if (new_bl.is_contiguous()) {
+        new_data = new_bl.front();
+      } else {
+        new_data = buffer::create_aligned(len, EC_ALIGN_SIZE);
+        new_bl.begin().copy(len, new_data.c_str());
       }
+      ec_impl->encode_delta(delta, new_data, &delta);
+
+      bufferlist delta_bl;
+      delta_bl.append(std::move(delta));
+      deltas.insert_in_shard(data_shard, off, delta_bl);
     }
+  }
 
-    s.compute_ro_range();
-
-    for (auto iter = s.begin_slice_iterator(out_set, dpp); !iter.is_end(); ++iter) {
-      ceph_assert(iter.is_page_aligned());
-      shard_id_map<bufferptr> &data_shards = iter.get_in_bufferptrs();
-      shard_id_map<bufferptr> &parity_shards = iter.get_out_bufferptrs();
-
-      unsigned int size = iter.get_length();
-      ceph_assert(size % EC_ALIGN_SIZE == 0);
-      ceph_assert(size > 0);
-      bufferptr delta = buffer::create_aligned(size, EC_ALIGN_SIZE);
-
-      if (data_shards[shard_id_t(0)].length() != 0 && data_shards[shard_id_t(1)]
-        .length() != 0) {
-        ec_impl->encode_delta(data_shards[shard_id_t(0)],
-                              data_shards[shard_id_t(1)], &delta);
-        shard_id_map<bufferptr> in(sinfo->get_k_plus_m());
-        in.emplace(data_shard, delta);
-        ec_impl->apply_delta(in, parity_shards);
-      }
+  if (deltas.empty()) {
+    return 0;
+  }
+
+  for (shard_id_t parity_shard : sinfo->get_parity_shards()) {
+    if (extent_maps.contains(parity_shard)) {
+      deltas.extent_maps[parity_shard] = extent_maps[parity_shard];
+    }
+  }
+  deltas.compute_ro_range();
+
+  for (auto iter = deltas.begin_slice_iterator(out_set, dpp); !iter.is_end(); ++iter) {
+    ceph_assert(iter.is_page_aligned());
+    shard_id_map<bufferptr> &data_shards = iter.get_in_bufferptrs();
+    shard_id_map<bufferptr> &parity_shards = iter.get_out_bufferptrs();
+
+    if (!data_shards.empty() && !parity_shards.empty()) {
+      ec_impl->apply_delta(data_shards, parity_shards);
     }
   }
 
@@ -717,6 +756,8 @@ int shard_extent_map_t::_decode(const ErasureCodeInterfaceRef &ec_impl,
                                 const shard_id_set &need_set,
                                 DoutPrefixProvider *dpp) {
   bool rebuild_req = false;
+  std::vector<shard_id_map<bufferptr>> in_batch;
+  std::vector<shard_id_map<bufferptr>> out_batch;
 
   for (auto iter = begin_slice_iterator(need_set, dpp); !iter.is_end(); ++iter) {
     if (!iter.is_page_aligned()) {
@@ -731,9 +772,8 @@ int shard_extent_map_t::_decode(const ErasureCodeInterfaceRef &ec_impl,
       continue;
     }
 
-    if (int ret = ec_impl->decode_chunks(want_set, in, out)) {
-      return ret;
-    }
+    in_batch.push_back(in);
+    out_batch.push_back(out);
   }
 
   if (rebuild_req) {
@@ -741,6 +781,12 @@ int shard_extent_map_t::_decode(const ErasureCodeInterfaceRef &ec_impl,
     return _decode(ec_impl, want_set, need_set, dpp);
   }
 
+  if (!in_batch.empty()) {
+    if (int ret = ec_impl->decode_chunks_batch(want_set, in_batch, out_batch)) {
+      return ret;
+    }
+  }
+
   compute_ro_range();
 
   return 0;
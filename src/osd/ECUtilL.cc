@@ -182,6 +182,30 @@ END_IGNORE_DEPRECATED
     return 0;
   }
 
+  interval_set<uint64_t> ECUtilL::subchunk_extents(
+    const stripe_info_t &sinfo,
+    unsigned sub_chunk_count,
+    uint64_t off,
+    uint64_t len,
+    const vector<pair<int, int>> &subchunks,
+    uint64_t object_size)
+  {
+    const uint64_t subchunk_size = sinfo.get_chunk_size() / sub_chunk_count;
+    interval_set<uint64_t> extents;
+    for (uint64_t m = 0; m < len; m += sinfo.get_chunk_size()) {
+      for (auto &&[first, count] : subchunks) {
+        extents.union_insert(off + m + first * subchunk_size,
+                             count * subchunk_size);
+      }
+    }
+    interval_set<uint64_t> object;
+    if (object_size > 0) {
+      object.insert(0, object_size);
+    }
+    extents.intersection_of(object);
+    return extents;
+  }
+
   void ECUtilL::HashInfo::append(uint64_t old_size,
                                 map<int, bufferlist> &to_append) {
     ceph_assert(old_size == total_chunk_size);
@@ -21,6 +21,7 @@
 #include "include/ceph_assert.h"
 #include "include/encoding.h"
 #include "common/Formatter.h"
+#include "include/interval_set.h"
 
 namespace ECLegacy {
 namespace ECUtilL {
@@ -210,6 +211,17 @@ int encode(
   const std::set<int> &want,
   std::map<int, ceph::buffer::list> *out);
 
+/// shard extents holding the sub-chunk runs @subchunks of every chunk in
+/// [off, off + len), runs that touch are merged and the result is clipped
+/// to a shard object of @object_size bytes
+interval_set<uint64_t> subchunk_extents(
+  const stripe_info_t &sinfo,
+  unsigned sub_chunk_count,
+  uint64_t off,
+  uint64_t len,
+  const std::vector<std::pair<int, int>> &subchunks,
+  uint64_t object_size);
+
 class HashInfo {
   uint64_t total_chunk_size = 0;
   std::vector<uint32_t> cumulative_shard_hashes;
@@ -3709,6 +3709,19 @@ int OSD::init()
   dout(2) << "journal looks like " << (journal_is_rotational ? "hdd" : "ssd")
           << dendl;
 
+  if (double ratio = cct->_conf.get_val<double>(
+        "ec_extent_cache_autotune_ratio"); ratio > 0) {
+    std::vector<ECExtentCache::LRU*> lrus;
+    for (auto shard : shards) {
+      lrus.push_back(&shard->ec_extent_cache_lru);
+    }
+    ec_extent_cache_pricache = std::make_shared<ECExtentCache::PriCache>(
+      std::move(lrus),
+      cct->_conf.get_val<uint64_t>("ec_extent_cache_size"),
+      ratio);
+    store->add_pri_cache("ec_extent_cache", ec_extent_cache_pricache);
+  }
+
   enable_disable_fuse(false);
 
   dout(2) << "boot" << dendl;
@@ -4821,6 +4834,10 @@ int OSD::shutdown()
   service.shutdown();
 
   std::lock_guard lock(osd_lock);
+  if (ec_extent_cache_pricache) {
+    store->remove_pri_cache("ec_extent_cache");
+    ec_extent_cache_pricache.reset();
+  }
   store->umount();
   store.reset();
   dout(10) << "Store synced" << dendl;
@@ -6223,6 +6240,11 @@ void OSD::heartbeat()
   logger->set(
       l_osd_loadavg,
       100.0 * service.get_scrub_services().update_load_average().value_or(0.0));
+  {
+    const auto [op_lat_sum_ns, op_count] = logger->get_tavg_ns(l_osd_op_lat);
+    service.get_scrub_services().update_client_latency(
+      op_lat_sum_ns, op_count);
+  }
   dout(30) << "heartbeat checking stats" << dendl;
 
   // refresh peer list and osd stats
@@ -11040,7 +11062,7 @@ OSDShard::OSDShard(
       osd->store->get_type(), osd_op_queue, osd_op_queue_cut_off)),
     context_queue(sdata_wait_lock, sdata_cond),
     ec_extent_cache_lru(cct->_conf.get_val<uint64_t>(
-      "ec_extent_cache_size"))
+      "ec_extent_cache_size"), osd->logger)
 {
   dout(0) << "using op scheduler " << *scheduler << dendl;
 }
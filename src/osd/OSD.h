@@ -1382,6 +1382,9 @@ public:
   ECExtentCache::LRU &lookup_ec_extent_cache_lru(spg_t pgid) const;
 
 private:
+  /// the EC extent cache LRUs of all shards, as seen by the store's autotuner
+  std::shared_ptr<ECExtentCache::PriCache> ec_extent_cache_pricache;
+
   class C_Tick;
   class C_Tick_WithoutOSDLock;
 
@@ -3066,6 +3066,23 @@ void OSDMap::pg_to_raw_up(pg_t pg, vector<int> *up, int *primary) const
   _apply_primary_affinity(pps, *pool, up, primary);
 }
 
+void OSDMap::_raw_to_up_acting_osds(
+  const pg_pool_t& pool, pg_t pg, ps_t pps,
+  vector<int> *raw, vector<int> *up, int *up_primary,
+  vector<int> *acting, int *acting_primary) const
+{
+  _apply_upmap(pool, pg, raw);
+  _raw_to_up_osds(pool, *raw, up);
+  *up_primary = _pick_primary(*up);
+  _apply_primary_affinity(pps, pool, up, up_primary);
+  if (acting->empty()) {
+    *acting = *up;
+    if (*acting_primary == -1) {
+      *acting_primary = *up_primary;
+    }
+  }
+}
+
 void OSDMap::_pg_to_up_acting_osds(
   const pg_t& pg, vector<int> *up, int *up_primary,
   vector<int> *acting, int *acting_primary,
@@ -3093,17 +3110,9 @@ void OSDMap::_pg_to_up_acting_osds(
   _get_temp_osds(*pool, pg, &_acting, &_acting_primary);
   if (_acting.empty() || up || up_primary) {
     _pg_to_raw_osds(*pool, pg, &raw, &pps);
-    _apply_upmap(*pool, pg, &raw);
-    _raw_to_up_osds(*pool, raw, &_up);
-    _up_primary = _pick_primary(_up);
-    _apply_primary_affinity(pps, *pool, &_up, &_up_primary);
-    if (_acting.empty()) {
-      _acting = _up;
-      if (_acting_primary == -1) {
-        _acting_primary = _up_primary;
-      }
-    }
-  
+    _raw_to_up_acting_osds(*pool, pg, pps, &raw, &_up, &_up_primary,
+                           &_acting, &_acting_primary);
+
     if (up)
       up->swap(_up);
     if (up_primary)
@@ -3116,6 +3125,43 @@ void OSDMap::_pg_to_up_acting_osds(
     *acting_primary = _acting_primary;
 }
 
+void OSDMap::pg_range_to_up_acting_osds(
+  int64_t pool, unsigned ps_begin, unsigned ps_end,
+  const std::function<void(ps_t ps,
+			   vector<int>&& up, int up_primary,
+			   vector<int>&& acting, int acting_primary)>& f) const
+{
+  const pg_pool_t *pi = get_pg_pool(pool);
+  ceph_assert(pi);
+  ceph_assert(ps_begin <= ps_end);
+  ceph_assert(ps_end <= pi->get_pg_num());
+
+  // the placement seeds, as _pg_to_raw_osds() computes them
+  vector<int> pps;
+  pps.reserve(ps_end - ps_begin);
+  for (unsigned ps = ps_begin; ps < ps_end; ++ps) {
+    pps.push_back(pi->raw_pg_to_pps(pg_t(ps, pool)));
+  }
+  vector<vector<int>> raws;
+  int ruleno = pi->get_crush_rule();
+  if (ruleno >= 0) {
+    crush->do_rule_batch(ruleno, pps, raws, pi->get_size(), osd_weight, pool);
+  } else {
+    raws.resize(pps.size());
+  }
+
+  for (unsigned i = 0; i < pps.size(); ++i) {
+    pg_t pg(ps_begin + i, pool);
+    vector<int> up, acting;
+    int up_primary, acting_primary;
+    _remove_nonexistent_osds(*pi, raws[i]);
+    _get_temp_osds(*pi, pg, &acting, &acting_primary);
+    _raw_to_up_acting_osds(*pi, pg, pps[i], &raws[i], &up, &up_primary,
+                           &acting, &acting_primary);
+    f(pg.ps(), std::move(up), up_primary, std::move(acting), acting_primary);
+  }
+}
+
 int OSDMap::calc_pg_role_broken(int osd, const vector<int>& acting, int nrep)
 {
   // This implementation is broken for EC PGs since the osd may appear
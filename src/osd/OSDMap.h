@@ -25,6 +25,7 @@
  *   disks, disk groups, total # osds,
  *
  */
+#include <functional>
 #include <vector>
 #include <list>
 #include <set>
@@ -1270,6 +1271,17 @@ private:
   void _get_temp_osds(const pg_pool_t& pool, pg_t pg,
                       std::vector<int> *temp_pg, int *temp_primary) const;
 
+  /**
+   * The up and acting osds of a pg from its raw crush mapping, with the
+   * nonexistent osds removed. acting and acting_primary hold the temp
+   * mapping from _get_temp_osds() on entry.
+   */
+  void _raw_to_up_acting_osds(const pg_pool_t& pool, pg_t pg, ps_t pps,
+                              std::vector<int> *raw,
+                              std::vector<int> *up, int *up_primary,
+                              std::vector<int> *acting,
+                              int *acting_primary) const;
+
   /**
    *  map to up and acting. Fills in whatever fields are non-NULL.
    */
@@ -1315,6 +1327,17 @@ public:
     int up_primary, acting_primary;
     pg_to_up_acting_osds(pg, &up, &up_primary, &acting, &acting_primary);
   }
+  /**
+   * pg_to_up_acting_osds() for the pgs [ps_begin, ps_end) of a pool,
+   * with crush mapping all of them at once. f is called for each pg
+   * in order.
+   */
+  void pg_range_to_up_acting_osds(
+    int64_t pool, unsigned ps_begin, unsigned ps_end,
+    const std::function<void(ps_t ps,
+			     std::vector<int>&& up, int up_primary,
+			     std::vector<int>&& acting,
+			     int acting_primary)>& f) const;
   bool pg_is_ec(pg_t pg) const {
     auto i = pools.find(pg.pool());
     ceph_assert(i != pools.end());
@@ -719,6 +719,7 @@ void PG::clear_recovery_state()
   backfill_info.clear();
   peer_backfill_info.clear();
   waiting_on_backfill.clear();
+  backfill_scans_ahead.clear();
   _clear_recovery_state();  // pg impl specific hook
 }
 
@@ -1558,7 +1559,8 @@ void PG::on_backfill_suspended()
   // Scan replies asked before suspending this backfill should be ignored.
   // See PrimaryLogPG::do_scan -  case MOSDPGScan::OP_SCAN_DIGEST.
   // `waiting_on_backfill` will be re-refilled after the suspended backfill
-  // is resumed/restarted.
+  // is resumed/restarted. Read-ahead scans in backfill_scans_ahead are
+  // kept: their replies still extend peer_backfill_info when they arrive.
   if (!waiting_on_backfill.empty()) {
     waiting_on_backfill.clear();
     finish_recovery_op(hobject_t::get_max());
@@ -859,6 +859,8 @@ protected:
 
   int recovery_ops_active;
   std::set<pg_shard_t> waiting_on_backfill;
+  /// backfill targets with a read-ahead scan (OP_SCAN_GET_DIGEST) in flight
+  std::set<pg_shard_t> backfill_scans_ahead;
 #ifdef DEBUG_RECOVERY_OIDS
   multiset<hobject_t> recovering_oids;
 #endif
@@ -48,8 +48,8 @@ void PGLog::IndexedLog::split_out_child(
 {
   unindex();
   *target = IndexedLog(pg_log_t::split_out_child(child_pgid, split_bits));
-  index();
-  target->index();
+  // as for a loaded log, the reqid indexes of both are built on demand
+  index(PGLOG_INDEXED_OBJECTS);
   reset_rollback_info_trimmed_to_riter();
 }
 
@@ -189,6 +189,8 @@ void PGLog::clear() {
   log.clear();
   log_keys_debug.clear();
   undirty();
+  written_can_rollback_to = eversion_t::max();
+  written_rollback_info_trimmed_to = eversion_t::max();
 }
 
 void PGLog::clear_info_log(
@@ -664,6 +666,18 @@ void PGLog::write_log_and_missing(
 	     << ", trimmed_dups: " << trimmed_dups
 	     << ", clear_divergent_priors: " << clear_divergent_priors
 	     << dendl;
+    // can_rollback_to and rollback_info_trimmed_to only need to go out
+    // when they moved since the last write. Client writes on EC pools
+    // move both, but recovery transactions, which only touch the missing
+    // set, leave them be
+    const bool write_rollback_info = require_rollback &&
+      (!touched_log ||
+       written_can_rollback_to != log.get_can_rollback_to() ||
+       written_rollback_info_trimmed_to != log.get_rollback_info_trimmed_to());
+    if (require_rollback && !write_rollback_info) {
+      dout(20) << "write_log_and_missing rollback info unchanged, "
+	       << "not rewriting it" << dendl;
+    }
     _write_log_and_missing(
       t, km, log, coll, log_oid,
       dirty_to,
@@ -673,7 +687,7 @@ void PGLog::write_log_and_missing(
       std::move(trimmed_dups),
       missing,
       !touched_log,
-      require_rollback,
+      write_rollback_info,
       clear_divergent_priors,
       dirty_to_dups,
       dirty_from_dups,
@@ -681,6 +695,10 @@ void PGLog::write_log_and_missing(
       &may_include_deletes_in_missing_dirty,
       (pg_log_debug ? &log_keys_debug : nullptr),
       this);
+    if (write_rollback_info) {
+      written_can_rollback_to = log.get_can_rollback_to();
+      written_rollback_info_trimmed_to = log.get_rollback_info_trimmed_to();
+    }
     undirty();
   } else {
     dout(10) << "log is not dirty" << dendl;
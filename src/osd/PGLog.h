@@ -229,7 +229,13 @@ public:
 	++rollback_info_trimmed_to_riter;
     }
 
-    // indexes objects, caller ops and extra caller ops
+    // Only the objects index is built up front, as recovery and backfill
+    // look it up directly. The reqid indexes (caller ops, extra caller ops
+    // and dups) are built on the first get_request()/logged_req(). The
+    // primary calls get_request() for every client write to detect resent
+    // ops, so an active primary builds them on its first write; the saving
+    // is for replicas, which never look them up, and for PGs that stop
+    // being primary, which drop them with unindex_requests().
   public:
     IndexedLog() :
       complete_to(log.end()),
@@ -247,7 +253,7 @@ public:
       rollback_info_trimmed_to_riter(log.rbegin())
     {
       reset_rollback_info_trimmed_to_riter();
-      index();
+      index(PGLOG_INDEXED_OBJECTS);
     }
 
     IndexedLog(const IndexedLog &rhs) :
@@ -299,7 +305,9 @@ public:
 
     mempool::osd_pglog::list<pg_log_entry_t> rewind_from_head(eversion_t newhead, bool *dirty_log = nullptr) {
       auto divergent = pg_log_t::rewind_from_head(newhead, dirty_log);
-      index();
+      // the divergent entries may still be referenced by the reqid indexes
+      unindex();
+      index(PGLOG_INDEXED_OBJECTS);
       reset_rollback_info_trimmed_to_riter();
       return divergent;
     }
@@ -328,7 +336,6 @@ public:
       *this = IndexedLog(o);
 
       skip_can_rollback_to_to_head();
-      index();
     }
 
     void split_out_child(
@@ -604,6 +611,14 @@ public:
       indexed_data = 0;
     }
 
+    /// drop the reqid indexes; they are rebuilt on the next lookup
+    void unindex_requests() {
+      caller_ops.clear();
+      extra_caller_ops.clear();
+      dup_index.clear();
+      indexed_data &= PGLOG_INDEXED_OBJECTS;
+    }
+
     void unindex(const pg_log_entry_t& e) {
       // NOTE: this only works if we remove from the _tail_ of the log!
       if (indexed_data & PGLOG_INDEXED_OBJECTS) {
@@ -735,6 +750,10 @@ protected:
   bool dirty_log;
   bool clear_divergent_priors;
   bool may_include_deletes_in_missing_dirty = false;
+  /// can_rollback_to and rollback_info_trimmed_to as last written out,
+  /// eversion_t::max() if unknown
+  eversion_t written_can_rollback_to = eversion_t::max();
+  eversion_t written_rollback_info_trimmed_to = eversion_t::max();
 
   void mark_dirty_to(eversion_t to) {
     if (to > dirty_to)
@@ -781,6 +800,8 @@ public:
     mark_dirty_to_dups(eversion_t::max());
     mark_dirty_from_dups(eversion_t());
     touched_log = false;
+    written_can_rollback_to = eversion_t::max();
+    written_rollback_info_trimmed_to = eversion_t::max();
   }
   bool get_may_include_deletes_in_missing_dirty() const {
     return may_include_deletes_in_missing_dirty;
@@ -870,6 +891,8 @@ public:
 
   void unindex() { log.unindex(); }
 
+  void unindex_requests() { log.unindex_requests(); }
+
   void add(const pg_log_entry_t& e, enum NonPrimary nonprimary, bool applied, pg_info_t *info, LogEntryHandler *h) {
     mark_writeout_from(e.version);
     log.add(e, nonprimary, applied, info, h);
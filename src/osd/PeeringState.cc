@@ -850,6 +850,10 @@ void PeeringState::start_peering_interval(
     // did primary change?
     if (was_old_primary != is_primary()) {
       state_clear(PG_STATE_CLEAN);
+      if (was_old_primary) {
+	// only the primary looks up resent ops
+	pg_log.unindex_requests();
+      }
     }
 
     pl->on_role_change();
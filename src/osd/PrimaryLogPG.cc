@@ -4569,13 +4569,34 @@ void PrimaryLogPG::do_scan(
       ceph_assert(is_backfill_target(from));
 
       ReplicaBackfillInterval& bi = peer_backfill_info[from];
-      bi.begin = m->begin;
-      bi.end = m->end;
       auto p = m->get_data().cbegin();
+      if (backfill_scans_ahead.erase(from)) {
+	std::map<hobject_t, eversion_t> objects;
+	decode_noclear(objects, p);
+	// [m->begin, m->end) normally directly follows the objects we
+	// still hold
+	if (!bi.extend(m->begin, m->end, std::move(objects))) {
+	  // the interval was reset while the read-ahead was in flight
+	  dout(10) << __func__ << " dropping stale read-ahead scan "
+		   << m->begin << "-" << m->end << " from " << from
+		   << ", interval now " << bi.begin << "-" << bi.end << dendl;
+	  if (waiting_on_backfill.count(from)) {
+	    // recover_backfill() waits on this read-ahead instead of
+	    // scanning, ask for the range it actually needs
+	    dout(10) << __func__ << " rescanning peer osd." << from
+		     << " from " << bi.end << dendl;
+	    send_backfill_scan(from, bi.end);
+	  }
+	  break;
+	}
+      } else {
+	bi.begin = m->begin;
+	bi.end = m->end;
 
-      // take care to preserve ordering!
-      bi.clear_objects();
-      decode_noclear(bi.objects, p);
+	// take care to preserve ordering!
+	bi.clear_objects();
+	decode_noclear(bi.objects, p);
+      }
       dout(10) << __func__ << " bi.begin=" << bi.begin << " bi.end=" << bi.end
                << " bi.objects.size()=" << bi.objects.size() << dendl;
 
@@ -14014,6 +14035,8 @@ uint64_t PrimaryLogPG::recover_backfill(
   }
   backfill_info.trim_to(last_backfill_started);
 
+  const bool scan_ahead =
+    cct->_conf.get_val<bool>("osd_backfill_scan_ahead");
   PGBackend::RecoveryHandle *h = pgbackend->open_recovery_op();
   while (ops < max) {
     if (backfill_info.begin <= earliest_peer_backfill() &&
@@ -14037,22 +14060,29 @@ uint64_t PrimaryLogPG::recover_backfill(
       dout(20) << " peer shard " << bt << " backfill " << pbi << dendl;
       if (pbi.begin <= backfill_info.begin &&
 	  !pbi.extends_to_end() && pbi.empty()) {
-	dout(10) << " scanning peer osd." << bt << " from " << pbi.end << dendl;
-	epoch_t e = get_osdmap_epoch();
-	MOSDPGScan *m = new MOSDPGScan(
-	  MOSDPGScan::OP_SCAN_GET_DIGEST, pg_whoami, e, get_last_peering_reset(),
-	  spg_t(info.pgid.pgid, bt.shard),
-	  pbi.end, hobject_t());
-
-	if (cct->_conf->osd_op_queue == "mclock_scheduler") {
-	  /* This guard preserves legacy WeightedPriorityQueue behavior for
-	   * now, but should be removed after Reef */
-	  m->set_priority(recovery_state.get_recovery_op_priority());
-	}
-	osd->send_message_osd_cluster(bt.osd, m, get_osdmap_epoch());
 	ceph_assert(waiting_on_backfill.find(bt) == waiting_on_backfill.end());
+	if (backfill_scans_ahead.count(bt)) {
+	  // the next range was already requested; just wait for it
+	  dout(10) << " waiting on read-ahead scan of peer osd." << bt
+		   << " from " << pbi.end << dendl;
+	} else {
+	  dout(10) << " scanning peer osd." << bt << " from " << pbi.end << dendl;
+	  send_backfill_scan(bt, pbi.end);
+	}
 	waiting_on_backfill.insert(bt);
         sent_scan = true;
+      } else if (scan_ahead &&
+		 !pbi.extends_to_end() &&
+		 !backfill_scans_ahead.count(bt) &&
+		 pbi.objects.size() <
+		   static_cast<size_t>(cct->_conf->osd_backfill_scan_min)) {
+	// Ask for the next range while the remaining objects of this one
+	// are processed, so that we don't stall on a scan round trip every
+	// osd_backfill_scan_max objects.  The reply is appended to pbi.
+	dout(10) << " scanning ahead peer osd." << bt << " from " << pbi.end
+		 << dendl;
+	send_backfill_scan(bt, pbi.end);
+	backfill_scans_ahead.insert(bt);
       }
     }
 
@@ -14338,6 +14368,24 @@ uint64_t PrimaryLogPG::recover_backfill(
   return ops;
 }
 
+void PrimaryLogPG::send_backfill_scan(
+  const pg_shard_t &bt,
+  const hobject_t &begin)
+{
+  epoch_t e = get_osdmap_epoch();
+  MOSDPGScan *m = new MOSDPGScan(
+    MOSDPGScan::OP_SCAN_GET_DIGEST, pg_whoami, e, get_last_peering_reset(),
+    spg_t(info.pgid.pgid, bt.shard),
+    begin, hobject_t());
+
+  if (cct->_conf->osd_op_queue == "mclock_scheduler") {
+    /* This guard preserves legacy WeightedPriorityQueue behavior for
+     * now, but should be removed after Reef */
+    m->set_priority(recovery_state.get_recovery_op_priority());
+  }
+  osd->send_message_osd_cluster(bt.osd, m, get_osdmap_epoch());
+}
+
 int PrimaryLogPG::prep_backfill_object_push(
   hobject_t oid, eversion_t v,
   ObjectContextRef obc,
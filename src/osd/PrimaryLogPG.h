@@ -1141,6 +1141,10 @@ protected:
         p != waiting_on_backfill.end(); ++p)
       f->dump_stream("osd") << *p;
     f->close_section();
+    f->open_array_section("backfill_scans_ahead");
+    for (const auto& p : backfill_scans_ahead)
+      f->dump_stream("osd") << p;
+    f->close_section();
     f->dump_stream("last_backfill_started") << last_backfill_started;
     {
       f->open_object_section("backfill_info");
@@ -1355,6 +1359,9 @@ protected:
     ThreadPool::TPHandle &handle ///< [in] tp handle
     );
 
+  /// Ask backfill target @bt for the objects and versions from @begin on
+  void send_backfill_scan(const pg_shard_t &bt, const hobject_t &begin);
+
   int prep_backfill_object_push(
     hobject_t oid, eversion_t v, ObjectContextRef obc,
     std::vector<pg_shard_t> peers,
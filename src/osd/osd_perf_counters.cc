@@ -184,6 +184,24 @@ PerfCounters *build_osd_logger(CephContext *cct) {
    l_osd_rbytes, "recovery_bytes",
    "recovery bytes",
    "rbt", PerfCountersBuilder::PRIO_INTERESTING);
+  osd_plb.add_u64_counter(
+    l_osd_ec_recovery_read_bytes, "ec_recovery_read_bytes",
+    "Bytes read from other shards to recover EC objects",
+    NULL, 0, unit_t(UNIT_BYTES));
+  osd_plb.add_u64_counter(
+    l_osd_ec_recovery_read_bytes_saved, "ec_recovery_read_bytes_saved",
+    "EC recovery bytes not read thanks to sub-chunk repair",
+    NULL, 0, unit_t(UNIT_BYTES));
+  osd_plb.add_u64_counter(
+    l_osd_ec_extent_cache_hit, "ec_extent_cache_hit",
+    "EC writes whose reads were all served by the extent cache");
+  osd_plb.add_u64_counter(
+    l_osd_ec_extent_cache_miss, "ec_extent_cache_miss",
+    "EC writes which had to read from shards");
+  osd_plb.add_u64_counter(
+    l_osd_ec_extent_cache_bytes_saved, "ec_extent_cache_bytes_saved",
+    "Shard reads of EC writes served by the extent cache",
+    NULL, 0, unit_t(UNIT_BYTES));
 
   osd_plb.add_time_avg(
     l_osd_recovery_push_queue_lat,
@@ -66,6 +66,11 @@ enum osd_counter_idx_t {
 
   l_osd_rop,
   l_osd_rbytes,
+  l_osd_ec_recovery_read_bytes,
+  l_osd_ec_recovery_read_bytes_saved,
+  l_osd_ec_extent_cache_hit,
+  l_osd_ec_extent_cache_miss,
+  l_osd_ec_extent_cache_bytes_saved,
 
   l_osd_recovery_push_queue_lat,
   l_osd_recovery_push_reply_queue_lat,
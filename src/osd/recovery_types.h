@@ -152,6 +152,19 @@ public:
     *this = ReplicaBackfillInterval();
   }
 
+  /// append the objects of the scan of [scan_begin, scan_end), which must
+  /// directly follow this interval; false (and unchanged) if it doesn't
+  bool extend(const hobject_t &scan_begin, const hobject_t &scan_end,
+	      std::map<hobject_t, eversion_t> &&scan_objects) {
+    if (scan_begin != end) {
+      return false;
+    }
+    end = scan_end;
+    objects.merge(scan_objects);
+    trim();
+    return true;
+  }
+
   /// drop first entry, and adjust @begin accordingly
   void pop_front() {
     ceph_assert(!objects.empty());
@@ -176,6 +176,9 @@ bool OsdScrub::is_sched_target_eligible(
   if (r.cpu_overloaded && ScrubJob::observes_load_limit(e.urgency)) {
     return false;
   }
+  if (r.client_latency_high && ScrubJob::observes_load_limit(e.urgency)) {
+    return false;
+  }
   if (r.recovery_in_progress && ScrubJob::observes_recovery(e.urgency)) {
     return false;
   }
@@ -212,6 +215,7 @@ Scrub::OSDRestrictions OsdScrub::restrictions_on_scrubbing(
 
   env_conditions.restricted_time = !scrub_time_permit(scrub_clock_now);
   env_conditions.cpu_overloaded = !scrub_load_below_threshold();
+  env_conditions.client_latency_high = m_client_latency_high;
 
   return env_conditions;
 }
@@ -309,6 +313,49 @@ bool OsdScrub::scrub_load_below_threshold() const
 }
 
 
+void OsdScrub::update_client_latency(uint64_t lat_sum_ns, uint64_t op_count)
+{
+  const auto [prev_sum_ns, prev_count] = m_last_client_lat;
+  m_last_client_lat = {lat_sum_ns, op_count};
+
+  const double target =
+      conf.get_val<double>("osd_scrub_target_client_latency");
+  if (target <= 0.0) {
+    m_chunk_factor = 1.0;
+    m_client_latency_high = false;
+    m_resource_bookkeeper.set_concurrency_factor(1.0);
+    return;
+  }
+
+  double factor = m_chunk_factor;
+  if (op_count > prev_count && lat_sum_ns >= prev_sum_ns) {
+    const double avg_lat =
+	static_cast<double>(lat_sum_ns - prev_sum_ns) / 1e9 /
+	(op_count - prev_count);
+    if (avg_lat > target) {
+      // back off quickly. Only if that did not suffice - stop starting
+      // new regular scrubs
+      m_client_latency_high = (factor <= min_chunk_factor);
+      factor = std::max(min_chunk_factor, factor / 2);
+    } else {
+      m_client_latency_high = false;
+      factor = std::min(1.0, factor + min_chunk_factor);
+    }
+    dout(20) << fmt::format(
+		    "client op latency {:.6f}s (target {:.6f}s): chunk factor {}",
+		    avg_lat, target, factor)
+	     << dendl;
+  } else {
+    // no client ops since the last sample
+    m_client_latency_high = false;
+    factor = std::min(1.0, factor + min_chunk_factor);
+  }
+  m_chunk_factor = factor;
+  // fewer concurrent scrubs, too
+  m_resource_bookkeeper.set_concurrency_factor(factor);
+}
+
+
 // ////////////////////////////////////////////////////////////////////////// //
 
 // checks for half-closed ranges. Modify the (p<till)to '<=' to check for
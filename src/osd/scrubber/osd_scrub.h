@@ -2,6 +2,7 @@
 // vim: ts=8 sw=2 sts=2 expandtab
 
 #pragma once
+#include <atomic>
 #include <string_view>
 
 #include "osd/osd_types_fmt.h"
@@ -21,6 +22,8 @@
  *    (as it is not yet protected by any single OSDservice lock).
  */
 class OsdScrub {
+  friend class TestOSDScrub;
+
  public:
   OsdScrub(
       CephContext* cct,
@@ -132,6 +135,30 @@ class OsdScrub {
    */
   std::optional<double> update_load_average();
 
+  /**
+   * Sample the cumulative client op latency (the sum, in ns, and the
+   * number of ops of the l_osd_op_lat counter). Called by the OSD heartbeat.
+   * The average latency since the previous sample is compared with
+   * osd_scrub_target_client_latency to adjust chunk_size_factor(), which
+   * also scales the number of concurrent scrubs allowed (osd_max_scrubs).
+   */
+  void update_client_latency(uint64_t lat_sum_ns, uint64_t op_count);
+
+  /**
+   * \returns the fraction (1/8 to 1) of the configured maximal chunk size
+   * that scrubs should currently use
+   */
+  double chunk_size_factor() const { return m_chunk_factor; }
+
+  /**
+   * \returns the configured maximal chunk size (\c max_from_conf), scaled
+   * by chunk_size_factor()
+   */
+  int adapted_chunk_max(int max_from_conf) const
+  {
+    return std::max(1, static_cast<int>(max_from_conf * m_chunk_factor));
+  }
+
    // the scrub performance counters collections
    // ---------------------------------------------------------------
   PerfCounters* get_perf_counters(int pool_type, scrub_level_t level);
@@ -215,6 +242,20 @@ class OsdScrub {
   /// the number of CPUs) is below the configured threshold
   bool scrub_load_below_threshold() const;
 
+  // adapting to the client op latency
+  // ---------------------------------------------------------------
+
+  static constexpr double min_chunk_factor = 1.0 / 8;
+
+  /// the l_osd_op_lat (sum in ns, count) at the previous sample
+  std::pair<uint64_t, uint64_t> m_last_client_lat{0, 0};
+
+  /// halved while client latency is above the target, then slowly restored
+  std::atomic<double> m_chunk_factor{1.0};
+
+  /// client latency is above the target even at min_chunk_factor
+  std::atomic<bool> m_client_latency_high{false};
+
 
   // the scrub performance counters collections
   // ---------------------------------------------------------------
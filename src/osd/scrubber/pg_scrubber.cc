@@ -1003,13 +1003,18 @@ std::optional<uint64_t> PgScrubber::select_range()
   const int max_from_conf = static_cast<int>(size_from_conf(
       m_is_deep, conf, osd_scrub_chunk_max, osd_shallow_scrub_chunk_max));
 
+  // scrub in smaller chunks while client ops are slower than targeted
+  const double load_factor =
+      m_osds->get_scrub_services().chunk_size_factor();
   const int min_chunk_sz = std::max(3, min_from_conf);
   const int divisor = static_cast<int>(preemption_data.chunk_divisor());
-  const int max_chunk_sz = std::max(min_chunk_sz, max_from_conf / divisor);
+  const int max_chunk_sz = std::max(
+      min_chunk_sz,
+      m_osds->get_scrub_services().adapted_chunk_max(max_from_conf) / divisor);
 
   dout(10) << fmt::format(
-		  "{}: Min: {} Max: {} Div: {}", __func__, min_chunk_sz,
-		  max_chunk_sz, divisor)
+		  "{}: Min: {} Max: {} Div: {} Load factor: {}", __func__,
+		  min_chunk_sz, max_chunk_sz, divisor, load_factor)
 	   << dendl;
 
   hobject_t start = m_start;
@@ -3,6 +3,8 @@
 
 #include "./scrub_resources.h"
 
+#include <algorithm>
+
 #include <fmt/format.h>
 #include <fmt/ranges.h>
 
@@ -33,6 +35,17 @@ bool ScrubResources::can_inc_scrubs() const
   return can_inc_local_scrubs_unlocked();
 }
 
+void ScrubResources::set_concurrency_factor(double factor)
+{
+  concurrency_factor = std::clamp(factor, 0.0, 1.0);
+}
+
+int ScrubResources::max_scrubs() const
+{
+  return std::max(
+      1, static_cast<int>(conf->osd_max_scrubs * concurrency_factor));
+}
+
 std::unique_ptr<LocalResourceWrapper> ScrubResources::inc_scrubs_local(
     bool is_high_priority)
 {
@@ -41,7 +54,7 @@ std::unique_ptr<LocalResourceWrapper> ScrubResources::inc_scrubs_local(
     ++scrubs_local;
     log_upwards(fmt::format(
 	"{}: {} -> {} (max {})", __func__, (scrubs_local - 1), scrubs_local,
-	conf->osd_max_scrubs));
+	max_scrubs()));
     return std::make_unique<LocalResourceWrapper>(*this);
   }
   return nullptr;
@@ -49,12 +62,12 @@ std::unique_ptr<LocalResourceWrapper> ScrubResources::inc_scrubs_local(
 
 bool ScrubResources::can_inc_local_scrubs_unlocked() const
 {
-  if (scrubs_local < conf->osd_max_scrubs) {
+  if (scrubs_local < max_scrubs()) {
     return true;
   }
   log_upwards(fmt::format(
       "{}: Cannot add local scrubs. Current counter ({}) >= max ({})", __func__,
-      scrubs_local, conf->osd_max_scrubs));
+      scrubs_local, max_scrubs()));
   return false;
 }
 
@@ -63,7 +76,7 @@ void ScrubResources::dec_scrubs_local()
   std::lock_guard lck{resource_lock};
   log_upwards(fmt::format(
       "{}:  {} -> {} (max {})", __func__, scrubs_local, (scrubs_local - 1),
-      conf->osd_max_scrubs));
+      max_scrubs()));
   --scrubs_local;
   ceph_assert(scrubs_local >= 0);
 }
@@ -74,6 +87,7 @@ void ScrubResources::dump_scrub_reservations(ceph::Formatter* f) const
   std::lock_guard lck{resource_lock};
   f->dump_int("scrubs_local", scrubs_local);
   f->dump_int("osd_max_scrubs", conf->osd_max_scrubs);
+  f->dump_int("max_scrubs", max_scrubs());
 }
 
 // --------------- LocalResourceWrapper
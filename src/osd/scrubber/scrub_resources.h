@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <functional>
 #include <string>
 
@@ -39,6 +40,10 @@ class ScrubResources {
    */
   int scrubs_local{0};
 
+  /// scales osd_max_scrubs down while client ops are slow (see
+  /// OsdScrub::update_client_latency())
+  std::atomic<double> concurrency_factor{1.0};
+
   mutable ceph::mutex resource_lock =
       ceph::make_mutex("ScrubQueue::resource_lock");
 
@@ -50,6 +55,9 @@ class ScrubResources {
   /// the resource lock held.
   bool can_inc_local_scrubs_unlocked() const;
 
+  /// osd_max_scrubs, scaled by the concurrency factor (at least 1)
+  int max_scrubs() const;
+
  public:
   explicit ScrubResources(
       log_upwards_t log_access,
@@ -61,6 +69,12 @@ class ScrubResources {
    */
   bool can_inc_scrubs() const;
 
+  /**
+   * limit the number of concurrent regular scrubs to a fraction (0 to 1]
+   * of osd_max_scrubs. At least one scrub is always allowed.
+   */
+  void set_concurrency_factor(double factor);
+
   /// increments the number of scrubs acting as a Primary
   std::unique_ptr<LocalResourceWrapper> inc_scrubs_local(bool is_high_priority);
 
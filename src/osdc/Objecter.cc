@@ -420,6 +420,14 @@ void Objecter::init()
 
   update_crush_location();
 
+  if (auto threads = cct->_conf.get_val<uint64_t>("objecter_pg_mapping_threads");
+      threads > 0) {
+    pg_mapper_tp = std::make_unique<ThreadPool>(cct, "Objecter::pg_mapper_tp",
+						"objecter_map", threads);
+    pg_mapper = std::make_unique<ParallelPGMapper>(cct, pg_mapper_tp.get());
+    pg_mapper_tp->start();
+  }
+
   cct->_conf.add_observer(this);
 
   initialized = true;
@@ -430,12 +438,14 @@ void Objecter::init()
  */
 void Objecter::start(const OSDMap* o)
 {
+  std::lock_guard ml(map_lock);
   shared_lock rl(rwlock);
 
   start_tick();
   if (o) {
     osdmap->deepish_copy_from(*o);
     prune_pg_mapping(osdmap->get_pools());
+    _start_pg_mapping(osdmap);
   } else if (osdmap->get_epoch() == 0) {
     _maybe_request_map();
   }
@@ -451,6 +461,10 @@ void Objecter::shutdown()
 
   wl.unlock();
   cct->_conf.remove_observer(this);
+  {
+    std::lock_guard ml(map_lock);
+    _stop_pg_mapping();
+  }
   wl.lock();
 
   while (!osd_sessions.empty()) {
@@ -1081,6 +1095,7 @@ Dispatcher::dispatch_result_t Objecter::ms_dispatch2(const MessageRef &m)
 void Objecter::_scan_requests(
   OSDSession *s,
   bool skipped_map,
+  const target_changes_t *changes,
   bool cluster_full,
   map<int64_t, bool> *pool_full_map,
   map<ceph_tid_t, Op*>& need_resend,
@@ -1147,7 +1162,11 @@ void Objecter::_scan_requests(
     if (pool_full_map)
       force_resend_writes = force_resend_writes ||
 	(*pool_full_map)[op->target.base_oloc.pool];
-    int r = _calc_target(&op->target);
+    int r = RECALC_OP_TARGET_NO_ACTION;
+    if (!changes || s->is_homeless() || op->target.paused ||
+	changes->may_change(op->target)) {
+      r = _calc_target(&op->target);
+    }
     switch (r) {
     case RECALC_OP_TARGET_NO_ACTION:
       if (!skipped_map && !(force_resend_writes && op->target.respects_full()))
@@ -1207,19 +1226,231 @@ void Objecter::_scan_requests(
   }
 }
 
+std::optional<Objecter::target_changes_t>
+Objecter::target_changes_t::diff(int prev_flags,
+				 ceph_release_t prev_require_osd_release,
+				 const OSDMap::Incremental& inc,
+				 const OSDMap& next)
+{
+  if (inc.fullmap.length() ||
+      inc.crush.length() ||
+      inc.new_max_osd >= 0 ||
+      !inc.new_up_client.empty() ||
+      !inc.new_state.empty() ||
+      !inc.new_weight.empty() ||
+      !inc.new_primary_affinity.empty() ||
+      inc.change_stretch_mode ||
+      prev_flags != next.get_flags() ||
+      prev_require_osd_release != next.require_osd_release) {
+    return std::nullopt;
+  }
+
+  target_changes_t changes;
+  for (auto& [pool, pi] : inc.new_pools) {
+    changes.pools.insert(pool);
+  }
+  changes.pools.insert(inc.old_pools.begin(), inc.old_pools.end());
+  for (auto& [pgid, osds] : inc.new_pg_temp) {
+    changes.pgs.insert(pgid);
+  }
+  for (auto& [pgid, osd] : inc.new_primary_temp) {
+    changes.pgs.insert(pgid);
+  }
+  for (auto& [pgid, osds] : inc.new_pg_upmap) {
+    changes.pgs.insert(pgid);
+  }
+  for (auto& [pgid, items] : inc.new_pg_upmap_items) {
+    changes.pgs.insert(pgid);
+  }
+  for (auto& [pgid, osd] : inc.new_pg_upmap_primary) {
+    changes.pgs.insert(pgid);
+  }
+  changes.pgs.insert(inc.old_pg_upmap.begin(), inc.old_pg_upmap.end());
+  changes.pgs.insert(inc.old_pg_upmap_items.begin(),
+		     inc.old_pg_upmap_items.end());
+  changes.pgs.insert(inc.old_pg_upmap_primary.begin(),
+		     inc.old_pg_upmap_primary.end());
+  return changes;
+}
+
+bool Objecter::target_changes_t::may_change(const op_target_t& t) const
+{
+  return (pools.count(t.base_oloc.pool) ||
+	  pools.count(t.target_oloc.pool) ||
+	  pgs.count(t.actual_pgid.pgid));
+}
+
+void Objecter::_start_pg_mapping(const std::shared_ptr<const OSDMap>& map)
+{
+  // map_lock is locked
+  if (!pg_mapper) {
+    return;
+  }
+  if (pg_mapping_job) {
+    ldout(cct, 10) << __func__ << " canceling previous pg mapping job "
+		   << pg_mapping_job.get() << dendl;
+    pg_mapping_job->abort();
+    pg_mapping_job.reset();
+  }
+  if (map->get_pools().empty()) {
+    return;
+  }
+  // the job only points to the map and the mapping, which are kept
+  // around until it completes or is aborted
+  auto mapping = std::make_shared<OSDMapMapping>();
+  pg_mapping_job = mapping->start_update(
+    *map, *pg_mapper,
+    cct->_conf.get_val<uint64_t>("objecter_pg_mapping_pgs_per_chunk"));
+  ldout(cct, 10) << __func__ << " started pg mapping job "
+		 << pg_mapping_job.get() << " for epoch " << map->get_epoch()
+		 << dendl;
+  pg_mapping_job->set_finish_event(
+    new LambdaContext([this, map, mapping=std::move(mapping)](int r) mutable {
+      if (r == 0) {
+	pg_mapping_table.store(std::move(mapping), std::memory_order_release);
+      }
+    }));
+}
+
+void Objecter::_stop_pg_mapping()
+{
+  // map_lock is locked
+  if (pg_mapping_job) {
+    pg_mapping_job->abort();
+    pg_mapping_job.reset();
+  }
+  if (pg_mapper_tp) {
+    pg_mapper_tp->stop();
+  }
+  pg_mapping_table.store(nullptr);
+}
+
+bool Objecter::_prepare_osd_maps(MOSDMap *m,
+				 vector<pending_osdmap_t>& pending)
+{
+  // map_lock is locked, rwlock is locked shared
+  const OSDMap *prev = osdmap.get();
+  if (m->get_last() <= prev->get_epoch()) {
+    return false;
+  }
+
+  if (!prev->get_epoch()) {
+    // first map.  we want the full thing.
+    if (m->maps.count(m->get_last())) {
+      ldout(cct, 3) << "handle_osd_map decoding full epoch "
+		    << m->get_last() << dendl;
+      auto& p = pending.emplace_back();
+      p.map = std::make_shared<OSDMap>();
+      p.map->decode(m->maps[m->get_last()]);
+    }
+    return false;
+  }
+
+  // The incrementals are applied in place to one copy of the last map.
+  // An epoch that cannot change any target is not looked at on its own,
+  // so the copy is only handed over, and copied again for the epochs
+  // that follow, where the requests are scanned.
+  std::shared_ptr<OSDMap> work;
+  auto hand_over = [&] {
+    if (work) {
+      ceph_assert(!pending.empty() && !pending.back().map);
+      pending.back().map = std::move(work);
+    }
+  };
+  bool skipped_map = false;
+  // we want incrementals
+  for (epoch_t e = prev->get_epoch() + 1;
+       e <= m->get_last();
+       e++) {
+    pending_osdmap_t p;
+    if (prev->get_epoch() == e-1 &&
+	m->incremental_maps.count(e)) {
+      ldout(cct, 3) << "handle_osd_map decoding incremental epoch " << e
+		    << dendl;
+      p.inc.emplace(m->incremental_maps[e]);
+      if (!work) {
+	work = std::make_shared<OSDMap>();
+	work->deepish_copy_from(*prev);
+      }
+      const auto prev_flags = work->get_flags();
+      const auto prev_require_osd_release = work->require_osd_release;
+      work->apply_incremental(*p.inc);
+      p.changes = target_changes_t::diff(prev_flags, prev_require_osd_release,
+					 *p.inc, *work);
+      prev = work.get();
+      logger->inc(l_osdc_map_inc);
+      p.skipped_map = skipped_map;
+      pending.push_back(std::move(p));
+      auto& last = pending.back();
+      if (skipped_map || !last.changes || !last.changes->empty() ||
+	  !last.inc->new_removed_snaps.empty()) {
+	hand_over();
+      }
+      continue;
+    }
+    hand_over();
+    if (m->maps.count(e)) {
+      ldout(cct, 3) << "handle_osd_map decoding full epoch " << e << dendl;
+      p.map = std::make_shared<OSDMap>();
+      p.map->decode(m->maps[e]);
+      logger->inc(l_osdc_map_full);
+    } else {
+      if (e >= m->cluster_osdmap_trim_lower_bound) {
+	ldout(cct, 3) << "handle_osd_map requesting missing epoch "
+		      << prev->get_epoch()+1 << dendl;
+	return true;
+      }
+      ldout(cct, 3) << "handle_osd_map missing epoch "
+		    << prev->get_epoch()+1
+		    << ", jumping to "
+		    << m->cluster_osdmap_trim_lower_bound << dendl;
+      e = m->cluster_osdmap_trim_lower_bound - 1;
+      skipped_map = true;
+      continue;
+    }
+    ceph_assert(e == p.map->get_epoch());
+    p.skipped_map = skipped_map;
+    prev = p.map.get();
+    pending.push_back(std::move(p));
+  }
+  hand_over();
+  return false;
+}
+
 void Objecter::handle_osd_map(MOSDMap *m)
 {
+  // The new epochs are decoded and applied to a copy of the current map
+  // while ops are still submitted against it.  rwlock is only taken
+  // exclusively to swap them in and to retarget the ops.
+  std::lock_guard ml(map_lock);
+  vector<pending_osdmap_t> pending;
+  bool missing_epoch;
+  epoch_t epoch;
+  {
+    shared_lock rl(rwlock);
+    if (!initialized)
+      return;
+
+    ceph_assert(osdmap);
+
+    if (m->fsid != monc->get_fsid()) {
+      ldout(cct, 0) << "handle_osd_map fsid " << m->fsid
+		    << " != " << monc->get_fsid() << dendl;
+      return;
+    }
+
+    epoch = osdmap->get_epoch();
+    missing_epoch = _prepare_osd_maps(m, pending);
+  }
+  if (!pending.empty()) {
+    _start_pg_mapping(pending.back().map);
+  }
+
   ceph::shunique_lock sul(rwlock, acquire_unique);
   if (!initialized)
     return;
 
-  ceph_assert(osdmap);
-
-  if (m->fsid != monc->get_fsid()) {
-    ldout(cct, 0) << "handle_osd_map fsid " << m->fsid
-		  << " != " << monc->get_fsid() << dendl;
-    return;
-  }
+  ceph_assert(osdmap->get_epoch() == epoch);
 
   bool was_pauserd = osdmap->test_flag(CEPH_OSDMAP_PAUSERD);
   bool cluster_full = _osdmap_full_flag();
@@ -1235,58 +1466,27 @@ void Objecter::handle_osd_map(MOSDMap *m)
   map<ceph_tid_t, Op*> need_resend;
   map<ceph_tid_t, CommandOp*> need_resend_command;
 
-  if (m->get_last() <= osdmap->get_epoch()) {
+  if (m->get_last() <= epoch) {
     ldout(cct, 3) << "handle_osd_map ignoring epochs ["
 		  << m->get_first() << "," << m->get_last()
-		  << "] <= " << osdmap->get_epoch() << dendl;
+		  << "] <= " << epoch << dendl;
   } else {
     ldout(cct, 3) << "handle_osd_map got epochs ["
 		  << m->get_first() << "," << m->get_last()
-		  << "] > " << osdmap->get_epoch() << dendl;
-
-    if (osdmap->get_epoch()) {
-      bool skipped_map = false;
-      // we want incrementals
-      for (epoch_t e = osdmap->get_epoch() + 1;
-	   e <= m->get_last();
-	   e++) {
-
-	if (osdmap->get_epoch() == e-1 &&
-	    m->incremental_maps.count(e)) {
-	  ldout(cct, 3) << "handle_osd_map decoding incremental epoch " << e
-			<< dendl;
-	  OSDMap::Incremental inc(m->incremental_maps[e]);
-	  osdmap->apply_incremental(inc);
-
-          emit_blocklist_events(inc);
-
-	  logger->inc(l_osdc_map_inc);
-	}
-	else if (m->maps.count(e)) {
-	  ldout(cct, 3) << "handle_osd_map decoding full epoch " << e << dendl;
-          auto new_osdmap = std::make_unique<OSDMap>();
-          new_osdmap->decode(m->maps[e]);
-
-          emit_blocklist_events(*osdmap, *new_osdmap);
-          osdmap = std::move(new_osdmap);
-
-	  logger->inc(l_osdc_map_full);
+		  << "] > " << epoch << dendl;
+
+    if (epoch) {
+      for (auto& p : pending) {
+	if (p.inc) {
+	  emit_blocklist_events(*p.inc);
+	} else {
+	  emit_blocklist_events(*osdmap, *p.map);
 	}
-	else {
-	  if (e >= m->cluster_osdmap_trim_lower_bound) {
-	    ldout(cct, 3) << "handle_osd_map requesting missing epoch "
-			  << osdmap->get_epoch()+1 << dendl;
-	    _maybe_request_map();
-	    break;
-	  }
-	  ldout(cct, 3) << "handle_osd_map missing epoch "
-			<< osdmap->get_epoch()+1
-			<< ", jumping to "
-			<< m->cluster_osdmap_trim_lower_bound << dendl;
-	  e = m->cluster_osdmap_trim_lower_bound - 1;
-	  skipped_map = true;
+	if (!p.map) {
+	  // changes no target, the map of a later epoch has it applied
 	  continue;
 	}
+	osdmap = std::move(p.map);
 	logger->set(l_osdc_map_epoch, osdmap->get_epoch());
 
         prune_pg_mapping(osdmap->get_pools());
@@ -1297,16 +1497,18 @@ void Objecter::handle_osd_map(MOSDMap *m)
 	for (auto& i : need_resend) {
 	  _prune_snapc(osdmap->get_new_removed_snaps(), i.second);
 	}
-	_scan_requests(homeless_session, skipped_map, cluster_full,
+	const target_changes_t *changes =
+	  p.changes ? &*p.changes : nullptr;
+	_scan_requests(homeless_session, p.skipped_map, changes, cluster_full,
 		       &pool_full_map, need_resend,
 		       need_resend_linger, need_resend_command, sul);
-	for (auto p = osd_sessions.begin();
-	     p != osd_sessions.end(); ) {
-	  auto s = p->second;
-	  _scan_requests(s, skipped_map, cluster_full,
+	for (auto q = osd_sessions.begin();
+	     q != osd_sessions.end(); ) {
+	  auto s = q->second;
+	  _scan_requests(s, p.skipped_map, changes, cluster_full,
 			 &pool_full_map, need_resend,
 			 need_resend_linger, need_resend_command, sul);
-	  ++p;
+	  ++q;
 	  // osd down or addr change?
 	  if (!osdmap->is_up(s->osd) ||
 	      (s->con &&
@@ -1314,25 +1516,24 @@ void Objecter::handle_osd_map(MOSDMap *m)
 	    close_session(s);
 	  }
 	}
-
-	ceph_assert(e == osdmap->get_epoch());
+      }
+      if (missing_epoch) {
+	_maybe_request_map();
       }
 
     } else {
       // first map.  we want the full thing.
-      if (m->maps.count(m->get_last())) {
+      if (!pending.empty()) {
 	for (auto p = osd_sessions.begin();
 	     p != osd_sessions.end(); ++p) {
 	  OSDSession *s = p->second;
-	  _scan_requests(s, false, false, NULL, need_resend,
+	  _scan_requests(s, false, nullptr, false, NULL, need_resend,
 			 need_resend_linger, need_resend_command, sul);
 	}
-	ldout(cct, 3) << "handle_osd_map decoding full epoch "
-		      << m->get_last() << dendl;
-	osdmap->decode(m->maps[m->get_last()]);
+	osdmap = std::move(pending.front().map);
         prune_pg_mapping(osdmap->get_pools());
 
-	_scan_requests(homeless_session, false, false, NULL,
+	_scan_requests(homeless_session, false, nullptr, false, NULL,
 		       need_resend, need_resend_linger,
 		       need_resend_command, sul);
       } else {
@@ -16,14 +16,18 @@
 #ifndef CEPH_OBJECTER_H
 #define CEPH_OBJECTER_H
 
+#include <atomic>
 #include <list>
 #include <map>
 #include <mutex>
+#include <optional>
+#include <set>
 #include <memory>
 #include <string>
 #include <string_view>
 #include <type_traits>
 #include <variant>
+#include <vector>
 
 #include <boost/container/small_vector.hpp>
 #include <boost/asio/bind_executor.hpp>
@@ -64,6 +68,7 @@
 #include "msg/Dispatcher.h"
 
 #include "osd/OSDMap.h"
+#include "osd/OSDMapMapping.h"
 #include "osd/error_code.h"
 
 class Context;
@@ -1694,6 +1699,7 @@ class Objecter : public md_config_obs_t, public Dispatcher {
   friend class SplitOp;
   friend class ECSplitOp;
   friend class ReplicaSplitOp;
+  friend class ObjecterTest;
 
   using MOSDOp = _mosdop::MOSDOp<osdc_opvec>;
 public:
@@ -1715,7 +1721,44 @@ public:
       finish_strand{service.get_executor()};
   ZTracer::Endpoint trace_endpoint{"0.0.0.0", 0, "Objecter"};
 private:
-  std::unique_ptr<OSDMap> osdmap{std::make_unique<OSDMap>()};
+  std::shared_ptr<OSDMap> osdmap{std::make_shared<OSDMap>()};
+
+  struct op_target_t;
+  // the pools and pgs whose op targets an incremental may have changed
+  struct target_changes_t {
+    std::set<int64_t> pools;
+    std::set<pg_t> pgs;
+
+    // empty if the incremental may have changed the mapping of any pg,
+    // e.g. if it has a new crush map or osds going up, down, in or out;
+    // next is the map inc was applied to, which had prev_flags and
+    // prev_require_osd_release before
+    static std::optional<target_changes_t> diff(
+      int prev_flags,
+      ceph_release_t prev_require_osd_release,
+      const OSDMap::Incremental& inc,
+      const OSDMap& next);
+    bool empty() const {
+      return pools.empty() && pgs.empty();
+    }
+    bool may_change(const op_target_t& t) const;
+  };
+
+  // an epoch of an MOSDMap, built before it replaces osdmap
+  struct pending_osdmap_t {
+    // null for an incremental that changes no target, which is applied
+    // to the map of a later epoch as well
+    std::shared_ptr<OSDMap> map;
+    std::optional<OSDMap::Incremental> inc;
+    // empty if all the targets have to be recalculated
+    std::optional<target_changes_t> changes;
+    bool skipped_map = false;
+  };
+  // serializes the changes to osdmap, so that handle_osd_map() can build
+  // the new maps without holding rwlock exclusively
+  ceph::mutex map_lock = ceph::make_mutex("Objecter::map_lock");
+  bool _prepare_osd_maps(class MOSDMap *m,
+			 std::vector<pending_osdmap_t>& pending);
 public:
   using Dispatcher::cct;
   std::multimap<std::string,std::string> crush_location;
@@ -1757,10 +1800,25 @@ private:
   // pool -> pg mapping
   std::map<int64_t, std::vector<pg_mapping_t>> pg_mappings;
 
+  // every pg of the latest osdmap, mapped in the background when
+  // objecter_pg_mapping_threads is set, and published once it is complete
+  std::unique_ptr<ThreadPool> pg_mapper_tp;
+  std::unique_ptr<ParallelPGMapper> pg_mapper;
+  std::unique_ptr<ParallelPGMapper::Job> pg_mapping_job;
+  std::atomic<std::shared_ptr<const OSDMapMapping>> pg_mapping_table;
+  // map_lock is locked
+  void _start_pg_mapping(const std::shared_ptr<const OSDMap>& map);
+  void _stop_pg_mapping();
+
   // convenient accessors
   bool lookup_pg_mapping(const pg_t& pg, epoch_t epoch, std::vector<int> *up,
                          int *up_primary, std::vector<int> *acting,
                          int *acting_primary) {
+    if (auto table = pg_mapping_table.load(std::memory_order_acquire);
+        table && table->get_epoch() == epoch) {
+      table->get(pg, up, up_primary, acting, acting_primary);
+      return true;
+    }
     std::shared_lock l{pg_mapping_lock};
     auto it = pg_mappings.find(pg.pool());
     if (it == pg_mappings.end())
@@ -2740,6 +2798,7 @@ private:
   void _scan_requests(
     OSDSession *s,
     bool skipped_map,
+    const target_changes_t *changes,
     bool cluster_full,
     std::map<int64_t, bool> *pool_full_map,
     std::map<ceph_tid_t, Op*>& need_resend,
@@ -2591,6 +2591,27 @@ TEST(BufferList, crc32c_append) {
   ASSERT_EQ(bl1.crc32c(0), bl2.crc32c(0));
 }
 
+TEST(BufferList, set_crc32c) {
+  bufferlist bl;
+  bl.append("ABCDEFGH");
+  const uint32_t crc = ceph_crc32c(-1, (unsigned char*)bl.c_str(), bl.length());
+
+  // a recorded crc is returned as is, and adjusted for other initial values
+  bl.set_crc32c(-1, 0xdeadbeef);
+  EXPECT_EQ(0xdeadbeefu, bl.crc32c(-1));
+  bl.set_crc32c(-1, crc);
+  EXPECT_EQ(crc, bl.crc32c(-1));
+  EXPECT_EQ(ceph_crc32c(7, (unsigned char*)bl.c_str(), bl.length()),
+	    bl.crc32c(7));
+
+  // lists of several buffers are left alone
+  bufferlist bl2;
+  bl2.append(bufferptr("ABCD", 4));
+  bl2.append(bufferptr("EFGH", 4));
+  bl2.set_crc32c(-1, 0xdeadbeef);
+  EXPECT_EQ(crc, bl2.crc32c(-1));
+}
+
 TEST(BufferList, crc32c_zeros) {
   char buffer[4*1024];
   for (size_t i=0; i < sizeof(buffer); i++)
@@ -0,0 +1,359 @@
+straw2 buckets with more items than a block of straw2 hashes, a partial
+block, and items of zero weight; these mappings must not change.
+
+  $ crushtool -c "$TESTDIR/straw2-many-items.txt" -o straw2-many-items
+  $ crushtool -i straw2-many-items --test --show-mappings --rule 0 --num-rep 3 --min-x 0 --max-x 99
+  CRUSH rule 0 x 0 [29,25,3]
+  CRUSH rule 0 x 1 [20,4,30]
+  CRUSH rule 0 x 2 [31,25,6]
+  CRUSH rule 0 x 3 [24,4,30]
+  CRUSH rule 0 x 4 [5,31,13]
+  CRUSH rule 0 x 5 [20,4,29]
+  CRUSH rule 0 x 6 [17,34,9]
+  CRUSH rule 0 x 7 [9,32,14]
+  CRUSH rule 0 x 8 [2,20,30]
+  CRUSH rule 0 x 9 [35,17,3]
+  CRUSH rule 0 x 10 [34,20,6]
+  CRUSH rule 0 x 11 [13,28,4]
+  CRUSH rule 0 x 12 [33,0,17]
+  CRUSH rule 0 x 13 [0,22,35]
+  CRUSH rule 0 x 14 [26,34,7]
+  CRUSH rule 0 x 15 [18,7,30]
+  CRUSH rule 0 x 16 [35,20,6]
+  CRUSH rule 0 x 17 [34,24,6]
+  CRUSH rule 0 x 18 [11,29,9]
+  CRUSH rule 0 x 19 [30,12,4]
+  CRUSH rule 0 x 20 [14,27,10]
+  CRUSH rule 0 x 21 [6,12,28]
+  CRUSH rule 0 x 22 [30,3,26]
+  CRUSH rule 0 x 23 [3,21,33]
+  CRUSH rule 0 x 24 [18,31,1]
+  CRUSH rule 0 x 25 [28,11,7]
+  CRUSH rule 0 x 26 [17,35,7]
+  CRUSH rule 0 x 27 [3,34,26]
+  CRUSH rule 0 x 28 [12,0,29]
+  CRUSH rule 0 x 29 [24,6,27]
+  CRUSH rule 0 x 30 [6,20,35]
+  CRUSH rule 0 x 31 [20,9,35]
+  CRUSH rule 0 x 32 [2,13,32]
+  CRUSH rule 0 x 33 [14,2,29]
+  CRUSH rule 0 x 34 [16,1,29]
+  CRUSH rule 0 x 35 [23,5,27]
+  CRUSH rule 0 x 36 [6,33,13]
+  CRUSH rule 0 x 37 [25,9,27]
+  CRUSH rule 0 x 38 [6,20,27]
+  CRUSH rule 0 x 39 [3,28,15]
+  CRUSH rule 0 x 40 [30,25,10]
+  CRUSH rule 0 x 41 [14,28,6]
+  CRUSH rule 0 x 42 [7,12,33]
+  CRUSH rule 0 x 43 [27,9,22]
+  CRUSH rule 0 x 44 [11,9,35]
+  CRUSH rule 0 x 45 [24,7,29]
+  CRUSH rule 0 x 46 [34,4,25]
+  CRUSH rule 0 x 47 [7,24,27]
+  CRUSH rule 0 x 48 [6,18,33]
+  CRUSH rule 0 x 49 [0,27,22]
+  CRUSH rule 0 x 50 [3,24,28]
+  CRUSH rule 0 x 51 [23,32,9]
+  CRUSH rule 0 x 52 [14,33,3]
+  CRUSH rule 0 x 53 [3,33,11]
+  CRUSH rule 0 x 54 [26,27,10]
+  CRUSH rule 0 x 55 [12,6,35]
+  CRUSH rule 0 x 56 [21,10,31]
+  CRUSH rule 0 x 57 [34,24,6]
+  CRUSH rule 0 x 58 [34,1,20]
+  CRUSH rule 0 x 59 [10,22,31]
+  CRUSH rule 0 x 60 [3,33,26]
+  CRUSH rule 0 x 61 [0,17,31]
+  CRUSH rule 0 x 62 [23,31,6]
+  CRUSH rule 0 x 63 [28,20,0]
+  CRUSH rule 0 x 64 [1,13,32]
+  CRUSH rule 0 x 65 [13,1,28]
+  CRUSH rule 0 x 66 [10,34,18]
+  CRUSH rule 0 x 67 [0,29,11]
+  CRUSH rule 0 x 68 [20,33,3]
+  CRUSH rule 0 x 69 [9,21,35]
+  CRUSH rule 0 x 70 [26,27,2]
+  CRUSH rule 0 x 71 [12,34,1]
+  CRUSH rule 0 x 72 [26,30,6]
+  CRUSH rule 0 x 73 [18,10,28]
+  CRUSH rule 0 x 74 [29,23,6]
+  CRUSH rule 0 x 75 [29,16,4]
+  CRUSH rule 0 x 76 [32,17,6]
+  CRUSH rule 0 x 77 [32,21,9]
+  CRUSH rule 0 x 78 [11,33,7]
+  CRUSH rule 0 x 79 [5,13,31]
+  CRUSH rule 0 x 80 [13,10,28]
+  CRUSH rule 0 x 81 [27,20,9]
+  CRUSH rule 0 x 82 [27,18,3]
+  CRUSH rule 0 x 83 [22,9,35]
+  CRUSH rule 0 x 84 [20,29,3]
+  CRUSH rule 0 x 85 [7,18,31]
+  CRUSH rule 0 x 86 [16,35,2]
+  CRUSH rule 0 x 87 [6,16,33]
+  CRUSH rule 0 x 88 [23,29,10]
+  CRUSH rule 0 x 89 [1,29,21]
+  CRUSH rule 0 x 90 [14,33,4]
+  CRUSH rule 0 x 91 [27,18,6]
+  CRUSH rule 0 x 92 [17,10,31]
+  CRUSH rule 0 x 93 [24,6,31]
+  CRUSH rule 0 x 94 [13,4,29]
+  CRUSH rule 0 x 95 [29,21,2]
+  CRUSH rule 0 x 96 [2,25,30]
+  CRUSH rule 0 x 97 [16,33,4]
+  CRUSH rule 0 x 98 [18,30,5]
+  CRUSH rule 0 x 99 [26,3,34]
+  $ crushtool -i straw2-many-items --test --show-mappings --rule 1 --num-rep 4 --min-x 0 --max-x 99
+  CRUSH rule 1 x 0 [29,28,32,25]
+  CRUSH rule 1 x 1 [20,24,4,30]
+  CRUSH rule 1 x 2 [31,29,28,25]
+  CRUSH rule 1 x 3 [24,11,13,4]
+  CRUSH rule 1 x 4 [5,10,31,4]
+  CRUSH rule 1 x 5 [20,25,4,0]
+  CRUSH rule 1 x 6 [17,34,14,16]
+  CRUSH rule 1 x 7 [9,4,6,32]
+  CRUSH rule 1 x 8 [2,6,20,30]
+  CRUSH rule 1 x 9 [35,17,19,21]
+  CRUSH rule 1 x 10 [34,20,12,6]
+  CRUSH rule 1 x 11 [13,28,12,33]
+  CRUSH rule 1 x 12 [33,29,0,17]
+  CRUSH rule 1 x 13 [0,22,35,7]
+  CRUSH rule 1 x 14 [26,34,23,7]
+  CRUSH rule 1 x 15 [18,16,7,30]
+  CRUSH rule 1 x 16 [35,20,23,13]
+  CRUSH rule 1 x 17 [34,24,30,6]
+  CRUSH rule 1 x 18 [11,29,30,13]
+  CRUSH rule 1 x 19 [30,12,20,13]
+  CRUSH rule 1 x 20 [14,27,16,10]
+  CRUSH rule 1 x 21 [6,12,20,28]
+  CRUSH rule 1 x 22 [30,3,26,24]
+  CRUSH rule 1 x 23 [3,21,25,33]
+  CRUSH rule 1 x 24 [18,31,11,1]
+  CRUSH rule 1 x 25 [28,11,20,23]
+  CRUSH rule 1 x 26 [17,35,7,20]
+  CRUSH rule 1 x 27 [3,34,1,4]
+  CRUSH rule 1 x 28 [12,0,26,17]
+  CRUSH rule 1 x 29 [24,6,21,2]
+  CRUSH rule 1 x 30 [6,20,0,2]
+  CRUSH rule 1 x 31 [20,12,19,9]
+  CRUSH rule 1 x 32 [2,13,11,1]
+  CRUSH rule 1 x 33 [14,17,20,2]
+  CRUSH rule 1 x 34 [16,1,9,4]
+  CRUSH rule 1 x 35 [23,13,5,7]
+  CRUSH rule 1 x 36 [6,33,29,4]
+  CRUSH rule 1 x 37 [25,9,2,4]
+  CRUSH rule 1 x 38 [6,20,11,15]
+  CRUSH rule 1 x 39 [3,28,27,15]
+  CRUSH rule 1 x 40 [30,25,17,16]
+  CRUSH rule 1 x 41 [14,28,22,18]
+  CRUSH rule 1 x 42 [7,12,33,0]
+  CRUSH rule 1 x 43 [27,9,22,12]
+  CRUSH rule 1 x 44 [11,20,15,9]
+  CRUSH rule 1 x 45 [24,20,7,19]
+  CRUSH rule 1 x 46 [34,4,1,31]
+  CRUSH rule 1 x 47 [7,24,0,27]
+  CRUSH rule 1 x 48 [6,18,33,32]
+  CRUSH rule 1 x 49 [0,7,27,29]
+  CRUSH rule 1 x 50 [3,1,24,4]
+  CRUSH rule 1 x 51 [23,18,32,20]
+  CRUSH rule 1 x 52 [14,19,33,17]
+  CRUSH rule 1 x 53 [3,10,33,11]
+  CRUSH rule 1 x 54 [26,22,16,27]
+  CRUSH rule 1 x 55 [12,13,21,14]
+  CRUSH rule 1 x 56 [21,10,24,25]
+  CRUSH rule 1 x 57 [34,32,24,6]
+  CRUSH rule 1 x 58 [34,1,20,4]
+  CRUSH rule 1 x 59 [10,22,1,31]
+  CRUSH rule 1 x 60 [3,5,33,26]
+  CRUSH rule 1 x 61 [0,17,22,9]
+  CRUSH rule 1 x 62 [23,17,12,11]
+  CRUSH rule 1 x 63 [28,20,11,19]
+  CRUSH rule 1 x 64 [1,4,13,20]
+  CRUSH rule 1 x 65 [13,1,28,30]
+  CRUSH rule 1 x 66 [10,1,34,18]
+  CRUSH rule 1 x 67 [0,29,11,26]
+  CRUSH rule 1 x 68 [20,33,19,13]
+  CRUSH rule 1 x 69 [9,21,20,35]
+  CRUSH rule 1 x 70 [26,27,2,17]
+  CRUSH rule 1 x 71 [12,34,20,18]
+  CRUSH rule 1 x 72 [26,30,6,5]
+  CRUSH rule 1 x 73 [18,24,10,7]
+  CRUSH rule 1 x 74 [29,31,23,15]
+  CRUSH rule 1 x 75 [29,31,16,22]
+  CRUSH rule 1 x 76 [32,17,35,6]
+  CRUSH rule 1 x 77 [32,21,9,0]
+  CRUSH rule 1 x 78 [11,33,30,7]
+  CRUSH rule 1 x 79 [5,7,13,31]
+  CRUSH rule 1 x 80 [13,10,28,22]
+  CRUSH rule 1 x 81 [27,20,9,16]
+  CRUSH rule 1 x 82 [27,34,18,11]
+  CRUSH rule 1 x 83 [22,23,24,9]
+  CRUSH rule 1 x 84 [20,29,3,28]
+  CRUSH rule 1 x 85 [7,4,18,14]
+  CRUSH rule 1 x 86 [16,26,35,29]
+  CRUSH rule 1 x 87 [6,16,26,15]
+  CRUSH rule 1 x 88 [23,22,29,10]
+  CRUSH rule 1 x 89 [1,29,21,7]
+  CRUSH rule 1 x 90 [14,18,33,31]
+  CRUSH rule 1 x 91 [27,18,19,20]
+  CRUSH rule 1 x 92 [17,13,10,12]
+  CRUSH rule 1 x 93 [24,6,7,31]
+  CRUSH rule 1 x 94 [13,4,29,14]
+  CRUSH rule 1 x 95 [29,21,13,27]
+  CRUSH rule 1 x 96 [2,25,30,0]
+  CRUSH rule 1 x 97 [16,21,33,4]
+  CRUSH rule 1 x 98 [18,30,24,5]
+  CRUSH rule 1 x 99 [26,17,24,22]
+  $ crushtool -i straw2-many-items --test --show-mappings --rule 2 --num-rep 5 --min-x 0 --max-x 99
+  CRUSH rule 2 x 0 [29,28,32,25,3]
+  CRUSH rule 2 x 1 [20,24,25,4,30]
+  CRUSH rule 2 x 2 [31,29,28,25,15]
+  CRUSH rule 2 x 3 [24,11,13,4,5]
+  CRUSH rule 2 x 4 [5,10,31,4,30]
+  CRUSH rule 2 x 5 [20,25,4,0,29]
+  CRUSH rule 2 x 6 [17,34,14,16,12]
+  CRUSH rule 2 x 7 [9,4,6,32,5]
+  CRUSH rule 2 x 8 [2,6,20,30,28]
+  CRUSH rule 2 x 9 [35,3,17,19,21]
+  CRUSH rule 2 x 10 [34,20,12,6,2]
+  CRUSH rule 2 x 11 [13,28,12,33,18]
+  CRUSH rule 2 x 12 [33,29,0,17,10]
+  CRUSH rule 2 x 13 [0,22,35,7,20]
+  CRUSH rule 2 x 14 [26,34,23,7,0]
+  CRUSH rule 2 x 15 [18,16,7,30,32]
+  CRUSH rule 2 x 16 [35,20,23,13,6]
+  CRUSH rule 2 x 17 [34,24,30,6,20]
+  CRUSH rule 2 x 18 [11,29,30,13,19]
+  CRUSH rule 2 x 19 [30,12,20,13,4]
+  CRUSH rule 2 x 20 [14,27,16,10,23]
+  CRUSH rule 2 x 21 [6,12,20,28,11]
+  CRUSH rule 2 x 22 [30,3,26,24,21]
+  CRUSH rule 2 x 23 [3,21,25,33,31]
+  CRUSH rule 2 x 24 [18,31,11,1,21]
+  CRUSH rule 2 x 25 [28,11,20,23,7]
+  CRUSH rule 2 x 26 [17,35,0,7,20]
+  CRUSH rule 2 x 27 [3,34,1,4,26]
+  CRUSH rule 2 x 28 [12,0,26,17,29]
+  CRUSH rule 2 x 29 [24,6,21,2,27]
+  CRUSH rule 2 x 30 [6,20,0,2,35]
+  CRUSH rule 2 x 31 [20,12,19,27,9]
+  CRUSH rule 2 x 32 [2,13,11,1,32]
+  CRUSH rule 2 x 33 [14,17,20,2,0]
+  CRUSH rule 2 x 34 [16,1,9,4,25]
+  CRUSH rule 2 x 35 [23,13,5,7,21]
+  CRUSH rule 2 x 36 [6,33,29,4,13]
+  CRUSH rule 2 x 37 [25,9,2,4,27]
+  CRUSH rule 2 x 38 [6,20,11,15,5]
+  CRUSH rule 2 x 39 [3,28,27,15,20]
+  CRUSH rule 2 x 40 [30,25,17,16,18]
+  CRUSH rule 2 x 41 [14,28,22,18,12]
+  CRUSH rule 2 x 42 [7,12,25,33,0]
+  CRUSH rule 2 x 43 [27,9,22,12,2]
+  CRUSH rule 2 x 44 [11,35,20,15,9]
+  CRUSH rule 2 x 45 [24,20,7,19,0]
+  CRUSH rule 2 x 46 [34,4,1,31,33]
+  CRUSH rule 2 x 47 [7,24,0,27,16]
+  CRUSH rule 2 x 48 [6,18,33,32,14]
+  CRUSH rule 2 x 49 [0,7,27,29,4]
+  CRUSH rule 2 x 50 [3,1,24,4,14]
+  CRUSH rule 2 x 51 [23,18,32,20,9]
+  CRUSH rule 2 x 52 [14,24,19,33,17]
+  CRUSH rule 2 x 53 [3,10,33,11,0]
+  CRUSH rule 2 x 54 [26,22,16,27,11]
+  CRUSH rule 2 x 55 [12,13,21,14,6]
+  CRUSH rule 2 x 56 [21,10,24,25,31]
+  CRUSH rule 2 x 57 [34,32,24,6,28]
+  CRUSH rule 2 x 58 [34,1,35,20,4]
+  CRUSH rule 2 x 59 [10,22,1,31,34]
+  CRUSH rule 2 x 60 [3,5,33,26,31]
+  CRUSH rule 2 x 61 [0,17,22,9,31]
+  CRUSH rule 2 x 62 [23,17,12,11,24]
+  CRUSH rule 2 x 63 [28,20,11,19,15]
+  CRUSH rule 2 x 64 [1,4,13,20,11]
+  CRUSH rule 2 x 65 [13,1,28,30,21]
+  CRUSH rule 2 x 66 [10,1,34,18,23]
+  CRUSH rule 2 x 67 [0,29,11,26,24]
+  CRUSH rule 2 x 68 [20,33,19,13,3]
+  CRUSH rule 2 x 69 [9,21,20,35,26]
+  CRUSH rule 2 x 70 [26,27,2,17,0]
+  CRUSH rule 2 x 71 [12,34,20,18,13]
+  CRUSH rule 2 x 72 [26,30,6,5,4]
+  CRUSH rule 2 x 73 [18,24,10,7,33]
+  CRUSH rule 2 x 74 [29,31,23,15,24]
+  CRUSH rule 2 x 75 [29,31,16,22,26]
+  CRUSH rule 2 x 76 [32,17,35,16,6]
+  CRUSH rule 2 x 77 [32,21,16,9,0]
+  CRUSH rule 2 x 78 [11,33,30,7,21]
+  CRUSH rule 2 x 79 [5,7,13,34,31]
+  CRUSH rule 2 x 80 [13,10,28,22,19]
+  CRUSH rule 2 x 81 [27,20,9,16,10]
+  CRUSH rule 2 x 82 [27,34,18,11,4]
+  CRUSH rule 2 x 83 [22,23,24,9,5]
+  CRUSH rule 2 x 84 [20,29,0,7,3]
+  CRUSH rule 2 x 85 [7,4,18,14,31]
+  CRUSH rule 2 x 86 [16,26,35,21,29]
+  CRUSH rule 2 x 87 [6,16,26,15,21]
+  CRUSH rule 2 x 88 [23,22,29,10,9]
+  CRUSH rule 2 x 89 [1,29,21,7,34]
+  CRUSH rule 2 x 90 [14,18,33,31,21]
+  CRUSH rule 2 x 91 [27,18,19,20,6]
+  CRUSH rule 2 x 92 [17,13,10,12,1]
+  CRUSH rule 2 x 93 [24,6,7,31,29]
+  CRUSH rule 2 x 94 [13,4,29,14,18]
+  CRUSH rule 2 x 95 [29,21,23,13,27]
+  CRUSH rule 2 x 96 [2,25,30,23,0]
+  CRUSH rule 2 x 97 [16,21,33,4,24]
+  CRUSH rule 2 x 98 [18,30,19,24,5]
+  CRUSH rule 2 x 99 [26,17,24,22,3]
+  $ crushtool -i straw2-many-items --test --show-mappings --rule 1 --num-rep 4 --min-x 0 --max-x 49 --weight 5 0 --weight 14 .5
+  CRUSH rule 1 x 0 [29,28,32,25]
+  CRUSH rule 1 x 1 [20,24,4,30]
+  CRUSH rule 1 x 2 [31,29,28,25]
+  CRUSH rule 1 x 3 [24,11,13,4]
+  CRUSH rule 1 x 4 [10,31,4,30]
+  CRUSH rule 1 x 5 [20,25,4,0]
+  CRUSH rule 1 x 6 [17,34,14,16]
+  CRUSH rule 1 x 7 [9,4,6,32]
+  CRUSH rule 1 x 8 [2,6,20,30]
+  CRUSH rule 1 x 9 [35,17,19,21]
+  CRUSH rule 1 x 10 [34,20,12,6]
+  CRUSH rule 1 x 11 [13,28,12,33]
+  CRUSH rule 1 x 12 [33,29,0,17]
+  CRUSH rule 1 x 13 [0,22,35,7]
+  CRUSH rule 1 x 14 [26,34,23,7]
+  CRUSH rule 1 x 15 [18,16,7,30]
+  CRUSH rule 1 x 16 [35,20,23,13]
+  CRUSH rule 1 x 17 [34,24,30,6]
+  CRUSH rule 1 x 18 [11,29,30,13]
+  CRUSH rule 1 x 19 [30,12,20,13]
+  CRUSH rule 1 x 20 [14,27,16,10]
+  CRUSH rule 1 x 21 [6,12,20,28]
+  CRUSH rule 1 x 22 [30,3,26,24]
+  CRUSH rule 1 x 23 [3,21,25,33]
+  CRUSH rule 1 x 24 [18,31,11,1]
+  CRUSH rule 1 x 25 [28,11,20,23]
+  CRUSH rule 1 x 26 [17,35,7,20]
+  CRUSH rule 1 x 27 [3,34,1,4]
+  CRUSH rule 1 x 28 [12,0,26,17]
+  CRUSH rule 1 x 29 [24,6,21,2]
+  CRUSH rule 1 x 30 [6,20,0,2]
+  CRUSH rule 1 x 31 [20,12,19,9]
+  CRUSH rule 1 x 32 [2,13,11,1]
+  CRUSH rule 1 x 33 [14,17,20,2]
+  CRUSH rule 1 x 34 [16,1,9,4]
+  CRUSH rule 1 x 35 [23,13,7,27]
+  CRUSH rule 1 x 36 [6,33,29,4]
+  CRUSH rule 1 x 37 [25,9,2,4]
+  CRUSH rule 1 x 38 [6,20,11,15]
+  CRUSH rule 1 x 39 [3,28,27,15]
+  CRUSH rule 1 x 40 [30,25,17,16]
+  CRUSH rule 1 x 41 [14,28,22,18]
+  CRUSH rule 1 x 42 [7,12,33,0]
+  CRUSH rule 1 x 43 [27,9,22,12]
+  CRUSH rule 1 x 44 [11,20,15,9]
+  CRUSH rule 1 x 45 [24,20,7,19]
+  CRUSH rule 1 x 46 [34,4,1,31]
+  CRUSH rule 1 x 47 [7,24,0,27]
+  CRUSH rule 1 x 48 [6,18,33,32]
+  CRUSH rule 1 x 49 [0,7,27,29]
+  $ rm straw2-many-items
@@ -502,6 +502,28 @@ TEST_P(FirstnTest, basic) {
   }
 }
 
+TEST_P(FirstnTest, batch) {
+  // hosts with more osds than a block of straw2 hashes, and a partial block
+  std::unique_ptr<CrushWrapper> c(build_firstn_map(cct, 3, 3, 11));
+  vector<__u32> weight(c->get_max_devices(), 0x10000);
+  for (unsigned i = 0; i < weight.size(); i += 7) {
+    weight[i] = i % 2 ? 0 : 0x8000;
+  }
+
+  vector<int> xs;
+  for (int x = 0; x < 1000; ++x) {
+    xs.push_back(x);
+  }
+  vector<vector<int>> batch_out;
+  c->do_rule_batch(0, xs, batch_out, 3, weight, 0);
+  ASSERT_EQ(xs.size(), batch_out.size());
+  for (unsigned i = 0; i < xs.size(); ++i) {
+    vector<int> out;
+    c->do_rule(0, xs[i], out, 3, weight, 0);
+    ASSERT_EQ(out, batch_out[i]) << "x " << xs[i];
+  }
+}
+
 TEST_P(FirstnTest, toosmall) {
   std::unique_ptr<CrushWrapper> c(build_firstn_map(cct, 1, 3, 1));
   vector<__u32> weight(c->get_max_devices(), 0x10000);
@@ -94,6 +94,7 @@ class DirectMessenger : public SimplePolicyMessenger {
   int get_dispatch_queue_len() override { return 0; }
   double get_dispatch_queue_max_age(utime_t now) override { return 0; }
   void set_cluster_protocol(int p) override {}
+  void set_dispatch_threads(unsigned n) override {}
 };
 
 #endif
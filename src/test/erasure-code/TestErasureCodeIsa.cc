@@ -367,6 +367,90 @@ TEST_F(IsaErasureCodeTest, encode)
   }
 }
 
+TEST_F(IsaErasureCodeTest, encode_decode_chunks_batch)
+{
+  ErasureCodeIsaDefault Isa(tcache, "reed_sol_van");
+  ErasureCodeProfile profile;
+  profile["k"] = "4";
+  profile["m"] = "2";
+  Isa.init(profile, &cerr);
+
+  const unsigned k = 4;
+  const unsigned km = 6;
+  const unsigned sizes[] = { Isa.get_alignment(), 2 * Isa.get_alignment() };
+  const size_t stripes = std::size(sizes);
+
+  // stripe 1 has no data shard 3, which must be treated as zeros
+  auto make_stripe = [&](size_t stripe, shard_id_map<bufferptr> &in,
+                         shard_id_map<bufferptr> &out) {
+    for (unsigned i = 0; i < km; ++i) {
+      if (stripe == 1 && i == 3) {
+        continue;
+      }
+      bufferptr bp(buffer::create_aligned(sizes[stripe], 64));
+      if (i < k) {
+        memset(bp.c_str(), 'A' + i + stripe, bp.length());
+        in.emplace(shard_id_t(i), bp);
+      } else {
+        bp.zero();
+        out.emplace(shard_id_t(i), bp);
+      }
+    }
+  };
+
+  std::vector<shard_id_map<bufferptr>> in(stripes, shard_id_map<bufferptr>(km));
+  std::vector<shard_id_map<bufferptr>> out(stripes, shard_id_map<bufferptr>(km));
+  for (size_t s = 0; s < stripes; ++s) {
+    make_stripe(s, in[s], out[s]);
+  }
+  EXPECT_EQ(0, Isa.encode_chunks_batch(in, out));
+
+  // the batch matches stripe by stripe encoding
+  for (size_t s = 0; s < stripes; ++s) {
+    shard_id_map<bufferptr> sin(km);
+    shard_id_map<bufferptr> sout(km);
+    make_stripe(s, sin, sout);
+    EXPECT_EQ(0, Isa.encode_chunks(sin, sout));
+    for (unsigned i = k; i < km; ++i) {
+      shard_id_t shard(i);
+      EXPECT_EQ(0, memcmp(sout[shard].c_str(), out[s][shard].c_str(),
+                          sizes[s]));
+    }
+  }
+
+  // lose data shard 0 and parity shard 4 of every stripe and get them back
+  shard_id_set want_to_read;
+  want_to_read.insert(shard_id_t(0));
+  want_to_read.insert(shard_id_t(4));
+  std::vector<shard_id_map<bufferptr>> din(stripes, shard_id_map<bufferptr>(km));
+  std::vector<shard_id_map<bufferptr>> dout(stripes, shard_id_map<bufferptr>(km));
+  for (size_t s = 0; s < stripes; ++s) {
+    for (auto &&[shard, bp] : in[s]) {
+      if (shard != shard_id_t(0)) {
+        din[s].emplace(shard, bp);
+      }
+    }
+    if (s == 1) {
+      bufferptr zeros(buffer::create_aligned(sizes[s], 64));
+      zeros.zero();
+      din[s].emplace(shard_id_t(3), zeros);
+    }
+    din[s].emplace(shard_id_t(5), out[s][shard_id_t(5)]);
+    for (auto shard : want_to_read) {
+      bufferptr bp(buffer::create_aligned(sizes[s], 64));
+      bp.zero();
+      dout[s].emplace(shard, bp);
+    }
+  }
+  EXPECT_EQ(0, Isa.decode_chunks_batch(want_to_read, din, dout));
+  for (size_t s = 0; s < stripes; ++s) {
+    EXPECT_EQ(0, memcmp(in[s][shard_id_t(0)].c_str(),
+                        dout[s][shard_id_t(0)].c_str(), sizes[s]));
+    EXPECT_EQ(0, memcmp(out[s][shard_id_t(4)].c_str(),
+                        dout[s][shard_id_t(4)].c_str(), sizes[s]));
+  }
+}
+
 TEST_F(IsaErasureCodeTest, sanity_check_k)
 {
   ErasureCodeIsaDefault Isa(tcache, "reed_sol_van");
@@ -875,6 +959,75 @@ TEST_F(IsaErasureCodeTest, isa_xor_codec)
   EXPECT_EQ(5, cnt_cf);
 }
 
+TEST_F(IsaErasureCodeTest, precompute_decoding_tables)
+{
+  ErasureCodeIsaTableCache precomputed;
+  ErasureCodeIsaDefault Isa(precomputed, "reed_sol_van");
+  ErasureCodeProfile profile;
+  profile["k"] = "4";
+  profile["m"] = "2";
+  EXPECT_EQ(0, Isa.init(profile, &cerr));
+
+  Isa.precompute_decoding_tables(1 << 20);
+  precomputed.waitForPrecompute();
+  // the 15 ways to keep 4 out of 6 chunks and the loss of the last parity
+  // alone, the loss of any other single chunk is xor decoded
+  EXPECT_EQ(16, precomputed.getPinnedDecodingTableCount());
+
+  // a second instance of the same profile shares the tables
+  {
+    ErasureCodeIsaDefault Isa2(precomputed, "reed_sol_van");
+    EXPECT_EQ(0, Isa2.init(profile, &cerr));
+    Isa2.precompute_decoding_tables(1 << 20);
+    precomputed.waitForPrecompute();
+    EXPECT_EQ(16, precomputed.getPinnedDecodingTableCount());
+  }
+
+  string payload(4 * 4096, 'X');
+  for (unsigned i = 0; i < payload.size(); i++) {
+    payload[i] = 'A' + i % 26;
+  }
+  bufferlist in;
+  in.append(payload.c_str(), payload.length());
+  int want_to_encode[] = {0, 1, 2, 3, 4, 5};
+  shard_id_map<bufferlist> encoded(Isa.get_chunk_count());
+  EXPECT_EQ(0, Isa.encode(shard_id_set(want_to_encode, want_to_encode + 6),
+                          in,
+                          &encoded));
+  unsigned chunk_size = encoded[shard_id_t(0)].length();
+
+  // two data chunks are missing
+  {
+    shard_id_map<bufferlist> degraded = encoded;
+    degraded.erase(shard_id_t(0));
+    degraded.erase(shard_id_t(1));
+    int want_to_decode[] = {0, 1};
+    shard_id_map<bufferlist> decoded(Isa.get_chunk_count());
+    EXPECT_EQ(0, Isa._decode(shard_id_set(want_to_decode, want_to_decode + 2),
+                             degraded,
+                             &decoded));
+    compare_chunks(in, decoded);
+  }
+
+  // one data chunk is missing and only k chunks are read
+  {
+    shard_id_map<bufferlist> degraded = encoded;
+    degraded.erase(shard_id_t(1));
+    degraded.erase(shard_id_t(5));
+    int want_to_decode[] = {1};
+    shard_id_map<bufferlist> decoded(Isa.get_chunk_count());
+    EXPECT_EQ(0, Isa._decode(shard_id_set(want_to_decode, want_to_decode + 1),
+                             degraded,
+                             &decoded));
+    EXPECT_EQ(0, memcmp(decoded[shard_id_t(1)].c_str(),
+                        encoded[shard_id_t(1)].c_str(), chunk_size));
+  }
+
+  // both decodes were served by the precomputed tables, the lru was never
+  // created
+  EXPECT_EQ(-1, precomputed.getDecodingTableCacheSize());
+}
+
 TEST_F(IsaErasureCodeTest, create_rule)
 {
   std::unique_ptr<CrushWrapper> c = std::make_unique<CrushWrapper>();
@@ -22,6 +22,8 @@
 #include "crush/CrushWrapper.h"
 #include "include/stringify.h"
 #include "erasure-code/jerasure/ErasureCodeJerasure.h"
+#include "erasure-code/jerasure/gf8_region.h"
+#include "erasure-code/jerasure/jerasure_init.h"
 #include "global/global_context.h"
 #include "common/config.h"
 #include "gtest/gtest.h"
@@ -131,6 +133,93 @@ TYPED_TEST(ErasureCodeTest, encode_decode)
   }
 }
 
+TYPED_TEST(ErasureCodeTest, encode_decode_chunks_batch)
+{
+  TypeParam jerasure;
+  ErasureCodeProfile profile;
+  profile["k"] = "2";
+  profile["m"] = "2";
+  profile["packetsize"] = "8";
+  ASSERT_EQ(0, jerasure.init(profile, &cerr));
+
+  const unsigned k = 2;
+  const unsigned km = 4;
+  const unsigned sizes[] = {
+    jerasure.get_chunk_size(jerasure.get_alignment()),
+    jerasure.get_chunk_size(jerasure.get_alignment() * 2)
+  };
+  const size_t stripes = std::size(sizes);
+
+  // stripe 1 has no data shard 1, which must be treated as zeros
+  auto make_stripe = [&](size_t stripe, shard_id_map<bufferptr> &in,
+			 shard_id_map<bufferptr> &out) {
+    for (unsigned i = 0; i < km; ++i) {
+      if (stripe == 1 && i == 1) {
+	continue;
+      }
+      bufferptr bp(buffer::create_aligned(sizes[stripe], 64));
+      if (i < k) {
+	for (unsigned j = 0; j < sizes[stripe]; ++j) {
+	  bp.c_str()[j] = char(j * 131 + i + stripe);
+	}
+	in.emplace(shard_id_t(i), bp);
+      } else {
+	bp.zero();
+	out.emplace(shard_id_t(i), bp);
+      }
+    }
+  };
+
+  std::vector<shard_id_map<bufferptr>> in(stripes, shard_id_map<bufferptr>(km));
+  std::vector<shard_id_map<bufferptr>> out(stripes, shard_id_map<bufferptr>(km));
+  for (size_t s = 0; s < stripes; ++s) {
+    make_stripe(s, in[s], out[s]);
+  }
+  EXPECT_EQ(0, jerasure.encode_chunks_batch(in, out));
+
+  // the batch matches stripe by stripe encoding
+  for (size_t s = 0; s < stripes; ++s) {
+    shard_id_map<bufferptr> sin(km);
+    shard_id_map<bufferptr> sout(km);
+    make_stripe(s, sin, sout);
+    EXPECT_EQ(0, jerasure.encode_chunks(sin, sout));
+    for (unsigned i = k; i < km; ++i) {
+      shard_id_t shard(i);
+      EXPECT_EQ(0, memcmp(sout[shard].c_str(), out[s][shard].c_str(),
+			  sizes[s]));
+    }
+  }
+
+  // lose data shard 0 and parity shard 3 of every stripe and get them back
+  shard_id_set want_to_read;
+  want_to_read.insert(shard_id_t(0));
+  want_to_read.insert(shard_id_t(3));
+  std::vector<shard_id_map<bufferptr>> din(stripes, shard_id_map<bufferptr>(km));
+  std::vector<shard_id_map<bufferptr>> dout(stripes, shard_id_map<bufferptr>(km));
+  for (size_t s = 0; s < stripes; ++s) {
+    if (s == 1) {
+      bufferptr zeros(buffer::create_aligned(sizes[s], 64));
+      zeros.zero();
+      din[s].emplace(shard_id_t(1), zeros);
+    } else {
+      din[s].emplace(shard_id_t(1), in[s][shard_id_t(1)]);
+    }
+    din[s].emplace(shard_id_t(2), out[s][shard_id_t(2)]);
+    for (auto shard : want_to_read) {
+      bufferptr bp(buffer::create_aligned(sizes[s], 64));
+      bp.zero();
+      dout[s].emplace(shard, bp);
+    }
+  }
+  EXPECT_EQ(0, jerasure.decode_chunks_batch(want_to_read, din, dout));
+  for (size_t s = 0; s < stripes; ++s) {
+    EXPECT_EQ(0, memcmp(in[s][shard_id_t(0)].c_str(),
+			dout[s][shard_id_t(0)].c_str(), sizes[s]));
+    EXPECT_EQ(0, memcmp(out[s][shard_id_t(3)].c_str(),
+			dout[s][shard_id_t(3)].c_str(), sizes[s]));
+  }
+}
+
 TYPED_TEST(ErasureCodeTest, minimum_to_decode)
 {
   TypeParam jerasure;
@@ -279,6 +368,48 @@ TEST(ErasureCodeTest, encode)
   }
 }
 
+TEST(ErasureCodeTest, gf_kernel)
+{
+  int w[] = { 8 };
+  ASSERT_EQ(0, jerasure_init(1, w));
+
+  ErasureCodeProfile profile;
+  profile["k"] = "4";
+  profile["m"] = "2";
+  profile["w"] = "8";
+  std::optional<shard_id_map<bufferlist>> reference;
+  for (auto kernel : ceph::gf8::supported_kernels()) {
+    ErasureCodeJerasureReedSolomonVandermonde jerasure;
+    ASSERT_EQ(0, ceph::gf8::set_kernel(ceph::gf8::kernel_name(kernel), &cerr));
+    ASSERT_EQ(0, jerasure.init(profile, &cerr));
+    EXPECT_EQ(kernel, ceph::gf8::get_kernel());
+
+    // not a multiple of any vector width, so the tail is done too
+    bufferlist in;
+    for (unsigned i = 0; i < jerasure.get_alignment() * 4 + 1; i++) {
+      in.append(char(i * 131 + (i >> 8)));
+    }
+    shard_id_set want_to_encode;
+    for (shard_id_t shard; shard < jerasure.get_chunk_count(); ++shard) {
+      want_to_encode.insert(shard);
+    }
+    shard_id_map<bufferlist> encoded(jerasure.get_chunk_count());
+    ASSERT_EQ(0, jerasure.encode(want_to_encode, in, &encoded));
+    if (!reference) {
+      reference = encoded;
+      continue;
+    }
+    for (shard_id_t shard; shard < jerasure.get_chunk_count(); ++shard) {
+      EXPECT_TRUE(encoded[shard].contents_equal(reference->at(shard)))
+	<< "kernel " << ceph::gf8::kernel_name(kernel) << " shard " << shard;
+    }
+  }
+
+  EXPECT_EQ(-EINVAL, ceph::gf8::set_kernel("nosuchkernel", &cerr));
+  EXPECT_EQ(0, ceph::gf8::set_kernel("auto", &cerr));
+  EXPECT_EQ(ceph::gf8::best_kernel(), ceph::gf8::get_kernel());
+}
+
 TEST(ErasureCodeTest, create_rule)
 {
   std::unique_ptr<CrushWrapper> c = std::make_unique<CrushWrapper>();
@@ -34,6 +34,7 @@
 #include "include/utime.h"
 #include "erasure-code/ErasureCodePlugin.h"
 #include "erasure-code/ErasureCode.h"
+#include "erasure-code/jerasure/gf8_region.h"
 #include "ceph_erasure_code_benchmark.h"
 
 using std::cerr;
@@ -59,7 +60,17 @@ int ErasureCodeBench::setup(int argc, char** argv) {
     ("plugin,p", po::value<string>()->default_value("isa"),
      "erasure code plugin name")
     ("workload,w", po::value<string>()->default_value("encode"),
-     "run either encode or decode")
+     "run either encode or decode, or one of the EC pipeline workloads: "
+     "write (full object writes), overwrite (partial writes of --op-size "
+     "bytes) or read (reads of --op-size bytes, degraded if --erased is set) "
+     "of --objects objects of --size bytes stored in a MemStore")
+    ("op-size", po::value<int>()->default_value(4096),
+     "size of the overwrites and reads of the pipeline workloads")
+    ("objects", po::value<int>()->default_value(16),
+     "number of objects of the pipeline workloads")
+    ("stripe-unit", po::value<int>()->default_value(0),
+     "stripe unit of the pipeline workloads, "
+     "osd_pool_erasure_code_stripe_unit if 0")
     ("erasures,e", po::value<int>()->default_value(1),
      "number of erasures when decoding")
     ("erased", po::value<vector<int> >(),
@@ -71,6 +82,9 @@ int ErasureCodeBench::setup(int argc, char** argv) {
      " the first chunk, then the second etc.)")
     ("parameter,P", po::value<vector<string> >(),
      "add a parameter to the erasure code profile")
+    ("gf-kernel", po::value<string>(),
+     "GF(2^8) kernel of the jerasure, shec and clay plugins, or 'all' to "
+     "run the workload with each kernel the CPU supports")
     ;
 
   po::variables_map vm;
@@ -84,6 +98,15 @@ int ErasureCodeBench::setup(int argc, char** argv) {
   vector<const char *> ceph_options;
   vector<string> ceph_option_strings = po::collect_unrecognized(
     parsed.options, po::include_positional);
+  if (vm.count("gf-kernel") > 0) {
+    gf_kernel = vm["gf-kernel"].as<string>();
+    // the plugins read erasure_code_gf_kernel when they are loaded, by the
+    // first run
+    string first = gf_kernel;
+    if (gf_kernel == "all")
+      first = ceph::gf8::kernel_name(ceph::gf8::supported_kernels().front());
+    ceph_option_strings.push_back("--erasure_code_gf_kernel=" + first);
+  }
   ceph_options.reserve(ceph_option_strings.size());
   for (vector<string>::iterator i = ceph_option_strings.begin();
        i != ceph_option_strings.end();
@@ -120,6 +143,13 @@ int ErasureCodeBench::setup(int argc, char** argv) {
 
   in_size = vm["size"].as<int>();
   max_iterations = vm["iterations"].as<int>();
+  op_size = vm["op-size"].as<int>();
+  objects = vm["objects"].as<int>();
+  stripe_unit = vm["stripe-unit"].as<int>();
+  if (stripe_unit == 0) {
+    stripe_unit = g_conf().get_val<Option::size_t>(
+      "osd_pool_erasure_code_stripe_unit");
+  }
   plugin = vm["plugin"].as<string>();
   workload = vm["workload"].as<string>();
   erasures = vm["erasures"].as<int>();
@@ -156,12 +186,37 @@ int ErasureCodeBench::run() {
   ErasureCodePluginRegistry &instance = ErasureCodePluginRegistry::instance();
   instance.disable_dlclose = true;
 
+  if (gf_kernel != "all")
+    return run_workload();
+
+  // after the first run the plugins are loaded, switch the kernel directly
+  for (auto kernel : ceph::gf8::supported_kernels()) {
+    current_gf_kernel = ceph::gf8::kernel_name(kernel);
+    int code = ceph::gf8::set_kernel(kernel);
+    if (code)
+      return code;
+    code = run_workload();
+    if (code)
+      return code;
+  }
+  return 0;
+}
+
+int ErasureCodeBench::run_workload() {
   if (workload == "encode")
     return encode();
+  else if (workload == "write" || workload == "overwrite" || workload == "read")
+    return pipeline();
   else
     return decode();
 }
 
+void ErasureCodeBench::display_result(utime_t begin_time, utime_t end_time) {
+  if (gf_kernel == "all")
+    cout << current_gf_kernel << "\t";
+  cout << (end_time - begin_time) << "\t" << (max_iterations * (in_size / 1024)) << std::endl;
+}
+
 int ErasureCodeBench::encode()
 {
   ErasureCodePluginRegistry &instance = ErasureCodePluginRegistry::instance();
@@ -190,7 +245,7 @@ int ErasureCodeBench::encode()
       return code;
   }
   utime_t end_time = ceph_clock_now();
-  cout << (end_time - begin_time) << "\t" << (max_iterations * (in_size / 1024)) << std::endl;
+  display_result(begin_time, end_time);
   return 0;
 }
 
@@ -321,10 +376,43 @@ int ErasureCodeBench::decode()
     }
   }
   utime_t end_time = ceph_clock_now();
-  cout << (end_time - begin_time) << "\t" << (max_iterations * (in_size / 1024)) << std::endl;
+  display_result(begin_time, end_time);
   return 0;
 }
 
+int ErasureCodeBench::pipeline()
+{
+  ErasureCodePluginRegistry &instance = ErasureCodePluginRegistry::instance();
+  ErasureCodeInterfaceRef erasure_code;
+  stringstream messages;
+  int code = instance.factory(plugin,
+			      g_conf().get_val<std::string>("erasure_code_dir"),
+			      profile, &erasure_code, &messages);
+  if (code) {
+    cerr << messages.str() << std::endl;
+    return code;
+  }
+
+  if (op_size <= 0 || op_size > in_size || objects <= 0) {
+    cerr << "--op-size must be in (0, --size] and --objects > 0" << std::endl;
+    return -EINVAL;
+  }
+
+  shard_id_set erased_set;
+  for (auto e : erased) {
+    erased_set.insert(shard_id_t(e));
+  }
+
+  ErasureCodePipelineBench bench(erasure_code, stripe_unit, in_size, op_size,
+				 objects, erased_set);
+  code = bench.setup();
+  if (code)
+    return code;
+  if (gf_kernel == "all")
+    cout << current_gf_kernel << "\t";
+  return bench.run(workload, max_iterations);
+}
+
 int main(int argc, char** argv) {
   ErasureCodeBench ecbench;
   try {
@@ -26,10 +26,14 @@
 #include <boost/intrusive_ptr.hpp>
 
 #include "include/buffer.h"
+#include "include/utime.h"
 
 #include "common/ceph_context.h"
 
 #include "erasure-code/ErasureCodeInterface.h"
+#include "os/ObjectStore.h"
+#include "osd/ECUtil.h"
+#include "osd/OSDMap.h"
 
 class ErasureCodeBench {
   int in_size;
@@ -37,12 +41,17 @@ class ErasureCodeBench {
   int erasures;
   int k;
   int m;
+  int op_size;
+  int objects;
+  int stripe_unit;
 
   std::string plugin;
 
   bool exhaustive_erasures;
   std::vector<int> erased;
   std::string workload;
+  std::string gf_kernel;
+  std::string current_gf_kernel;
 
   ceph::ErasureCodeProfile profile;
 
@@ -51,6 +60,8 @@ class ErasureCodeBench {
 public:
   int setup(int argc, char** argv);
   int run();
+  int run_workload();
+  void display_result(utime_t begin_time, utime_t end_time);
   int decode_erasures(const shard_id_map<ceph::buffer::list> &all_chunks,
 		      const shard_id_map<ceph::buffer::list> &chunks,
 		      shard_id_t shard,
@@ -58,6 +69,48 @@ public:
 		      ErasureCodeInterfaceRef erasure_code);
   int decode();
   int encode();
+  int pipeline();
+};
+
+/*
+ * Drives the same ECUtil / ECTransaction code as an EC pool primary, with
+ * the shards of every object stored in a MemStore instead of being sent to
+ * other OSDs.
+ */
+class ErasureCodePipelineBench {
+  ErasureCodeInterfaceRef ec_impl;
+  pg_pool_t pool;
+  ECUtil::stripe_info_t sinfo;
+  uint64_t object_size;
+  uint64_t op_size;
+  std::vector<hobject_t> oids;
+  std::map<hobject_t, uint64_t> sizes;
+  shard_id_set available;
+  unsigned pdw_write_mode;
+  OSDMapRef osdmap;
+
+  std::string path;
+  std::unique_ptr<ObjectStore> store;
+  shard_id_map<ObjectStore::CollectionHandle> chs;
+
+  coll_t get_coll(shard_id_t shard) const;
+  int read_shards(const hobject_t &hoid,
+                  const ECUtil::shard_extent_set_t &to_read,
+                  ECUtil::shard_extent_map_t &sem);
+public:
+  ErasureCodePipelineBench(ErasureCodeInterfaceRef ec_impl,
+                           uint64_t stripe_unit,
+                           uint64_t object_size,
+                           uint64_t op_size,
+                           int objects,
+                           const shard_id_set &erased);
+  ~ErasureCodePipelineBench();
+
+  int setup();
+  int write(const hobject_t &hoid, uint64_t off, ceph::buffer::list &bl);
+  int read(const hobject_t &hoid, uint64_t off, uint64_t len,
+           ceph::buffer::list *bl);
+  int run(const std::string &workload, int iterations);
 };
 
 #endif
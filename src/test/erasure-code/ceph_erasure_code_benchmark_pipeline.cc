@@ -0,0 +1,337 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:nil -*-
+// vim: ts=8 sw=2 sts=2 expandtab
+
+/*
+ * Ceph distributed storage system
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+
+#include "global/global_context.h"
+#include "common/Clock.h"
+#include "common/config.h"
+#include "common/dout.h"
+#include "common/errno.h"
+#include "include/utime.h"
+#include "os/Transaction.h"
+#include "osd/ECTransaction.h"
+#include "osd/OSDMap.h"
+#include "osd/PGTransaction.h"
+#include "ceph_erasure_code_benchmark.h"
+
+using std::cerr;
+using std::cout;
+using std::string;
+
+/*
+ * Count the calls to operator new so that the pipeline workloads can
+ * report the allocations made per op. Buffers allocated with
+ * posix_memalign by ceph::buffer are not included.
+ */
+static std::atomic<uint64_t> allocations{0};
+
+void *operator new(std::size_t size)
+{
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void *p = std::malloc(size ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+namespace {
+
+struct BenchDpp : public DoutPrefixProvider {
+  std::ostream& gen_prefix(std::ostream& out) const override {
+    return out << "ec_pipeline_bench: ";
+  }
+  CephContext *get_cct() const override { return g_ceph_context; }
+  unsigned get_subsys() const override { return ceph_subsys_osd; }
+} dpp;
+
+const pg_t pgid(0, 1);
+
+} // anonymous namespace
+
+ErasureCodePipelineBench::ErasureCodePipelineBench(
+  ErasureCodeInterfaceRef _ec_impl,
+  uint64_t stripe_unit,
+  uint64_t _object_size,
+  uint64_t _op_size,
+  int objects,
+  const shard_id_set &erased)
+  : ec_impl(_ec_impl),
+    pool(),
+    sinfo(ec_impl, &pool,
+          ec_impl->get_data_chunk_count() *
+          ec_impl->get_chunk_size(ec_impl->get_data_chunk_count() * stripe_unit)),
+    op_size(_op_size),
+    chs(sinfo.get_k_plus_m())
+{
+  pool.type = pg_pool_t::TYPE_ERASURE;
+  pool.size = sinfo.get_k_plus_m();
+  pool.stripe_width = sinfo.get_stripe_width();
+  pool.set_flag(pg_pool_t::FLAG_EC_OVERWRITES);
+  pool.set_flag(pg_pool_t::FLAG_EC_OPTIMIZATIONS);
+
+  // whole stripes, so that every shard of an object has the same size
+  object_size = std::max(_object_size, op_size);
+  object_size = sinfo.ro_offset_to_next_stripe_ro_offset(object_size);
+
+  available = shard_id_set::difference(sinfo.get_all_shards(), erased);
+  pdw_write_mode = g_conf().get_val<uint64_t>("ec_pdw_write_mode");
+  osdmap = std::make_shared<OSDMap>();
+
+  hobject_t base;
+  base.pool = pgid.pool();
+  for (int i = 0; i < objects; i++) {
+    oids.push_back(base.make_temp_hobject("ec_pipeline_bench_" +
+                                          std::to_string(i)));
+  }
+}
+
+ErasureCodePipelineBench::~ErasureCodePipelineBench()
+{
+  chs.clear();
+  if (store) {
+    store->umount();
+    store.reset();
+  }
+  if (!path.empty()) {
+    std::error_code ec;
+    std::filesystem::remove_all(path, ec);
+  }
+}
+
+coll_t ErasureCodePipelineBench::get_coll(shard_id_t shard) const
+{
+  return coll_t(spg_t(pgid, shard));
+}
+
+int ErasureCodePipelineBench::setup()
+{
+  char tmpl[] = "/tmp/ceph_erasure_code_benchmark.XXXXXX";
+  if (!mkdtemp(tmpl)) {
+    int r = -errno;
+    cerr << "mkdtemp failed: " << cpp_strerror(r) << std::endl;
+    return r;
+  }
+  path = tmpl;
+
+  store = ObjectStore::create(g_ceph_context, "memstore", path);
+  if (!store) {
+    cerr << "unable to create memstore" << std::endl;
+    return -EINVAL;
+  }
+  int r = store->mkfs();
+  if (r < 0) {
+    cerr << "mkfs failed: " << cpp_strerror(r) << std::endl;
+    return r;
+  }
+  r = store->mount();
+  if (r < 0) {
+    cerr << "mount failed: " << cpp_strerror(r) << std::endl;
+    return r;
+  }
+
+  for (auto shard : sinfo.get_all_shards()) {
+    coll_t cid = get_coll(shard);
+    chs[shard] = store->create_new_collection(cid);
+    ObjectStore::Transaction t;
+    t.create_collection(cid, 0);
+    r = store->queue_transaction(chs[shard], std::move(t));
+    if (r < 0) {
+      return r;
+    }
+  }
+
+  bufferlist content;
+  content.append(string(object_size, 'X'));
+  for (auto &hoid : oids) {
+    bufferlist bl = content;
+    r = write(hoid, 0, bl);
+    if (r < 0) {
+      cerr << "write of " << hoid << " failed: " << cpp_strerror(r)
+           << std::endl;
+      return r;
+    }
+  }
+  return 0;
+}
+
+int ErasureCodePipelineBench::read_shards(
+  const hobject_t &hoid,
+  const ECUtil::shard_extent_set_t &to_read,
+  ECUtil::shard_extent_map_t &sem)
+{
+  // Read what is wanted from the available shards and as much of the
+  // others as the decode of the missing ones needs, like the read
+  // pipeline of the primary does.
+  shard_id_set want_set = to_read.get_shard_id_set();
+  shard_id_set read_set;
+  int r = ec_impl->minimum_to_decode(want_set, available, read_set, nullptr);
+  if (r) {
+    return r;
+  }
+
+  extent_set superset = to_read.get_extent_superset();
+  superset.align(EC_ALIGN_SIZE);
+  for (auto shard : read_set) {
+    const extent_set &eset = to_read.contains(shard) ?
+      to_read.at(shard) : superset;
+    for (auto [off, len] : eset) {
+      bufferlist bl;
+      r = store->read(chs[shard], ghobject_t(hoid, ghobject_t::NO_GEN, shard),
+                      off, len, bl);
+      if (r < 0) {
+        return r;
+      }
+      if (bl.length()) {
+        sem.insert_in_shard(shard, off, bl);
+      }
+    }
+  }
+
+  return sem.decode(ec_impl, to_read, sizes[hoid], &dpp);
+}
+
+int ErasureCodePipelineBench::write(const hobject_t &hoid, uint64_t off,
+                                    bufferlist &bl)
+{
+  uint64_t orig_size = sizes[hoid];
+  object_info_t oi(hoid);
+  oi.size = std::max(orig_size, off + bl.length());
+
+  // temp objects need neither an object context nor a log entry
+  PGTransaction t;
+  t.write(hoid, off, bl.length(), bl);
+
+  ECTransaction::WritePlan plans;
+  plans.plans.emplace_back(hoid, t.op_map.at(hoid), sinfo, available,
+                           available, false, orig_size, oi, std::nullopt,
+                           pdw_write_mode);
+
+  std::map<hobject_t, ECUtil::shard_extent_map_t> partial_extents;
+  if (auto &to_read = plans.plans.front().to_read; to_read) {
+    ECUtil::shard_extent_map_t sem(&sinfo);
+    int r = read_shards(hoid, *to_read, sem);
+    if (r < 0) {
+      return r;
+    }
+    partial_extents.emplace(hoid, std::move(sem));
+  }
+
+  shard_id_map<ObjectStore::Transaction> transactions(sinfo.get_k_plus_m());
+  for (auto shard : available) {
+    transactions[shard];
+  }
+  std::vector<pg_log_entry_t> entries;
+  std::map<hobject_t, ECUtil::shard_extent_map_t> written;
+  std::set<hobject_t> temp_added;
+  std::set<hobject_t> temp_removed;
+  ECTransaction::generate_transactions(
+    &t, plans, ec_impl, pgid, sinfo, partial_extents, entries, &written,
+    &transactions, &temp_added, &temp_removed, &dpp, osdmap);
+
+  for (auto &&[shard, transaction] : transactions) {
+    int r = store->queue_transaction(chs[shard], std::move(transaction));
+    if (r < 0) {
+      return r;
+    }
+  }
+  sizes[hoid] = oi.size;
+  return 0;
+}
+
+int ErasureCodePipelineBench::read(const hobject_t &hoid, uint64_t off,
+                                   uint64_t len, bufferlist *bl)
+{
+  ECUtil::shard_extent_set_t want(sinfo.get_k_plus_m());
+  sinfo.ro_range_to_shard_extent_set(off, len, want);
+
+  ECUtil::shard_extent_map_t sem(&sinfo);
+  int r = read_shards(hoid, want, sem);
+  if (r < 0) {
+    return r;
+  }
+  *bl = sem.get_ro_buffer(off, len);
+  return 0;
+}
+
+int ErasureCodePipelineBench::run(const string &workload, int iterations)
+{
+  if (workload == "read") {
+    // make sure degraded reads return what setup() wrote before timing them
+    bufferlist bl;
+    int r = read(oids.front(), 0, object_size, &bl);
+    if (r < 0) {
+      return r;
+    }
+    if (!bl.contents_equal(string(object_size, 'X').c_str(), object_size)) {
+      cerr << "read of " << oids.front()
+           << " content and written content are different" << std::endl;
+      return -1;
+    }
+  }
+
+  bufferptr object(buffer::create_aligned(object_size, EC_ALIGN_SIZE));
+  object.zero();
+  bufferptr payload(buffer::create_aligned(op_size, EC_ALIGN_SIZE));
+  memset(payload.c_str(), 'Y', op_size);
+
+  uint64_t ops = 0;
+  uint64_t bytes = 0;
+  uint64_t allocations_begin = allocations.load(std::memory_order_relaxed);
+  utime_t begin_time = ceph_clock_now();
+  for (int i = 0; i < iterations; i++) {
+    for (auto &hoid : oids) {
+      bufferlist bl;
+      int r;
+      if (workload == "write") {
+        bl.append(object);
+        r = write(hoid, 0, bl);
+      } else {
+        uint64_t off = (rand() % (object_size / op_size)) * op_size;
+        if (workload == "overwrite") {
+          bl.append(payload);
+          r = write(hoid, off, bl);
+        } else {
+          r = read(hoid, off, op_size, &bl);
+        }
+      }
+      if (r < 0) {
+        cerr << workload << " of " << hoid << " failed: " << cpp_strerror(r)
+             << std::endl;
+        return r;
+      }
+      bytes += workload == "write" ? object_size : op_size;
+      ops++;
+    }
+  }
+  utime_t end_time = ceph_clock_now();
+  uint64_t allocations_end = allocations.load(std::memory_order_relaxed);
+
+  cout << (end_time - begin_time) << "\t" << (bytes / 1024) << "\t" << ops
+       << "\t" << (ops ? (allocations_end - allocations_begin) / ops : 0)
+       << std::endl;
+  return 0;
+}
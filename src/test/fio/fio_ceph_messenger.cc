@@ -30,10 +30,13 @@ enum ceph_msgr_type {
   CEPH_MSGR_TYPE_POSIX,
   CEPH_MSGR_TYPE_DPDK,
   CEPH_MSGR_TYPE_RDMA,
+  CEPH_MSGR_TYPE_IO_URING,
+  CEPH_MSGR_TYPE_SHM,
 };
 
 const char *ceph_msgr_types[] = { "undef", "async+posix",
-				  "async+dpdk", "async+rdma" };
+				  "async+dpdk", "async+rdma",
+				  "async+io_uring", "async+shm" };
 
 struct ceph_msgr_options {
   struct thread_data *td__;
@@ -642,7 +645,7 @@ static std::vector<fio_option> options {
   }),
   make_option([] (fio_option& o) {
     o.name  = "ms_type";
-    o.lname = "CEPH messenger transport type: async+posix, async+dpdk, async+rdma";
+    o.lname = "CEPH messenger transport type: async+posix, async+dpdk, async+rdma, async+io_uring, async+shm";
     o.type  = FIO_OPT_STR;
     o.off1  = offsetof(struct ceph_msgr_options, ms_type);
     o.help  = "Transport type for CEPH messenger, see 'ms async transport type' corresponding CEPH documentation page";
@@ -662,6 +665,14 @@ static std::vector<fio_option> options {
     o.posval[3].ival = "async+rdma";
     o.posval[3].oval = CEPH_MSGR_TYPE_RDMA;
     o.posval[3].help = "RDMA";
+
+    o.posval[4].ival = "async+io_uring";
+    o.posval[4].oval = CEPH_MSGR_TYPE_IO_URING;
+    o.posval[4].help = "io_uring";
+
+    o.posval[5].ival = "async+shm";
+    o.posval[5].oval = CEPH_MSGR_TYPE_SHM;
+    o.posval[5].help = "shared memory for peers on the same host";
   }),
   make_option([] (fio_option& o) {
     o.name  = "ceph_conf_file";
@@ -15,12 +15,16 @@
  *
  */
 
+#include <poll.h>
+
 #include <algorithm>
 #include <atomic>
+#include <filesystem>
 #include <iostream>
 #include <list>
 #include <random>
 #include <string>
+#include <thread>
 #include <set>
 #include <vector>
 #include <gtest/gtest.h>
@@ -30,6 +34,9 @@
 #include "include/Context.h"
 #include "msg/async/Event.h"
 #include "msg/async/Stack.h"
+#ifdef HAVE_LIBURING
+#include "msg/async/IoUringStack.h"
+#endif
 
 using namespace std;
 using namespace std::literals;
@@ -52,6 +59,8 @@ class NetworkWorkerTest : public ::testing::TestWithParam<const char*> {
  public:
   std::shared_ptr<NetworkStack> stack;
   string addr, port_addr;
+  // where the shm listeners are found by the connections of the workers
+  string shm_dir;
 
   NoopConfigObserver fake_obs = {{"ms_type",
 				 "ms_dpdk_coremask",
@@ -66,6 +75,12 @@ class NetworkWorkerTest : public ::testing::TestWithParam<const char*> {
       g_ceph_context->_conf.set_val("ms_type", "async+posix");
       addr = "127.0.0.1:15000";
       port_addr = "127.0.0.1:15001";
+      if (!strcmp(GetParam(), "shm")) {
+        char tmpl[] = "/tmp/ceph_test_async_networkstack.XXXXXX";
+        ASSERT_TRUE(mkdtemp(tmpl));
+        shm_dir = tmpl;
+        g_ceph_context->_conf.set_val_or_die("ms_async_shm_dir", shm_dir);
+      }
     } else {
       g_ceph_context->_conf.set_val_or_die("ms_dpdk_debug_allow_loopback", "true");
       g_ceph_context->_conf.set_val_or_die("ms_async_op_threads", "2");
@@ -73,11 +88,22 @@ class NetworkWorkerTest : public ::testing::TestWithParam<const char*> {
       addr = ipv4_addr + std::string(":15000");
       port_addr = ipv4_addr + std::string(":15001");
     }
+#ifdef HAVE_LIBURING
+    if (!strcmp(GetParam(), "io_uring") &&
+        !IoUringStack::is_supported(g_ceph_context)) {
+      GTEST_SKIP() << "the kernel does not support the io_uring stack";
+    }
+#endif
     stack = NetworkStack::create(g_ceph_context, GetParam());
     stack->start();
   }
   void TearDown() override {
-    stack->stop();
+    if (stack)
+      stack->stop();
+    if (!shm_dir.empty()) {
+      g_ceph_context->_conf.rm_val("ms_async_shm_dir");
+      std::filesystem::remove_all(shm_dir);
+    }
   }
   string get_addr() const {
     return addr;
@@ -196,6 +222,10 @@ TEST_P(NetworkWorkerTest, SimpleTest) {
       r = bind_socket.accept(&srv_socket, options, &cli_addr, worker);
       ASSERT_EQ(0, r);
       ASSERT_TRUE(srv_socket.fd() > 0);
+      // the peer's address, on this host
+      ASSERT_TRUE(cli_addr.is_ip());
+      ASSERT_EQ(bind_addr.ip_only_to_str(), cli_addr.ip_only_to_str());
+      ASSERT_NE(0, cli_addr.get_port());
     }
 
     if (worker->id == 0) {
@@ -262,6 +292,187 @@ TEST_P(NetworkWorkerTest, SimpleTest) {
   });
 }
 
+TEST_P(NetworkWorkerTest, ZerocopySendTest) {
+  if (strcmp(GetParam(), "posix")) {
+    GTEST_SKIP() << "MSG_ZEROCOPY is only used by the posix stack";
+  }
+  entity_addr_t bind_addr;
+  ASSERT_TRUE(bind_addr.parse(get_addr().c_str()));
+  g_ceph_context->_conf.set_val_or_die("ms_async_zerocopy_threshold", "4096");
+
+  exec_events([this, bind_addr](Worker *worker) mutable {
+    if (worker->id != 0)
+      return;
+    SocketOptions options;
+    ServerSocket bind_socket;
+    EventCenter *center = &worker->center;
+    ASSERT_EQ(0, worker->listen(bind_addr, 0, options, &bind_socket));
+
+    ConnectedSocket cli_socket, srv_socket;
+    ASSERT_EQ(0, worker->connect(bind_addr, options, &cli_socket));
+    {
+      C_poll cb(center);
+      center->create_file_event(bind_socket.fd(), EVENT_READABLE, &cb);
+      ASSERT_TRUE(cb.poll(500));
+      center->delete_file_event(bind_socket.fd(), EVENT_READABLE);
+    }
+    entity_addr_t cli_addr;
+    ASSERT_EQ(0, bind_socket.accept(&srv_socket, options, &cli_addr, worker));
+    {
+      C_poll cb(center);
+      center->create_file_event(cli_socket.fd(), EVENT_READABLE, &cb);
+      ssize_t r = cli_socket.is_connected();
+      if (r == 0) {
+        ASSERT_TRUE(cb.poll(500));
+        r = cli_socket.is_connected();
+      }
+      ASSERT_EQ(1, r);
+      center->delete_file_event(cli_socket.fd(), EVENT_READABLE);
+    }
+
+    // small and large buffers alternate, so that copied and zerocopy
+    // sends are mixed in one send()
+    bufferlist bl;
+    for (unsigned i = 0; i < 16; i++) {
+      unsigned len = i % 2 ? 65536 + i : 100 + i;
+      bufferptr bp(buffer::create(len));
+      memset(bp.c_str(), 'a' + i, len);
+      bl.append(std::move(bp));
+    }
+    bufferlist expected = bl;
+    auto logger = worker->get_perf_counter();
+    uint64_t zerocopy_bytes = logger->get(l_msgr_send_zerocopy_bytes);
+
+    C_poll cb(center);
+    center->create_file_event(srv_socket.fd(), EVENT_READABLE, &cb);
+    bufferlist received;
+    char buf[65536];
+    while (received.length() < expected.length()) {
+      if (bl.length()) {
+        ssize_t r = cli_socket.send(bl, false);
+        ASSERT_TRUE(r >= 0);
+      }
+      ssize_t r = srv_socket.read(buf, sizeof(buf));
+      if (r == -EAGAIN) {
+        cb.reset();
+        cb.poll(500);
+        continue;
+      }
+      ASSERT_TRUE(r > 0);
+      received.append(buf, r);
+    }
+    center->delete_file_event(srv_socket.fd(), EVENT_READABLE);
+    ASSERT_TRUE(received.contents_equal(expected));
+    // the large buffers were not copied into the socket buffer by us
+    ASSERT_LT(zerocopy_bytes, logger->get(l_msgr_send_zerocopy_bytes));
+
+    cli_socket.close();
+    srv_socket.close();
+    bind_socket.abort_accept();
+  });
+  g_ceph_context->_conf.set_val_or_die("ms_async_zerocopy_threshold", "0");
+}
+
+// Closing a socket with MSG_ZEROCOPY completions still pending must
+// neither block the worker nor reset the socket while the peer is still
+// taking the data.
+TEST_P(NetworkWorkerTest, ZerocopyCloseTest) {
+  if (strcmp(GetParam(), "posix")) {
+    GTEST_SKIP() << "MSG_ZEROCOPY is only used by the posix stack";
+  }
+  entity_addr_t bind_addr;
+  ASSERT_TRUE(bind_addr.parse(get_addr().c_str()));
+  auto& conf = g_ceph_context->_conf;
+  uint64_t threshold =
+    conf.get_val<Option::size_t>("ms_async_zerocopy_threshold");
+  auto close_timeout = conf.get_val<std::chrono::milliseconds>(
+    "ms_async_zerocopy_close_timeout");
+  conf.set_val_or_die("ms_async_zerocopy_threshold", "4096");
+  conf.set_val_or_die("ms_async_zerocopy_close_timeout", "10000");
+
+  exec_events([this, bind_addr](Worker *worker) mutable {
+    if (worker->id != 0)
+      return;
+    SocketOptions options;
+    ServerSocket bind_socket;
+    EventCenter *center = &worker->center;
+    ASSERT_EQ(0, worker->listen(bind_addr, 0, options, &bind_socket));
+
+    ConnectedSocket cli_socket, srv_socket;
+    ASSERT_EQ(0, worker->connect(bind_addr, options, &cli_socket));
+    {
+      C_poll cb(center);
+      center->create_file_event(bind_socket.fd(), EVENT_READABLE, &cb);
+      ASSERT_TRUE(cb.poll(500));
+      center->delete_file_event(bind_socket.fd(), EVENT_READABLE);
+    }
+    entity_addr_t cli_addr;
+    ASSERT_EQ(0, bind_socket.accept(&srv_socket, options, &cli_addr, worker));
+    {
+      C_poll cb(center);
+      center->create_file_event(cli_socket.fd(), EVENT_READABLE, &cb);
+      ssize_t r = cli_socket.is_connected();
+      if (r == 0) {
+        ASSERT_TRUE(cb.poll(500));
+        r = cli_socket.is_connected();
+      }
+      ASSERT_EQ(1, r);
+      center->delete_file_event(cli_socket.fd(), EVENT_READABLE);
+    }
+
+    // more than the socket buffers hold: while the server does not read,
+    // the tail of what was sent stays queued and its completion pending
+    bufferlist bl;
+    for (unsigned i = 0; i < 64; i++) {
+      bufferptr bp(buffer::create(1 << 20));
+      memset(bp.c_str(), 'a' + i % 26, bp.length());
+      bl.append(std::move(bp));
+    }
+    bufferlist expected = bl;
+    ssize_t sent = cli_socket.send(bl, false);
+    ASSERT_LT(0, sent);
+    ASSERT_LT(sent, (ssize_t)expected.length());
+    expected.splice(sent, expected.length() - sent);
+
+    // the server only starts to read once the client is closing
+    bufferlist received;
+    int error = 0;
+    std::thread reader([&srv_socket, &received, &error] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+      char buf[65536];
+      while (true) {
+        ssize_t r = srv_socket.read(buf, sizeof(buf));
+        if (r == -EAGAIN) {
+          struct pollfd pfd = {srv_socket.fd(), POLLIN, 0};
+          ::poll(&pfd, 1, 100);
+          continue;
+        }
+        if (r <= 0) {
+          error = r;
+          break;
+        }
+        received.append(buf, r);
+      }
+    });
+    // as AsyncConnection does, so that the peer sees the end of the data
+    cli_socket.shutdown();
+    auto start = ceph::mono_clock::now();
+    cli_socket.close();
+    ASSERT_GT(std::chrono::milliseconds(100),
+              ceph::mono_clock::now() - start);
+    reader.join();
+    ASSERT_EQ(0, error);
+    ASSERT_TRUE(received.contents_equal(expected));
+
+    srv_socket.close();
+    bind_socket.abort_accept();
+  });
+  conf.set_val_or_die("ms_async_zerocopy_threshold",
+                      std::to_string(threshold));
+  conf.set_val_or_die("ms_async_zerocopy_close_timeout",
+                      std::to_string(close_timeout.count()));
+}
+
 TEST_P(NetworkWorkerTest, ConnectFailedTest) {
   entity_addr_t bind_addr;
   ASSERT_TRUE(bind_addr.parse(get_addr().c_str()));
@@ -1049,6 +1260,12 @@ INSTANTIATE_TEST_SUITE_P(
   ::testing::Values(
 #ifdef HAVE_DPDK
     "dpdk",
+#endif
+#ifdef __linux__
+    "shm",
+#endif
+#ifdef HAVE_LIBURING
+    "io_uring",
 #endif
     "posix"
   )
@@ -10,6 +10,9 @@
 #include "global/global_context.h"
 
 #include <sstream>
+#include <unistd.h>
+
+#include "zstd_dicts.h"
 
 TEST(CompressorRegistry, con_modes)
 {
@@ -96,3 +99,145 @@ TEST(CompressorRegistry, con_modes)
   // back to normalish, for the benefit of the next test(s)
   cct->_set_module_type(CEPH_ENTITY_TYPE_CLIENT);  
 }
+
+TEST(CompressorRegistry, msg_types)
+{
+  auto cct = g_ceph_context;
+  CompressorRegistry reg(cct);
+
+  ASSERT_FALSE(reg.get_msg_types(CEPH_ENTITY_TYPE_OSD));
+
+  cct->_conf.set_val("ms_osd_compress_msg_types", "osdmap;MOSDPGPush 106");
+  cct->_conf.apply_changes(NULL);
+
+  auto types = reg.get_msg_types(CEPH_ENTITY_TYPE_OSD);
+  ASSERT_TRUE(types);
+  ASSERT_TRUE(types->contains(41, "osdmap"));
+  ASSERT_TRUE(types->contains(105, "MOSDPGPush"));
+  ASSERT_TRUE(types->contains(106, "MOSDPGPull"));
+  ASSERT_FALSE(types->contains(42, "osd_op"));
+  ASSERT_FALSE(reg.get_msg_types(CEPH_ENTITY_TYPE_MON));
+
+  // numbers that are no message type are skipped, rather than thrown on
+  cct->_conf.set_val("ms_osd_compress_msg_types",
+                     "99999999999999999999 65536 osdmap 106");
+  cct->_conf.apply_changes(NULL);
+  types = reg.get_msg_types(CEPH_ENTITY_TYPE_OSD);
+  ASSERT_TRUE(types);
+  ASSERT_TRUE(types->contains(41, "osdmap"));
+  ASSERT_TRUE(types->contains(106, "MOSDPGPull"));
+  ASSERT_FALSE(types->contains(0, "MOSDPGPush"));
+
+  std::vector<std::string> invalid;
+  auto parsed = MsgTypeSet::parse("99999999999999999999;65536;65535", &invalid);
+  ASSERT_TRUE(parsed.contains(65535, ""));
+  ASSERT_EQ((std::vector<std::string>{"99999999999999999999", "65536"}),
+            invalid);
+
+  cct->_conf.set_val("ms_osd_compress_msg_types", "");
+  cct->_conf.apply_changes(NULL);
+  ASSERT_FALSE(reg.get_msg_types(CEPH_ENTITY_TYPE_OSD));
+}
+
+TEST(CompressorRegistry, zstd_dictionary)
+{
+  auto cct = g_ceph_context;
+  auto zstd = Compressor::create(cct, Compressor::COMP_ALG_ZSTD);
+  ASSERT_TRUE(zstd);
+
+  // not a trained dictionary
+  ceph::bufferlist dict;
+  dict.append(std::string(4096, 'D'));
+  ASSERT_EQ(-EINVAL, zstd->set_dictionary(dict));
+
+  auto snappy = Compressor::create(cct, Compressor::COMP_ALG_SNAPPY);
+  ASSERT_TRUE(snappy);
+  ASSERT_EQ(-EOPNOTSUPP, snappy->set_dictionary(dict));
+
+  // without a dictionary each connection gets its own compressor
+  CompressorRegistry reg(cct);
+  ASSERT_NE(reg.create_compressor(Compressor::COMP_ALG_ZSTD),
+            reg.create_compressor(Compressor::COMP_ALG_ZSTD));
+}
+
+static std::string write_zstd_dict(const char *name,
+                                   const unsigned char *dict, size_t len)
+{
+  ceph::bufferlist bl;
+  bl.append(reinterpret_cast<const char*>(dict), len);
+  EXPECT_EQ(0, bl.write_file(name));
+  return name;
+}
+
+TEST(CompressorRegistry, zstd_dictionary_negotiation)
+{
+  auto cct = g_ceph_context;
+  const auto dict_a = write_zstd_dict("zstd_dict_a", zstd_dict_a,
+                                      sizeof(zstd_dict_a));
+  const auto dict_b = write_zstd_dict("zstd_dict_b", zstd_dict_b,
+                                      sizeof(zstd_dict_b));
+  const uint32_t id_a = 32769, id_b = 32770;
+  ceph::bufferlist data;
+  for (int i = 0; i < 100; i++) {
+    data.append("osd." + stringify(i) + " up in weight 1.00 pg 1." +
+                stringify(i * 7) + " epoch " + stringify(1000 + i) + " ");
+  }
+
+  CompressorRegistry reg(cct);
+  cct->_conf.set_val("ms_osd_compression_algorithm", "zstd snappy");
+  cct->_conf.set_val("ms_compress_zstd_dictionary", dict_a);
+  cct->_conf.apply_changes(NULL);
+
+  // the dictionary is offered after the methods
+  const auto request = reg.get_request_methods(CEPH_ENTITY_TYPE_OSD);
+  const std::vector<uint32_t> expected = {
+    Compressor::COMP_ALG_ZSTD, Compressor::COMP_ALG_SNAPPY,
+    CompressorRegistry::ZSTD_DICT_METHOD, id_a };
+  ASSERT_EQ(expected, request);
+  ASSERT_TRUE(reg.get_request_methods(CEPH_ENTITY_TYPE_MON).empty());
+
+  // a peer with the same dictionary uses it
+  uint32_t dict_id = 0;
+  ASSERT_EQ(Compressor::COMP_ALG_ZSTD,
+            reg.pick_method(CEPH_ENTITY_TYPE_OSD, request, &dict_id));
+  ASSERT_EQ(id_a, dict_id);
+  auto with_a = reg.create_compressor(Compressor::COMP_ALG_ZSTD, dict_id);
+  ASSERT_TRUE(with_a);
+  ASSERT_EQ(id_a, with_a->get_dictionary_id());
+
+  ceph::bufferlist compressed, out;
+  std::optional<int32_t> compressor_message;
+  ASSERT_EQ(0, with_a->compress(data, compressed, compressor_message));
+  ASSERT_EQ(0, with_a->decompress(compressed, out, compressor_message));
+  ASSERT_TRUE(data.contents_equal(out));
+
+  // an older peer offers no dictionary
+  ASSERT_EQ(Compressor::COMP_ALG_ZSTD,
+            reg.pick_method(CEPH_ENTITY_TYPE_OSD,
+                            {Compressor::COMP_ALG_ZSTD}, &dict_id));
+  ASSERT_EQ(0u, dict_id);
+  auto plain = reg.create_compressor(Compressor::COMP_ALG_ZSTD, dict_id);
+  ASSERT_TRUE(plain);
+  ASSERT_EQ(0u, plain->get_dictionary_id());
+
+  // with another dictionary the peer's one is turned down, and what was
+  // compressed with it is refused rather than decoded wrongly
+  cct->_conf.set_val("ms_compress_zstd_dictionary", dict_b);
+  cct->_conf.apply_changes(NULL);
+  ASSERT_EQ(Compressor::COMP_ALG_ZSTD,
+            reg.pick_method(CEPH_ENTITY_TYPE_OSD, request, &dict_id));
+  ASSERT_EQ(0u, dict_id);
+  ASSERT_FALSE(reg.create_compressor(Compressor::COMP_ALG_ZSTD, id_a));
+  auto with_b = reg.create_compressor(Compressor::COMP_ALG_ZSTD, id_b);
+  ASSERT_TRUE(with_b);
+  out.clear();
+  ASSERT_EQ(-EINVAL, with_b->decompress(compressed, out, compressor_message));
+
+  cct->_conf.set_val("ms_compress_zstd_dictionary", "");
+  cct->_conf.rm_val("ms_osd_compression_algorithm");
+  cct->_conf.apply_changes(NULL);
+  ASSERT_EQ(std::vector<uint32_t>{Compressor::COMP_ALG_SNAPPY},
+            reg.get_request_methods(CEPH_ENTITY_TYPE_OSD));
+  ::unlink(dict_a.c_str());
+  ::unlink(dict_b.c_str());
+}
@@ -15,6 +15,7 @@
 
 #include "msg/async/frames_v2.h"
 
+#include <iostream>
 #include <numeric>
 #include <ostream>
 #include <string>
@@ -23,6 +24,7 @@
 #include "msg/async/compression_meta.h"
 #include "auth/Auth.h"
 #include "common/ceph_argparse.h"
+#include "common/ceph_time.h"
 #include "global/global_init.h"
 #include "global/global_context.h"
 #include "include/Context.h"
@@ -186,6 +188,24 @@ protected:
         m_middle(make_bufferlist(std::get<0>(GetParam()).middle_len, 'M')),
         m_data(make_bufferlist(std::get<0>(GetParam()).data_len, 'D')) {
     const auto& m = std::get<1>(GetParam());
+    init_crypto();
+    
+    if (m.is_compress) {
+      CompConnectionMeta comp_meta;
+      comp_meta.con_mode = Compressor::COMP_FORCE;
+      comp_meta.con_method = Compressor::COMP_ALG_SNAPPY;
+      m_tx_comp = ceph::compression::onwire::rxtx_t::create_handler_pair(
+        g_ceph_context, comp_meta, /*min_compress_size=*/COMP_THRESHOLD
+      );
+      m_rx_comp = ceph::compression::onwire::rxtx_t::create_handler_pair(
+        g_ceph_context, comp_meta, /*min_compress_size=*/COMP_THRESHOLD
+      );
+    }
+  }
+
+  // (re)creates the handlers with the current configuration
+  void init_crypto() {
+    const auto& m = std::get<1>(GetParam());
     if (m.is_secure) {
       AuthConnectionMeta auth_meta;
       auth_meta.con_mode = CEPH_CON_MODE_SECURE;
@@ -200,18 +220,6 @@ protected:
           g_ceph_context, auth_meta, /*new_nonce_format=*/m.is_rev1,
           /*crossed=*/true);
     }
-    
-    if (m.is_compress) {
-      CompConnectionMeta comp_meta;
-      comp_meta.con_mode = Compressor::COMP_FORCE;
-      comp_meta.con_method = Compressor::COMP_ALG_SNAPPY;
-      m_tx_comp = ceph::compression::onwire::rxtx_t::create_handler_pair(
-        g_ceph_context, comp_meta, /*min_compress_size=*/COMP_THRESHOLD
-      );
-      m_rx_comp = ceph::compression::onwire::rxtx_t::create_handler_pair(
-        g_ceph_context, comp_meta, /*min_compress_size=*/COMP_THRESHOLD
-      );
-    }
   }
 
   void check_frame_assembler(const FrameAssembler& frame_asm) {
@@ -234,7 +242,12 @@ protected:
   }
 
   void test_round_trip() {
-    auto tx_frame = TestFrame::Encode(m_header, m_front, m_middle, m_data);
+    test_round_trip(m_header, m_front, m_middle, m_data);
+  }
+
+  void test_round_trip(const bufferlist& header, const bufferlist& front,
+                       const bufferlist& middle, const bufferlist& data) {
+    auto tx_frame = TestFrame::Encode(header, front, middle, data);
     auto onwire_bl = tx_frame.get_buffer(m_tx_frame_asm);
     check_frame_assembler(m_tx_frame_asm);
     EXPECT_EQ(m_tx_frame_asm.get_frame_onwire_len(), onwire_bl.length());
@@ -249,10 +262,10 @@ protected:
     EXPECT_EQ(m_rx_frame_asm.get_num_segments(), rx_segment_bls.size());
 
     auto rx_frame = TestFrame::Decode(rx_segment_bls);
-    EXPECT_TRUE(m_header.contents_equal(rx_frame.header()));
-    EXPECT_TRUE(m_front.contents_equal(rx_frame.front()));
-    EXPECT_TRUE(m_middle.contents_equal(rx_frame.middle()));
-    EXPECT_TRUE(m_data.contents_equal(rx_frame.data()));
+    EXPECT_TRUE(header.contents_equal(rx_frame.header()));
+    EXPECT_TRUE(front.contents_equal(rx_frame.front()));
+    EXPECT_TRUE(middle.contents_equal(rx_frame.middle()));
+    EXPECT_TRUE(data.contents_equal(rx_frame.data()));
   }
 
   ceph::crypto::onwire::rxtx_t m_tx_crypto;
@@ -280,6 +293,34 @@ TEST_P(RoundTripTest, Reuse) {
   }
 }
 
+// the same content in buffers of 1 to 97 bytes
+static bufferlist fragment(const bufferlist& bl) {
+  bufferlist fragmented;
+  for (uint32_t off = 0, len = 1; off < bl.length();
+       off += len, len = len % 97 + 13) {
+    len = std::min(len, bl.length() - off);
+    bufferlist piece;
+    piece.substr_of(bl, off, len);
+    fragmented.append(buffer::copy(piece.c_str(), len));
+  }
+  return fragmented;
+}
+
+TEST_P(RoundTripTest, Fragmented) {
+  // in secure mode some of the buffers are encrypted in place and some
+  // straight from the plaintext, some of the frames go to the shared
+  // buffers and some do not fit them
+  g_ceph_context->_conf.set_val("ms_crypto_tx_coalesce_max", "64");
+  g_ceph_context->_conf.set_val("ms_crypto_tx_buffer_size", "256");
+  init_crypto();
+  for (int i = 0; i < 3; i++) {
+    test_round_trip(fragment(m_header), fragment(m_front),
+                    fragment(m_middle), fragment(m_data));
+  }
+  g_ceph_context->_conf.rm_val("ms_crypto_tx_coalesce_max");
+  g_ceph_context->_conf.rm_val("ms_crypto_tx_buffer_size");
+}
+
 static const round_trip_instance_t round_trip_instances[] = {
   // first segment is empty
   { 0,   0,   0,   0, 1, {{32,  0,  17,   0,   0,  0},
@@ -437,6 +478,34 @@ TEST_P(RoundTripPerfTest, DISABLED_Basic) {
   }
 }
 
+// compares the encryption of the frames buffer by buffer to a buffer
+// allocated for each of them with the single pass one
+TEST_P(RoundTripPerfTest, DISABLED_SecureTx) {
+  if (!std::get<1>(GetParam()).is_secure) {
+    GTEST_SKIP() << "secure mode only";
+  }
+  for (bool per_buffer : {true, false}) {
+    if (per_buffer) {
+      g_ceph_context->_conf.set_val("ms_crypto_tx_coalesce_max", "0");
+      g_ceph_context->_conf.set_val("ms_crypto_tx_buffer_size", "0");
+    } else {
+      g_ceph_context->_conf.rm_val("ms_crypto_tx_coalesce_max");
+      g_ceph_context->_conf.rm_val("ms_crypto_tx_buffer_size");
+    }
+    init_crypto();
+
+    uint64_t bytes = 0;
+    auto start = ceph::mono_clock::now();
+    for (int i = 0; i < 10000; i++) {
+      auto tx_frame = TestFrame::Encode(m_header, m_front, m_middle, m_data);
+      bytes += tx_frame.get_buffer(m_tx_frame_asm).length();
+    }
+    std::chrono::duration<double> elapsed = ceph::mono_clock::now() - start;
+    std::cout << (per_buffer ? "per buffer: " : "single pass: ")
+              << bytes / elapsed.count() / (1 << 20) << " MiB/s" << std::endl;
+  }
+}
+
 static const round_trip_instance_t round_trip_perf_instances[] = {
   {41, 250, 0,       0, 2, {{32, 41, 250, 17,       0,  0},
                             {32, 48, 256, 32,       0,  0},
@@ -469,6 +538,38 @@ INSTANTIATE_TEST_SUITE_P(
         ::testing::ValuesIn(round_trip_perf_instances),
         ::testing::ValuesIn(modes)));
 
+TEST(CompressionTxHandler, MsgTypes) {
+  using ceph::compression::onwire::TxHandler;
+  auto compressor = Compressor::create(g_ceph_context, Compressor::COMP_ALG_SNAPPY);
+  ASSERT_TRUE(compressor);
+  auto types = std::make_shared<const MsgTypeSet>(
+    MsgTypeSet::parse("osdmap, 105"));
+  TxHandler picky(g_ceph_context, compressor, Compressor::COMP_FORCE,
+                  COMP_THRESHOLD, types);
+  TxHandler all(g_ceph_context, compressor, Compressor::COMP_FORCE,
+                COMP_THRESHOLD);
+  const auto bl = make_bufferlist(8192, 'A');
+
+  picky.set_msg_type(41, "osdmap");
+  picky.reset_handler(1, bl.length());
+  EXPECT_TRUE(picky.compress(bl));
+  picky.set_msg_type(105, "MOSDPGPush");
+  picky.reset_handler(1, bl.length());
+  EXPECT_TRUE(picky.compress(bl));
+  picky.set_msg_type(42, "osd_op");
+  picky.reset_handler(1, bl.length());
+  EXPECT_FALSE(picky.compress(bl));
+  // not a message
+  picky.reset_handler(1, bl.length());
+  EXPECT_FALSE(picky.compress(bl));
+
+  all.set_msg_type(42, "osd_op");
+  all.reset_handler(1, bl.length());
+  EXPECT_TRUE(all.compress(bl));
+  all.reset_handler(1, bl.length());
+  EXPECT_TRUE(all.compress(bl));
+}
+
 }  // namespace ceph::msgr::v2
 
 int main(int argc, char* argv[]) {
@@ -20,6 +20,7 @@
 #include <list>
 #include <memory>
 #include <set>
+#include <thread>
 #include <gmock/gmock-matchers.h>
 #include <stdlib.h>
 #include <time.h>
@@ -36,6 +37,7 @@
 
 #include "common/ceph_argparse.h"
 #include "common/ceph_mutex.h"
+#include "common/perf_counters_collection.h"
 #include "global/global_init.h"
 #include "messages/MCommand.h"
 #include "messages/MPing.h"
@@ -1097,6 +1099,119 @@ TEST_P(MessengerTest, SimpleTest) {
   server_msgr->wait();
 }
 
+class OrderCheckDispatcher : public Dispatcher {
+ public:
+  ceph::mutex lock = ceph::make_mutex("OrderCheckDispatcher::lock");
+  ceph::condition_variable cond;
+  std::map<ConnectionRef, uint64_t> last_seq;
+  std::map<ConnectionRef, std::set<std::thread::id>> threads;
+  uint64_t received = 0;
+  bool out_of_order = false;
+
+  OrderCheckDispatcher() : Dispatcher(g_ceph_context) {}
+  bool ms_dispatch(Message *m) override {
+    std::lock_guard l{lock};
+    auto &last = last_seq[m->get_connection()];
+    if (m->get_seq() <= last) {
+      out_of_order = true;
+    }
+    last = m->get_seq();
+    threads[m->get_connection()].insert(std::this_thread::get_id());
+    received++;
+    cond.notify_all();
+    m->put();
+    return true;
+  }
+  bool ms_handle_reset(Connection *con) override {
+    return true;
+  }
+  void ms_handle_remote_reset(Connection *con) override {}
+  bool ms_handle_refused(Connection *con) override {
+    return false;
+  }
+};
+
+TEST_P(MessengerTest, DispatchThreadsTest) {
+  const unsigned num_shards = 4;
+  auto srv = static_cast<AsyncMessenger*>(
+    Messenger::create(g_ceph_context, string(GetParam()),
+                      entity_name_t::OSD(1), "server", getpid()));
+  srv->set_dispatch_threads(num_shards);
+  srv->set_default_policy(Messenger::Policy::stateless_server(0));
+  srv->set_auth_client(&dummy_auth);
+  srv->set_auth_server(&dummy_auth);
+  srv->set_require_authorizer(false);
+  OrderCheckDispatcher srv_dispatcher;
+  entity_addr_t bind_addr;
+  bind_addr.parse("v2:127.0.0.1");
+  srv->bind(bind_addr);
+  srv->add_dispatcher_head(&srv_dispatcher);
+  srv->start();
+
+  FakeDispatcher cli_dispatcher(false);
+  client_msgr->add_dispatcher_head(&cli_dispatcher);
+  client_msgr->start();
+
+  // add connections until the server side of two of them is pinned to
+  // different shards
+  const unsigned max_conns = 64, num_msgs = 200;
+  vector<ConnectionRef> conns;
+  std::set<unsigned> shards;
+  while (shards.size() < 2 && conns.size() < max_conns) {
+    conns.push_back(client_msgr->connect_to(srv->get_mytype(),
+                                            srv->get_myaddrs(),
+                                            /*anon=*/true));
+    ASSERT_EQ(conns.back()->send_message(new MPing()), 0);
+    std::unique_lock l{srv_dispatcher.lock};
+    srv_dispatcher.cond.wait(l, [&] {
+      return srv_dispatcher.received == conns.size();
+    });
+    shards.clear();
+    for (auto &[con, seq] : srv_dispatcher.last_seq) {
+      shards.insert(srv->get_dispatch_shard(con.get()));
+    }
+  }
+  ASSERT_EQ(2u, shards.size());
+
+  for (unsigned i = 1; i < num_msgs; i++) {
+    for (auto &conn : conns) {
+      ASSERT_EQ(conn->send_message(new MPing()), 0);
+    }
+  }
+  {
+    std::unique_lock l{srv_dispatcher.lock};
+    srv_dispatcher.cond.wait(l, [&] {
+      return srv_dispatcher.received == conns.size() * num_msgs;
+    });
+    ASSERT_FALSE(srv_dispatcher.out_of_order);
+    ASSERT_EQ(conns.size(), srv_dispatcher.last_seq.size());
+    // every connection is delivered by the one thread of its shard, and
+    // the connections of different shards by different threads
+    std::map<unsigned, std::thread::id> shard_threads;
+    std::set<std::thread::id> all_threads;
+    for (auto &[con, con_threads] : srv_dispatcher.threads) {
+      ASSERT_EQ(1u, con_threads.size());
+      auto tid = *con_threads.begin();
+      auto [it, inserted] = shard_threads.emplace(
+        srv->get_dispatch_shard(con.get()), tid);
+      ASSERT_EQ(it->second, tid);
+      if (inserted) {
+        ASSERT_TRUE(all_threads.insert(tid).second);
+      }
+    }
+    ASSERT_EQ(shards.size(), shard_threads.size());
+    srv_dispatcher.last_seq.clear();
+    srv_dispatcher.threads.clear();
+  }
+
+  client_msgr->shutdown();
+  client_msgr->wait();
+  srv->shutdown();
+  srv->wait();
+  ASSERT_EQ(srv->get_dispatch_queue_len(), 0);
+  delete srv;
+}
+
 TEST_P(MessengerTest, SimpleMsgr2Test) {
   FakeDispatcher cli_dispatcher(false), srv_dispatcher(true);
   entity_addr_t legacy_addr;
@@ -2174,6 +2289,59 @@ TEST_P(MessengerTest, SyntheticStressTest) {
   test_msg.wait_for_done();
 }
 
+// the sum and count of msgr_send_batch_frames of all messenger workers
+static std::pair<uint64_t, uint64_t> get_send_batch_frames()
+{
+  std::pair<uint64_t, uint64_t> frames;
+  g_ceph_context->get_perfcounters_collection()->with_counters(
+    [&frames](const PerfCountersCollectionImpl::CounterMap &by_path) {
+      for (auto &&[path, counter] : by_path) {
+        if (path.ends_with(".msgr_send_batch_frames")) {
+          auto [sum, count] = counter.data->read_avg();
+          frames.first += sum;
+          frames.second += count;
+        }
+      }
+    });
+  return frames;
+}
+
+TEST_P(MessengerTest, SyntheticBatchTest) {
+  auto &conf = g_ceph_context->_conf;
+  const uint64_t batch_bytes =
+    conf.get_val<Option::size_t>("ms_async_send_batch_bytes");
+  const uint64_t batch_window =
+    conf.get_val<uint64_t>("ms_async_send_batch_window");
+  // small batches, and frames held back on every busy connection
+  conf.set_val("ms_async_send_batch_bytes", "4096");
+  conf.set_val("ms_async_send_batch_window", "200");
+  const auto [frames_before, sends_before] = get_send_batch_frames();
+  const int num_messages = 5000;
+  {
+    SyntheticWorkload test_msg(8, 32, GetParam(), 100,
+                               Messenger::Policy::stateful_server(0),
+                               Messenger::Policy::lossless_client(0));
+    for (int i = 0; i < 10; ++i) {
+      test_msg.generate_connection();
+    }
+    for (int i = 0; i < num_messages; ++i) {
+      if (!(i % 100)) {
+        lderr(g_ceph_context) << "Op " << i << ": " << dendl;
+        test_msg.print_internal_state();
+      }
+      test_msg.send_message();
+    }
+    test_msg.wait_for_done();
+  }
+  // every frame of every message is counted once it goes to the socket
+  const auto [frames_after, sends_after] = get_send_batch_frames();
+  ASSERT_GE(frames_after - frames_before, (uint64_t)num_messages);
+  ASSERT_LT(sends_before, sends_after);
+  ASSERT_LE(sends_after - sends_before, frames_after - frames_before);
+  conf.set_val("ms_async_send_batch_bytes", std::to_string(batch_bytes));
+  conf.set_val("ms_async_send_batch_window", std::to_string(batch_window));
+}
+
 TEST_P(MessengerTest, SyntheticStressTest1) {
   SyntheticWorkload test_msg(16, 32, GetParam(), 100,
                              Messenger::Policy::lossless_peer_reuse(0),
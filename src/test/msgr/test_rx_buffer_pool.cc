@@ -0,0 +1,125 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:nil -*-
+// vim: ts=8 sw=2 sts=2 expandtab
+
+/*
+ * Ceph - scalable distributed file system
+ *
+ * This is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License version 2.1, as published by the Free Software
+ * Foundation.  See file COPYING.
+ *
+ */
+
+#include <memory>
+
+#include "common/ceph_context.h"
+#include "common/perf_counters.h"
+#include "global/global_context.h"
+#include "msg/async/RxBufferPool.h"
+#include "msg/async/Stack.h"
+
+#include <gtest/gtest.h>
+
+class RxBufferPoolTest : public ::testing::Test {
+ protected:
+  std::unique_ptr<PerfCounters> logger;
+  std::shared_ptr<RxBufferPool> pool;
+
+  void SetUp() override {
+    PerfCountersBuilder plb(g_ceph_context, "rx_buffer_pool_test",
+                            l_msgr_first, l_msgr_last);
+    plb.add_u64_counter(l_msgr_rx_buffer_pool_hits, "hits", "");
+    plb.add_u64_counter(l_msgr_rx_buffer_pool_misses, "misses", "");
+    logger.reset(plb.create_perf_counters());
+    g_ceph_context->_conf.set_val("ms_async_rx_buffer_pool_size", "16384");
+    g_ceph_context->_conf.set_val("ms_async_rx_buffer_pool_max_buffer", "1M");
+    pool = std::make_shared<RxBufferPool>(g_ceph_context, logger.get());
+  }
+  void TearDown() override {
+    pool->shutdown();
+    pool.reset();
+    g_ceph_context->_conf.rm_val("ms_async_rx_buffer_pool_size");
+    g_ceph_context->_conf.rm_val("ms_async_rx_buffer_pool_max_buffer");
+  }
+  uint64_t hits() const {
+    return logger->get(l_msgr_rx_buffer_pool_hits);
+  }
+  uint64_t misses() const {
+    return logger->get(l_msgr_rx_buffer_pool_misses);
+  }
+};
+
+TEST(RxBufferPool, SizeClass) {
+  using p = std::pair<unsigned, unsigned>;
+  ASSERT_EQ(p(0, 4096), RxBufferPool::size_class(1));
+  ASSERT_EQ(p(0, 4096), RxBufferPool::size_class(4096));
+  ASSERT_EQ(p(1, 5120), RxBufferPool::size_class(4097));
+  ASSERT_EQ(p(4, 8192), RxBufferPool::size_class(8000));
+  ASSERT_EQ(p(4, 8192), RxBufferPool::size_class(8192));
+  ASSERT_EQ(p(5, 10240), RxBufferPool::size_class(8193));
+  ASSERT_EQ(p(40, 4 << 20), RxBufferPool::size_class(4 << 20));
+  for (unsigned len = 1; len < (1 << 20); len += 511) {
+    auto [cls, size] = RxBufferPool::size_class(len);
+    ASSERT_LE(len, size);
+    // at most a quarter wasted beyond the first class
+    ASSERT_TRUE(size == 4096 || (size - len) * 4 < size);
+    ASSERT_GE(cls, RxBufferPool::size_class(len > 511 ? len - 511 : 1).first);
+  }
+}
+
+TEST_F(RxBufferPoolTest, Reuse) {
+  const char *data;
+  {
+    auto bp = pool->get(8192, CEPH_PAGE_SIZE);
+    ASSERT_EQ(8192u, bp.length());
+    ASSERT_TRUE(bp.is_page_aligned());
+    data = bp.c_str();
+  }
+  ASSERT_EQ(0u, hits());
+  ASSERT_EQ(1u, misses());
+
+  // the same class
+  auto bp = pool->get(8000, CEPH_PAGE_SIZE);
+  ASSERT_EQ(8000u, bp.length());
+  ASSERT_EQ(data, bp.c_str());
+  ASSERT_EQ(1u, hits());
+
+  // another one
+  auto bp2 = pool->get(100000, CEPH_PAGE_SIZE);
+  ASSERT_EQ(2u, misses());
+}
+
+TEST_F(RxBufferPoolTest, NotPooled) {
+  auto small = pool->get(100, 8);
+  auto large = pool->get(2 << 20, CEPH_PAGE_SIZE);
+  ASSERT_EQ(100u, small.length());
+  ASSERT_EQ(2u << 20, large.length());
+  ASSERT_EQ(0u, hits());
+  ASSERT_EQ(0u, misses());
+}
+
+TEST_F(RxBufferPoolTest, Limit) {
+  {
+    // only two fit the pool once released
+    auto bp1 = pool->get(8192, CEPH_PAGE_SIZE);
+    auto bp2 = pool->get(8192, CEPH_PAGE_SIZE);
+    auto bp3 = pool->get(8192, CEPH_PAGE_SIZE);
+  }
+  ASSERT_EQ(3u, misses());
+  auto bp1 = pool->get(8192, CEPH_PAGE_SIZE);
+  auto bp2 = pool->get(8192, CEPH_PAGE_SIZE);
+  auto bp3 = pool->get(8192, CEPH_PAGE_SIZE);
+  ASSERT_EQ(2u, hits());
+  ASSERT_EQ(4u, misses());
+}
+
+TEST_F(RxBufferPoolTest, OutlivesPool) {
+  auto bp = pool->get(8192, CEPH_PAGE_SIZE);
+  memset(bp.c_str(), 'x', bp.length());
+  pool->shutdown();
+  pool.reset();
+  // the buffer keeps what is left of the pool around
+  ASSERT_EQ('x', bp.c_str()[8191]);
+  pool = std::make_shared<RxBufferPool>(g_ceph_context, logger.get());
+}
@@ -0,0 +1,264 @@
+// zstd dictionaries trained with "zstd --train --maxdict=2048" on samples
+// of text listing OSDs, with ids 32769 and 32770
+
+static const unsigned char zstd_dict_a[] = {
+0x37,0xa4,0x30,0xec,0x1,0x80,0x0,0x0,0x27,0x10,0xc8,0x92,0x24,0x1d,0xff,0xff,
+0xff,0xff,0xff,0xff,0xf,0x40,0xdb,0x2c,0x6e,0xcd,0x36,0x68,0xf8,0xc3,0x5a,0xdb,
+0x8,0x21,0x84,0xff,0x9f,0x8b,0x94,0x72,0xcb,0x2d,0x25,0x59,0xd8,0x99,0x31,0x26,
+0x93,0x4,0x0,0x0,0x0,0x90,0x45,0x45,0x33,0x8a,0x33,0x0,0x0,0x4,0x20,0x8,
+0x7,0x5,0x46,0x54,0xc,0x88,0x82,0x80,0x70,0x40,0x46,0x9f,0xa4,0x20,0x14,0xc4,
+0x89,0xd2,0x1a,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0xb4,
+0x67,0x48,0xae,0x84,0xac,0x31,0x8,0x9,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,
+0x0,0x0,0x0,0x1,0x0,0x0,0x0,0x4,0x0,0x0,0x0,0x8,0x0,0x0,0x0,0x77,
+0x65,0x69,0x67,0x68,0x74,0x20,0x30,0x2e,0x32,0x30,0x20,0x70,0x67,0x20,0x36,0x2e,
+0x38,0x65,0x63,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x30,0x37,0x37,0x20,0x6f,
+0x73,0x64,0x2e,0x38,0x34,0x20,0x74,0x71,0x69,0x6c,0x6b,0x20,0x75,0x70,0x20,0x77,
+0x65,0x69,0x67,0x68,0x74,0x20,0x31,0x2e,0x34,0x33,0x20,0x70,0x67,0x20,0x35,0x2e,
+0x31,0x61,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x30,0x34,0x34,0x20,0x6f,0x73,
+0x64,0x2e,0x31,0x38,0x20,0x6e,0x76,0x66,0x6c,0x72,0x77,0x20,0x75,0x70,0x20,0x69,
+0x6e,0x6f,0x63,0x68,0x20,0x31,0x30,0x38,0x39,0x20,0x6f,0x73,0x64,0x2e,0x32,0x39,
+0x20,0x73,0x67,0x70,0x64,0x76,0x6d,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,
+0x69,0x67,0x68,0x74,0x20,0x31,0x2e,0x35,0x32,0x20,0x70,0x67,0x20,0x36,0x2e,0x61,
+0x39,0x37,0x20,0x69,0x67,0x68,0x74,0x20,0x31,0x2e,0x31,0x35,0x20,0x70,0x67,0x20,
+0x38,0x2e,0x62,0x32,0x61,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x30,0x36,0x36,
+0x20,0x6f,0x73,0x64,0x2e,0x33,0x35,0x20,0x72,0x68,0x6c,0x68,0x76,0x68,0x20,0x75,
+0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x31,0x2e,0x31,0x31,
+0x20,0x70,0x67,0x20,0x39,0x2e,0x65,0x62,0x36,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,
+0x31,0x30,0x36,0x34,0x20,0x6f,0x73,0x64,0x2e,0x36,0x37,0x20,0x6b,0x6e,0x67,0x69,
+0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x30,0x2e,
+0x33,0x34,0x20,0x70,0x67,0x20,0x36,0x2e,0x61,0x62,0x20,0x65,0x70,0x6f,0x63,0x68,
+0x20,0x31,0x32,0x38,0x39,0x20,0x6f,0x73,0x64,0x2e,0x35,0x32,0x20,0x75,0x66,0x66,
+0x71,0x68,0x61,0x20,0x75,0x70,0x20,0x69,0x6e,0x31,0x37,0x20,0x65,0x70,0x6f,0x63,
+0x68,0x20,0x31,0x32,0x30,0x31,0x20,0x6f,0x73,0x64,0x2e,0x37,0x39,0x20,0x7a,0x72,
+0x6a,0x72,0x69,0x77,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,
+0x74,0x20,0x31,0x2e,0x30,0x36,0x20,0x70,0x67,0x20,0x37,0x65,0x69,0x67,0x68,0x74,
+0x20,0x30,0x2e,0x31,0x32,0x20,0x70,0x67,0x20,0x37,0x2e,0x64,0x36,0x62,0x20,0x65,
+0x70,0x6f,0x63,0x68,0x20,0x31,0x31,0x32,0x39,0x20,0x6f,0x73,0x64,0x2e,0x39,0x33,
+0x20,0x64,0x70,0x79,0x6f,0x70,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x65,0x36,0x20,
+0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x31,0x36,0x33,0x20,0x6f,0x73,0x64,0x2e,0x36,
+0x34,0x20,0x69,0x64,0x7a,0x62,0x6a,0x61,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,
+0x65,0x69,0x67,0x68,0x74,0x20,0x31,0x2e,0x31,0x38,0x20,0x70,0x67,0x20,0x33,0x69,
+0x67,0x68,0x74,0x20,0x30,0x2e,0x35,0x35,0x20,0x70,0x67,0x20,0x39,0x2e,0x65,0x39,
+0x35,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x31,0x34,0x33,0x20,0x6f,0x73,0x64,
+0x2e,0x36,0x37,0x20,0x6e,0x70,0x6c,0x6e,0x6c,0x61,0x72,0x20,0x75,0x70,0x20,0x69,
+0x6e,0x70,0x6f,0x63,0x68,0x20,0x31,0x30,0x34,0x37,0x20,0x6f,0x73,0x64,0x2e,0x35,
+0x30,0x20,0x68,0x73,0x64,0x6b,0x61,0x61,0x61,0x75,0x72,0x20,0x75,0x70,0x20,0x69,
+0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x30,0x2e,0x33,0x31,0x20,0x70,0x67,
+0x20,0x32,0x2e,0x69,0x67,0x68,0x74,0x20,0x31,0x2e,0x37,0x37,0x20,0x70,0x67,0x20,
+0x32,0x2e,0x38,0x36,0x35,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x30,0x36,0x35,
+0x20,0x6f,0x73,0x64,0x2e,0x36,0x36,0x20,0x66,0x76,0x69,0x75,0x77,0x6a,0x6f,0x20,
+0x75,0x70,0x20,0x69,0x6e,0x6f,0x63,0x68,0x20,0x31,0x30,0x35,0x34,0x20,0x6f,0x73,
+0x64,0x2e,0x39,0x32,0x20,0x6b,0x70,0x70,0x64,0x61,0x6a,0x6d,0x6b,0x20,0x75,0x70,
+0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x30,0x2e,0x38,0x34,0x20,
+0x70,0x67,0x20,0x34,0x2e,0x63,0x37,0x69,0x67,0x68,0x74,0x20,0x30,0x2e,0x32,0x37,
+0x20,0x70,0x67,0x20,0x31,0x2e,0x35,0x62,0x63,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,
+0x31,0x31,0x38,0x33,0x20,0x6f,0x73,0x64,0x2e,0x38,0x33,0x20,0x76,0x61,0x63,0x6e,
+0x64,0x7a,0x62,0x20,0x75,0x70,0x20,0x69,0x6e,0x65,0x69,0x67,0x68,0x74,0x20,0x30,
+0x2e,0x35,0x34,0x20,0x70,0x67,0x20,0x33,0x2e,0x38,0x33,0x37,0x20,0x65,0x70,0x6f,
+0x63,0x68,0x20,0x31,0x32,0x38,0x34,0x20,0x6f,0x73,0x64,0x2e,0x35,0x20,0x7a,0x6b,
+0x76,0x75,0x6e,0x62,0x78,0x20,0x75,0x70,0x20,0x69,0x6e,0x67,0x68,0x74,0x20,0x30,
+0x2e,0x36,0x31,0x20,0x70,0x67,0x20,0x31,0x2e,0x64,0x32,0x64,0x20,0x65,0x70,0x6f,
+0x63,0x68,0x20,0x31,0x30,0x37,0x33,0x20,0x6f,0x73,0x64,0x2e,0x35,0x36,0x20,0x68,
+0x63,0x78,0x62,0x63,0x65,0x66,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x34,0x34,0x20,
+0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x32,0x33,0x39,0x20,0x6f,0x73,0x64,0x2e,0x31,
+0x20,0x64,0x6d,0x72,0x6c,0x76,0x72,0x70,0x79,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,
+0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x31,0x2e,0x31,0x33,0x20,0x70,0x67,0x20,0x70,
+0x6f,0x63,0x68,0x20,0x31,0x31,0x31,0x33,0x20,0x6f,0x73,0x64,0x2e,0x31,0x34,0x20,
+0x67,0x74,0x6e,0x61,0x68,0x61,0x6d,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,
+0x69,0x67,0x68,0x74,0x20,0x31,0x2e,0x35,0x30,0x20,0x70,0x67,0x20,0x36,0x2e,0x62,
+0x37,0x70,0x6f,0x63,0x68,0x20,0x31,0x31,0x37,0x34,0x20,0x6f,0x73,0x64,0x2e,0x39,
+0x20,0x6d,0x7a,0x67,0x64,0x70,0x61,0x6d,0x6e,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,
+0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x31,0x2e,0x33,0x31,0x20,0x70,0x67,0x20,0x38,
+0x2e,0x38,0x39,0x70,0x6f,0x63,0x68,0x20,0x31,0x32,0x31,0x39,0x20,0x6f,0x73,0x64,
+0x2e,0x33,0x33,0x20,0x6f,0x6a,0x61,0x6e,0x72,0x75,0x64,0x66,0x75,0x20,0x75,0x70,
+0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x30,0x2e,0x36,0x39,0x20,
+0x70,0x67,0x20,0x36,0x2e,0x65,0x69,0x67,0x68,0x74,0x20,0x30,0x2e,0x33,0x38,0x20,
+0x70,0x67,0x20,0x37,0x2e,0x39,0x61,0x34,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,
+0x30,0x39,0x32,0x20,0x6f,0x73,0x64,0x2e,0x32,0x31,0x20,0x6c,0x6a,0x73,0x72,0x64,
+0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x6f,0x63,0x68,0x20,0x31,0x32,0x35,0x31,0x20,
+0x6f,0x73,0x64,0x2e,0x35,0x30,0x20,0x61,0x70,0x62,0x6a,0x77,0x74,0x73,0x73,0x20,
+0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x31,0x2e,0x33,
+0x34,0x20,0x70,0x67,0x20,0x35,0x2e,0x34,0x36,0x70,0x6f,0x63,0x68,0x20,0x31,0x30,
+0x37,0x38,0x20,0x6f,0x73,0x64,0x2e,0x38,0x30,0x20,0x67,0x72,0x72,0x68,0x6d,0x71,
+0x6c,0x73,0x6c,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,
+0x20,0x30,0x2e,0x36,0x35,0x20,0x70,0x67,0x20,0x36,0x2e,0x70,0x6f,0x63,0x68,0x20,
+0x31,0x31,0x38,0x30,0x20,0x6f,0x73,0x64,0x2e,0x33,0x32,0x20,0x70,0x65,0x73,0x72,
+0x79,0x64,0x6b,0x62,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,
+0x74,0x20,0x31,0x2e,0x38,0x30,0x20,0x70,0x67,0x20,0x32,0x2e,0x36,0x33,0x34,0x20,
+0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x30,0x35,0x33,0x20,0x6f,0x73,0x64,0x2e,0x33,
+0x30,0x20,0x62,0x78,0x66,0x6f,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,
+0x67,0x68,0x74,0x20,0x31,0x2e,0x35,0x39,0x20,0x70,0x67,0x20,0x37,0x2e,0x32,0x20,
+0x76,0x67,0x6a,0x6a,0x73,0x70,0x71,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,
+0x69,0x67,0x68,0x74,0x20,0x30,0x2e,0x38,0x37,0x20,0x70,0x67,0x20,0x31,0x2e,0x65,
+0x62,0x31,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x31,0x35,0x30,0x20,0x6f,0x73,
+0x64,0x69,0x67,0x68,0x74,0x20,0x30,0x2e,0x31,0x34,0x20,0x70,0x67,0x20,0x37,0x2e,
+0x37,0x64,0x65,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x30,0x31,0x30,0x20,0x6f,
+0x73,0x64,0x2e,0x39,0x35,0x20,0x76,0x78,0x6c,0x63,0x6f,0x76,0x71,0x64,0x79,0x20,
+0x75,0x70,0x20,0x69,0x67,0x68,0x74,0x20,0x30,0x2e,0x35,0x32,0x20,0x70,0x67,0x20,
+0x37,0x2e,0x35,0x61,0x32,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x31,0x33,0x32,
+0x20,0x6f,0x73,0x64,0x2e,0x35,0x39,0x20,0x63,0x73,0x72,0x68,0x73,0x63,0x20,0x75,
+0x70,0x20,0x69,0x6e,0x20,0x36,0x64,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x30,
+0x38,0x35,0x20,0x6f,0x73,0x64,0x2e,0x30,0x20,0x63,0x6d,0x7a,0x65,0x65,0x6b,0x20,
+0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x31,0x2e,0x37,
+0x31,0x20,0x70,0x67,0x20,0x37,0x2e,0x31,0x61,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,
+0x31,0x30,0x32,0x34,0x20,0x6f,0x73,0x64,0x2e,0x36,0x38,0x20,0x6f,0x68,0x71,0x75,
+0x61,0x6d,0x76,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,
+0x20,0x30,0x2e,0x32,0x39,0x20,0x70,0x67,0x20,0x66,0x30,0x20,0x65,0x70,0x6f,0x63,
+0x68,0x20,0x31,0x30,0x33,0x38,0x20,0x6f,0x73,0x64,0x2e,0x38,0x38,0x20,0x63,0x6a,
+0x6a,0x78,0x66,0x6e,0x73,0x69,0x65,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,
+0x69,0x67,0x68,0x74,0x20,0x31,0x2e,0x36,0x32,0x20,0x70,0x35,0x20,0x65,0x70,0x6f,
+0x63,0x68,0x20,0x31,0x32,0x39,0x34,0x20,0x6f,0x73,0x64,0x2e,0x36,0x35,0x20,0x69,
+0x68,0x69,0x64,0x7a,0x74,0x66,0x6c,0x6a,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,
+0x65,0x69,0x67,0x68,0x74,0x20,0x30,0x2e,0x30,0x30,0x20,0x70,0x67,0x20,0x72,0x67,
+0x6e,0x62,0x70,0x6c,0x73,0x72,0x67,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,
+0x69,0x67,0x68,0x74,0x20,0x30,0x2e,0x37,0x33,0x20,0x70,0x67,0x20,0x37,0x2e,0x38,
+0x35,0x38,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x32,0x32,0x37,0x20,0x6f,0x20,
+0x6d,0x6a,0x61,0x66,0x67,0x6b,0x7a,0x73,0x7a,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,
+0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x31,0x2e,0x34,0x38,0x20,0x70,0x67,0x20,0x36,
+0x2e,0x38,0x34,0x63,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x31,0x30,0x33,0x20,
+0x6f,0x34,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x32,0x35,0x33,0x20,0x6f,0x73,
+0x64,0x2e,0x32,0x30,0x20,0x67,0x73,0x6f,0x66,0x79,0x77,0x74,0x71,0x62,0x20,0x75,
+0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x31,0x2e,0x31,0x39,
+0x20,0x70,0x67,0x32,0x39,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x32,0x36,0x39,
+0x20,0x6f,0x73,0x64,0x2e,0x36,0x32,0x20,0x74,0x7a,0x74,0x6b,0x6f,0x74,0x61,0x20,
+0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x30,0x2e,0x39,
+0x31,0x20,0x70,0x67,0x20,0x62,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x31,0x39,
+0x30,0x20,0x6f,0x73,0x64,0x2e,0x33,0x39,0x20,0x6a,0x64,0x78,0x6b,0x78,0x77,0x71,
+0x6e,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x30,
+0x2e,0x36,0x34,0x20,0x70,0x67,0x20,0x32,0x36,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,
+0x31,0x32,0x30,0x30,0x20,0x6f,0x73,0x64,0x2e,0x35,0x31,0x20,0x79,0x79,0x61,0x77,
+0x6f,0x69,0x78,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,
+0x20,0x31,0x2e,0x32,0x38,0x20,0x70,0x67,0x20,0x33,0x20,0x65,0x70,0x6f,0x63,0x68,
+0x20,0x31,0x32,0x34,0x31,0x20,0x6f,0x73,0x64,0x2e,0x39,0x38,0x20,0x69,0x62,0x76
+};
+
+static const unsigned char zstd_dict_b[] = {
+0x37,0xa4,0x30,0xec,0x2,0x80,0x0,0x0,0x27,0x10,0xc8,0x92,0x24,0x1d,0xff,0xff,
+0xff,0xff,0xff,0xff,0xf,0xc0,0xb7,0xf6,0x3b,0xbc,0x59,0x6b,0x23,0x65,0xbf,0xb5,
+0x84,0x10,0xc2,0xff,0xcf,0x45,0x4a,0x29,0xa5,0x94,0xd2,0x2e,0xcc,0xee,0x4c,0xc,
+0x83,0x6,0x0,0x0,0x0,0x15,0x7,0x23,0xc2,0xd4,0xc,0x0,0x4,0x40,0xb,0x6,
+0x5,0x46,0x99,0x9,0x65,0x31,0x18,0x18,0x1a,0x1c,0xca,0xe3,0x58,0x94,0xc6,0x89,
+0x12,0x12,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x64,0xe7,
+0x67,0x6e,0x45,0xf6,0x5c,0xe7,0xc,0x10,0x1,0x0,0x0,0x0,0x0,0x0,0x0,0x0,
+0x0,0x0,0x1,0x0,0x0,0x0,0x4,0x0,0x0,0x0,0x8,0x0,0x0,0x0,0x65,0x70,
+0x6f,0x63,0x68,0x20,0x31,0x32,0x30,0x30,0x20,0x6f,0x73,0x64,0x2e,0x39,0x35,0x20,
+0x73,0x68,0x74,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,
+0x20,0x31,0x2e,0x30,0x35,0x20,0x70,0x67,0x20,0x32,0x2e,0x32,0x34,0x33,0x20,0x65,
+0x70,0x6f,0x63,0x68,0x20,0x31,0x32,0x30,0x30,0x20,0x6f,0x73,0x64,0x2e,0x39,0x32,
+0x20,0x71,0x7a,0x6c,0x76,0x6f,0x6f,0x6c,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,
+0x65,0x69,0x67,0x68,0x74,0x20,0x31,0x2e,0x30,0x37,0x20,0x70,0x67,0x20,0x32,0x2e,
+0x65,0x65,0x61,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x32,0x30,0x30,0x20,0x6f,
+0x73,0x64,0x2e,0x32,0x30,0x20,0x61,0x7a,0x6f,0x62,0x6e,0x75,0x70,0x6f,0x67,0x20,
+0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x31,0x2e,0x31,
+0x36,0x20,0x70,0x67,0x20,0x33,0x2e,0x64,0x65,0x64,0x20,0x65,0x70,0x6f,0x63,0x68,
+0x20,0x31,0x32,0x30,0x30,0x20,0x6f,0x73,0x64,0x2e,0x36,0x30,0x20,0x63,0x61,0x62,
+0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x30,0x2e,
+0x33,0x39,0x20,0x70,0x67,0x20,0x31,0x2e,0x63,0x34,0x36,0x20,0x65,0x70,0x6f,0x63,
+0x68,0x20,0x31,0x32,0x30,0x30,0x20,0x6f,0x73,0x64,0x2e,0x34,0x30,0x20,0x6d,0x6e,
+0x71,0x66,0x72,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,
+0x20,0x30,0x2e,0x32,0x30,0x20,0x70,0x67,0x20,0x37,0x2e,0x32,0x32,0x66,0x20,0x65,
+0x70,0x6f,0x63,0x68,0x20,0x31,0x32,0x30,0x30,0x20,0x6f,0x73,0x64,0x2e,0x36,0x30,
+0x20,0x63,0x68,0x79,0x70,0x67,0x64,0x73,0x6c,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,
+0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x31,0x2e,0x39,0x39,0x20,0x70,0x67,0x20,0x35,
+0x2e,0x34,0x63,0x32,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x32,0x30,0x30,0x20,
+0x6f,0x73,0x64,0x2e,0x36,0x37,0x20,0x68,0x76,0x61,0x63,0x20,0x75,0x70,0x20,0x69,
+0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x30,0x2e,0x39,0x30,0x20,0x70,0x67,
+0x20,0x38,0x2e,0x34,0x62,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x32,0x30,0x30,
+0x20,0x6f,0x73,0x64,0x2e,0x33,0x38,0x20,0x69,0x73,0x68,0x20,0x75,0x70,0x20,0x69,
+0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x30,0x2e,0x31,0x37,0x20,0x70,0x67,
+0x20,0x33,0x2e,0x34,0x61,0x37,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x32,0x30,
+0x30,0x20,0x6f,0x73,0x64,0x2e,0x35,0x32,0x20,0x77,0x66,0x74,0x69,0x79,0x20,0x75,
+0x70,0x20,0x69,0x67,0x20,0x33,0x2e,0x63,0x65,0x30,0x20,0x65,0x70,0x6f,0x63,0x68,
+0x20,0x31,0x31,0x39,0x32,0x6f,0x73,0x64,0x2e,0x35,0x38,0x20,0x70,0x71,0x6c,0x76,
+0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x30,0x2e,
+0x35,0x35,0x20,0x70,0x67,0x20,0x34,0x2e,0x31,0x63,0x31,0x20,0x65,0x70,0x6f,0x63,
+0x68,0x20,0x31,0x30,0x37,0x34,0x20,0x6f,0x73,0x64,0x2e,0x39,0x39,0x20,0x79,0x6c,
+0x7a,0x73,0x6c,0x6c,0x6f,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,
+0x68,0x74,0x20,0x30,0x2e,0x38,0x31,0x20,0x70,0x67,0x20,0x35,0x2e,0x39,0x35,0x35,
+0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x30,0x37,0x34,0x20,0x6f,0x73,0x64,0x2e,
+0x34,0x39,0x20,0x64,0x61,0x6f,0x7a,0x65,0x71,0x73,0x79,0x6d,0x20,0x75,0x70,0x20,
+0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x30,0x2e,0x39,0x33,0x20,0x70,
+0x67,0x20,0x33,0x2e,0x35,0x37,0x35,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x30,
+0x37,0x34,0x20,0x6f,0x73,0x64,0x2e,0x31,0x33,0x20,0x6f,0x65,0x7a,0x6c,0x69,0x20,
+0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x31,0x2e,0x30,
+0x36,0x20,0x70,0x67,0x20,0x33,0x2e,0x39,0x61,0x31,0x20,0x65,0x70,0x6f,0x63,0x68,
+0x20,0x31,0x30,0x37,0x34,0x20,0x6f,0x73,0x64,0x2e,0x35,0x39,0x20,0x6f,0x6f,0x6a,
+0x72,0x75,0x6d,0x67,0x76,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,
+0x68,0x74,0x20,0x31,0x2e,0x30,0x39,0x20,0x70,0x67,0x20,0x35,0x2e,0x61,0x31,0x66,
+0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x30,0x37,0x34,0x20,0x6f,0x73,0x64,0x2e,
+0x38,0x33,0x20,0x61,0x6c,0x69,0x65,0x66,0x78,0x66,0x71,0x20,0x75,0x70,0x20,0x69,
+0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x30,0x2e,0x30,0x35,0x20,0x70,0x67,
+0x20,0x37,0x2e,0x64,0x63,0x34,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x30,0x37,
+0x34,0x20,0x6f,0x73,0x64,0x2e,0x33,0x39,0x20,0x67,0x78,0x7a,0x6e,0x6e,0x71,0x61,
+0x73,0x73,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,0x20,
+0x30,0x2e,0x34,0x30,0x20,0x70,0x67,0x20,0x38,0x2e,0x31,0x62,0x39,0x20,0x65,0x70,
+0x6f,0x63,0x68,0x20,0x31,0x30,0x37,0x34,0x20,0x6f,0x73,0x64,0x2e,0x37,0x34,0x20,
+0x74,0x63,0x61,0x6a,0x61,0x6c,0x6a,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,
+0x69,0x67,0x68,0x74,0x20,0x30,0x2e,0x35,0x38,0x20,0x70,0x67,0x20,0x35,0x2e,0x38,
+0x33,0x39,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x30,0x37,0x34,0x20,0x6f,0x73,
+0x64,0x2e,0x38,0x31,0x20,0x66,0x6e,0x75,0x6d,0x7a,0x78,0x71,0x6c,0x20,0x75,0x70,
+0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x31,0x2e,0x39,0x34,0x20,
+0x70,0x67,0x20,0x37,0x2e,0x63,0x39,0x63,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,
+0x30,0x37,0x34,0x20,0x6f,0x73,0x64,0x2e,0x32,0x36,0x20,0x71,0x75,0x74,0x73,0x6e,
+0x6a,0x78,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,0x20,
+0x31,0x2e,0x39,0x39,0x20,0x70,0x67,0x20,0x37,0x2e,0x66,0x34,0x20,0x73,0x68,0x74,
+0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x31,0x2e,
+0x38,0x31,0x20,0x70,0x67,0x20,0x32,0x2e,0x39,0x62,0x31,0x20,0x65,0x70,0x6f,0x63,
+0x68,0x20,0x31,0x31,0x33,0x33,0x20,0x6f,0x73,0x64,0x2e,0x33,0x39,0x20,0x63,0x7a,
+0x6b,0x78,0x61,0x67,0x78,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,
+0x68,0x74,0x20,0x31,0x2e,0x33,0x38,0x20,0x70,0x67,0x20,0x35,0x2e,0x61,0x65,0x63,
+0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x31,0x33,0x33,0x20,0x6f,0x73,0x64,0x2e,
+0x38,0x30,0x20,0x71,0x6b,0x65,0x6b,0x69,0x69,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,
+0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x30,0x2e,0x33,0x31,0x20,0x70,0x67,0x20,0x31,
+0x2e,0x66,0x33,0x37,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x31,0x33,0x33,0x20,
+0x6f,0x73,0x64,0x2e,0x37,0x31,0x20,0x78,0x72,0x78,0x6f,0x70,0x76,0x68,0x20,0x75,
+0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x31,0x2e,0x37,0x39,
+0x20,0x70,0x67,0x20,0x37,0x2e,0x65,0x36,0x30,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,
+0x31,0x31,0x33,0x33,0x6f,0x73,0x64,0x2e,0x35,0x37,0x20,0x64,0x79,0x71,0x65,0x69,
+0x68,0x67,0x62,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,
+0x20,0x31,0x2e,0x39,0x33,0x20,0x70,0x67,0x20,0x35,0x2e,0x38,0x39,0x20,0x65,0x70,
+0x6f,0x63,0x68,0x20,0x31,0x32,0x32,0x38,0x20,0x6f,0x73,0x64,0x2e,0x32,0x20,0x77,
+0x6c,0x6a,0x61,0x76,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,
+0x74,0x20,0x31,0x2e,0x31,0x31,0x20,0x70,0x67,0x20,0x36,0x2e,0x36,0x36,0x38,0x20,
+0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x32,0x32,0x38,0x20,0x6f,0x73,0x64,0x2e,0x35,
+0x33,0x20,0x6d,0x6e,0x71,0x66,0x72,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,
+0x69,0x67,0x68,0x74,0x20,0x31,0x2e,0x38,0x35,0x20,0x70,0x67,0x20,0x38,0x2e,0x32,
+0x61,0x63,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x32,0x32,0x38,0x20,0x6f,0x73,
+0x64,0x2e,0x36,0x20,0x74,0x6b,0x75,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,
+0x69,0x67,0x68,0x74,0x20,0x30,0x2e,0x32,0x32,0x20,0x70,0x67,0x20,0x38,0x2e,0x62,
+0x38,0x65,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x32,0x32,0x38,0x20,0x6f,0x73,
+0x64,0x2e,0x31,0x39,0x20,0x79,0x74,0x78,0x62,0x69,0x79,0x6d,0x20,0x75,0x70,0x20,
+0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x30,0x2e,0x37,0x35,0x20,0x70,
+0x67,0x20,0x32,0x2e,0x31,0x65,0x31,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x32,
+0x32,0x38,0x20,0x6f,0x73,0x64,0x2e,0x39,0x30,0x20,0x69,0x64,0x64,0x20,0x75,0x70,
+0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x30,0x2e,0x35,0x38,0x20,
+0x70,0x67,0x20,0x39,0x2e,0x65,0x35,0x33,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,
+0x32,0x32,0x38,0x20,0x6f,0x73,0x64,0x2e,0x39,0x31,0x20,0x77,0x79,0x62,0x62,0x6c,
+0x6c,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x31,
+0x2e,0x32,0x33,0x20,0x70,0x36,0x32,0x20,0x61,0x6d,0x73,0x62,0x7a,0x68,0x65,0x62,
+0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x31,0x2e,
+0x39,0x31,0x20,0x70,0x67,0x20,0x31,0x2e,0x65,0x62,0x32,0x20,0x65,0x70,0x6f,0x63,
+0x68,0x20,0x31,0x30,0x31,0x32,0x20,0x6f,0x73,0x64,0x2e,0x35,0x20,0x78,0x64,0x6a,
+0x6b,0x70,0x61,0x6a,0x6f,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,
+0x68,0x74,0x20,0x31,0x2e,0x39,0x32,0x20,0x70,0x67,0x20,0x34,0x2e,0x64,0x30,0x61,
+0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x30,0x31,0x32,0x20,0x6f,0x73,0x64,0x2e,
+0x37,0x30,0x20,0x66,0x79,0x68,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,
+0x67,0x68,0x74,0x20,0x30,0x2e,0x38,0x34,0x20,0x70,0x67,0x20,0x39,0x2e,0x63,0x65,
+0x36,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x30,0x31,0x32,0x20,0x6f,0x73,0x64,
+0x2e,0x33,0x34,0x20,0x76,0x72,0x66,0x6f,0x7a,0x6e,0x78,0x20,0x75,0x70,0x20,0x69,
+0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x31,0x2e,0x33,0x36,0x20,0x70,0x67,
+0x20,0x35,0x2e,0x64,0x37,0x31,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x30,0x31,
+0x32,0x6f,0x73,0x64,0x2e,0x38,0x33,0x20,0x6e,0x75,0x61,0x77,0x72,0x65,0x76,0x20,
+0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x30,0x2e,0x38,
+0x35,0x20,0x70,0x67,0x20,0x38,0x2e,0x36,0x32,0x64,0x20,0x65,0x70,0x6f,0x63,0x68,
+0x20,0x31,0x31,0x34,0x37,0x20,0x6f,0x73,0x64,0x2e,0x31,0x37,0x20,0x62,0x63,0x63,
+0x6c,0x66,0x78,0x7a,0x76,0x6a,0x20,0x75,0x70,0x20,0x69,0x6e,0x20,0x77,0x65,0x69,
+0x67,0x68,0x74,0x20,0x31,0x2e,0x35,0x37,0x20,0x70,0x67,0x20,0x36,0x2e,0x39,0x65,
+0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x31,0x34,0x37,0x20,0x6f,0x73,0x64,0x2e,
+0x39,0x37,0x20,0x7a,0x74,0x77,0x6c,0x69,0x76,0x6e,0x69,0x71,0x20,0x75,0x70,0x20,
+0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x30,0x2e,0x35,0x37,0x20,0x70,
+0x67,0x20,0x32,0x2e,0x35,0x61,0x30,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31,0x31,
+0x34,0x37,0x20,0x6f,0x73,0x64,0x2e,0x35,0x20,0x64,0x76,0x7a,0x70,0x20,0x75,0x70,
+0x20,0x69,0x6e,0x20,0x77,0x65,0x69,0x67,0x68,0x74,0x20,0x31,0x2e,0x30,0x34,0x20,
+0x70,0x67,0x20,0x31,0x2e,0x37,0x63,0x63,0x20,0x65,0x70,0x6f,0x63,0x68,0x20,0x31
+};
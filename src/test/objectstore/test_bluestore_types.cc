@@ -394,6 +394,37 @@ TEST(bluestore_blob_t, calc_csum) {
   }
 }
 
+TEST(bluestore_blob_t, get_crc32c_from_csum) {
+  bufferlist bl;
+  bl.append("asdfghjkqwertyuizxcvbnm,");
+  uint32_t crc;
+
+  bluestore_blob_t b;
+  ASSERT_FALSE(b.get_crc32c_from_csum(0, 24, &crc));
+  b.init_csum(Checksummer::CSUM_XXHASH32, 3, 24);
+  b.calc_csum(0, bl);
+  ASSERT_FALSE(b.get_crc32c_from_csum(0, 24, &crc));
+
+  b = bluestore_blob_t();
+  b.init_csum(Checksummer::CSUM_CRC32C, 3, 24);
+  b.calc_csum(0, bl);
+  ASSERT_TRUE(b.get_crc32c_from_csum(0, 24, &crc));
+  ASSERT_EQ(bl.crc32c(-1), crc);
+  for (unsigned off = 0; off < 24; off += 8) {
+    for (unsigned len = 8; off + len <= 24; len += 8) {
+      bufferlist sub;
+      sub.substr_of(bl, off, len);
+      ASSERT_TRUE(b.get_crc32c_from_csum(off, len, &crc));
+      ASSERT_EQ(sub.crc32c(-1), crc);
+    }
+  }
+  // not chunk aligned, or beyond the csum'ed range
+  ASSERT_FALSE(b.get_crc32c_from_csum(4, 8, &crc));
+  ASSERT_FALSE(b.get_crc32c_from_csum(0, 12, &crc));
+  ASSERT_FALSE(b.get_crc32c_from_csum(16, 16, &crc));
+  ASSERT_FALSE(b.get_crc32c_from_csum(0, 0, &crc));
+}
+
 TEST(bluestore_blob_t, csum_bench) {
   bufferlist bl;
   bufferptr bp(10485760);
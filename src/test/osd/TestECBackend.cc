@@ -17,6 +17,8 @@
 #include <sstream>
 #include <errno.h>
 #include <signal.h>
+#include <mutex>
+#include <thread>
 #include "osd/ECCommon.h"
 #include "osd/ECBackend.h"
 #include "gtest/gtest.h"
@@ -220,6 +222,11 @@ public:
     return 0;
   }
 
+  int encode_chunks_batch(const std::vector<shard_id_map<bufferptr>> &in,
+                          std::vector<shard_id_map<bufferptr>> &out) override {
+    return 0;
+  }
+
   int decode(const shard_id_set &want_to_read, const shard_id_map<bufferlist> &chunks, shard_id_map<bufferlist> *decoded,
 	     int chunk_size) override {
     return 0;
@@ -241,6 +248,18 @@ public:
     return 0;
   }
 
+  int decode_chunks_batch(const shard_id_set &want_to_read,
+                          std::vector<shard_id_map<bufferptr>> &in,
+                          std::vector<shard_id_map<bufferptr>> &out) override
+  {
+    for (size_t i = 0; i < in.size(); ++i) {
+      if (int r = decode_chunks(want_to_read, in[i], out[i])) {
+        return r;
+      }
+    }
+    return 0;
+  }
+
   int decode_chunks(const shard_id_set &want_to_read,
                     shard_id_map<bufferptr> &in, shard_id_map<bufferptr> &out) override
   {
@@ -318,10 +337,21 @@ private:
 
 public:
   set<pg_shard_t> acting_shards;
+  /// the PG lock of the timer callbacks
+  std::mutex lock;
+  common::intrusive_timer *timer = nullptr;
+  /// the messages of send_message_osd_cluster()
+  vector<std::pair<int, Message *>> sent;
 
   ECListenerStub()
     : pg_log(NULL) {}
 
+  ~ECListenerStub() {
+    for (auto &&[osd, m] : sent) {
+      m->put();
+    }
+  }
+
   const OSDMapRef &pgb_get_osdmap() const override {
     return osd_map_ref;
   }
@@ -421,6 +451,27 @@ public:
 
   }
 
+  void pg_lock() override {
+    lock.lock();
+  }
+
+  void pg_unlock() override {
+    lock.unlock();
+  }
+
+  void pg_add_ref() override {
+
+  }
+
+  void pg_dec_ref() override {
+
+  }
+
+  common::intrusive_timer &get_pg_timer() override {
+    ceph_assert(timer);
+    return *timer;
+  }
+
   epoch_t get_interval_start_epoch() const override {
     return 0;
   }
@@ -462,7 +513,7 @@ public:
   }
 
   void send_message_osd_cluster(vector<std::pair<int, Message *>> &messages, epoch_t from_epoch) override {
-
+    sent.insert(sent.end(), messages.begin(), messages.end());
   }
 
   void send_message_osd_cluster(int osd, MOSDPGPush* msg, epoch_t from_epoch) override {
@@ -1255,6 +1306,310 @@ TEST(ECCommon, get_remaining_shards)
   }
 }
 
+// Sets a config option until the end of the scope.
+class ConfigGuard {
+  std::string name;
+  std::string old_value;
+
+public:
+  ConfigGuard(const std::string &name, const std::string &value)
+    : name(name) {
+    g_ceph_context->_conf.get_val(name, &old_value);
+    g_ceph_context->_conf.set_val_or_die(name, value);
+  }
+  ~ConfigGuard() {
+    g_ceph_context->_conf.set_val_or_die(name, old_value);
+  }
+};
+
+TEST(ECCommon, get_min_avail_to_read_shards_avoids_slow_shard)
+{
+  const uint64_t align_size = EC_ALIGN_SIZE;
+  const uint64_t swidth = 64*align_size;
+  const unsigned int k = 4;
+  const unsigned int m = 2;
+  const int nshards = 6;
+  const uint64_t object_size = swidth * 1024;
+
+  ECUtil::stripe_info_t s(k, m, swidth, vector<shard_id_t>(0));
+  ECListenerStub listenerStub;
+
+  ErasureCodeDummyImpl *ecode = new ErasureCodeDummyImpl();
+  ErasureCodeInterfaceRef ec_impl(ecode);
+  ECCommon::ReadPipeline pipeline(g_ceph_context, ec_impl, s, &listenerStub);
+
+  vector<pg_shard_t> pg_shards(nshards);
+  for (int i = 0; i < nshards; i++) {
+    pg_shards[i] = pg_shard_t(i, shard_id_t(i));
+    listenerStub.acting_shards.insert(pg_shards[i]);
+    pipeline.osd_read_latency[i].add_sample(1000000);
+  }
+  // osd.2 is twenty times slower than the rest.
+  pipeline.osd_read_latency[2] = ECCommon::ReadPipeline::read_latency_t();
+  pipeline.osd_read_latency[2].add_sample(20000000);
+
+  hobject_t hoid;
+  ECUtil::shard_extent_set_t to_read(s.get_k_plus_m());
+  for (unsigned int i = 0; i < k; i++) {
+    to_read[shard_id_t(i)].insert(0, 4096);
+  }
+
+  // Without hedging the slow shard is read like any other.
+  {
+    ECCommon::read_request_t read_request(to_read, false, object_size);
+    ASSERT_EQ(0, pipeline.get_min_avail_to_read_shards(
+      hoid, false, false, read_request, std::nullopt));
+    ASSERT_TRUE(read_request.shard_reads.contains(shard_id_t(2)));
+  }
+
+  ConfigGuard hedge("osd_ec_read_hedge", "true");
+  {
+    ECCommon::read_request_t read_request(to_read, false, object_size);
+    ASSERT_EQ(0, pipeline.get_min_avail_to_read_shards(
+      hoid, false, false, read_request, std::nullopt));
+
+    ECCommon::read_request_t ref(to_read, false, object_size);
+    for (unsigned int shard : {0, 1, 3, 4}) {
+      ECCommon::shard_read_t shard_read;
+      shard_read.subchunk = ecode->default_sub_chunk;
+      shard_read.extents.insert(0, 4096);
+      shard_read.pg_shard = pg_shards[shard];
+      ref.shard_reads[shard_id_t(shard)] = shard_read;
+    }
+    ASSERT_EQ(read_request, ref);
+  }
+
+  // Recovery reads do not avoid slow shards.
+  {
+    ECCommon::read_request_t read_request(to_read, false, object_size);
+    ASSERT_EQ(0, pipeline.get_min_avail_to_read_shards(
+      hoid, true, false, read_request, std::nullopt));
+    ASSERT_TRUE(read_request.shard_reads.contains(shard_id_t(2)));
+  }
+
+  // The slow shard is still read if nothing else can replace it.
+  {
+    std::set<pg_shard_t> error_shards = {pg_shards[4], pg_shards[5]};
+    ECCommon::read_request_t read_request(to_read, false, object_size);
+    ASSERT_EQ(0, pipeline.get_min_avail_to_read_shards(
+      hoid, false, false, read_request, error_shards));
+    ASSERT_TRUE(read_request.shard_reads.contains(shard_id_t(2)));
+  }
+}
+
+struct ReadCompleterStub : ECCommon::ReadCompleter {
+  int *finished;
+
+  explicit ReadCompleterStub(int *finished) : finished(finished) {}
+
+  void finish_single_request(
+      const hobject_t &hoid,
+      ECCommon::read_result_t &&res,
+      ECCommon::read_request_t &req) override {}
+
+  void finish(int priority) && override {
+    ++*finished;
+  }
+};
+
+// What ECBackend::handle_sub_read_reply() makes of a successful sub read.
+static void fake_sub_read_reply(
+    ECCommon::ReadPipeline &pipeline,
+    ECCommon::ReadOp &rop,
+    const hobject_t &hoid,
+    pg_shard_t from) {
+  auto &complete = rop.complete.try_emplace(hoid, &pipeline.sinfo).first->second;
+  complete.processed_read_requests[from.shard].union_of(
+    rop.to_read.at(hoid).shard_reads.at(from.shard).extents);
+  pipeline.note_sub_read_reply(rop, from);
+  pipeline.shard_to_read_map[from].erase(rop.tid);
+  rop.in_progress.erase(from);
+}
+
+struct ECHedgeTest : public ::testing::Test {
+  static constexpr unsigned k = 4;
+  static constexpr unsigned m = 2;
+  static constexpr int nshards = 6;
+  static constexpr uint64_t swidth = 64 * EC_ALIGN_SIZE;
+  static constexpr uint64_t object_size = swidth * 1024;
+
+  ConfigGuard hedge{"osd_ec_read_hedge", "true"};
+  ConfigGuard min_delay{"osd_ec_read_hedge_min_delay", "1"};
+  ECUtil::stripe_info_t s{k, m, swidth, vector<shard_id_t>(0)};
+  ECListenerStub listenerStub;
+  ErasureCodeInterfaceRef ec_impl{new ErasureCodeDummyImpl()};
+  ECCommon::ReadPipeline pipeline{g_ceph_context, ec_impl, s, &listenerStub};
+  common::intrusive_timer timer;
+  vector<pg_shard_t> pg_shards = vector<pg_shard_t>(nshards);
+  hobject_t hoid;
+  int finished = 0;
+
+  void SetUp() override {
+    listenerStub.timer = &timer;
+    for (int i = 0; i < nshards; i++) {
+      pg_shards[i] = pg_shard_t(i, shard_id_t(i));
+      listenerStub.acting_shards.insert(pg_shards[i]);
+      pipeline.osd_read_latency[i].add_sample(1000000);
+    }
+  }
+
+  void TearDown() override {
+    {
+      std::lock_guard l(listenerStub.lock);
+      pipeline.on_change();
+    }
+    timer.stop();
+  }
+
+  /// start a read of the first 4k of the k data shards, call with the lock
+  ECCommon::ReadOp &start_read() {
+    ECUtil::shard_extent_set_t to_read(s.get_k_plus_m());
+    for (unsigned i = 0; i < k; i++) {
+      to_read[shard_id_t(i)].insert(0, 4096);
+    }
+    ECCommon::read_request_t read_request(to_read, false, object_size);
+    EXPECT_EQ(0, pipeline.get_min_avail_to_read_shards(
+      hoid, false, false, read_request, std::nullopt));
+    map<hobject_t, ECCommon::read_request_t> reads;
+    reads.emplace(hoid, std::move(read_request));
+    pipeline.start_read_op(0, reads, false, false,
+                           std::make_unique<ReadCompleterStub>(&finished));
+    return pipeline.tid_to_read_map.begin()->second;
+  }
+
+  /// wait up to a few seconds for pred to hold, evaluated with the lock
+  template <typename Pred>
+  bool wait_for(Pred &&pred) {
+    for (int i = 0; i < 5000; ++i) {
+      {
+        std::lock_guard l(listenerStub.lock);
+        if (pred()) {
+          return true;
+        }
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+  }
+};
+
+TEST_F(ECHedgeTest, hedge_late_shard)
+{
+  {
+    std::lock_guard l(listenerStub.lock);
+    auto &rop = start_read();
+    ASSERT_EQ(k, listenerStub.sent.size());
+    ASSERT_TRUE(rop.hedge_at);
+    ASSERT_TRUE(pipeline.hedge_callback.is_scheduled());
+    // shard 3 is late
+    for (unsigned i = 0; i < 3; i++) {
+      fake_sub_read_reply(pipeline, rop, hoid, pg_shards[i]);
+    }
+  }
+
+  // the timer reads the parity shard 4 in place of the late shard 3
+  ASSERT_TRUE(wait_for([this] {
+    return pipeline.tid_to_read_map.begin()->second.hedged;
+  }));
+  std::lock_guard l(listenerStub.lock);
+  auto &rop = pipeline.tid_to_read_map.begin()->second;
+  ASSERT_EQ(k + 1, listenerStub.sent.size());
+  ASSERT_EQ(4, listenerStub.sent.back().first);
+  ASSERT_EQ(std::set<pg_shard_t>({pg_shards[3], pg_shards[4]}),
+            rop.in_progress);
+  ASSERT_TRUE(rop.to_read.at(hoid).shard_reads.contains(shard_id_t(4)));
+  ASSERT_FALSE(rop.hedge_at);
+
+  // a second deadline does not hedge again
+  ASSERT_FALSE(pipeline.hedge_read_op(rop));
+  ASSERT_EQ(k + 1, listenerStub.sent.size());
+
+  // zeros of the late shard are not used to decode, those of others are
+  rop.to_read.at(hoid).zeros_for_decode[shard_id_t(3)].insert(0, 4096);
+  rop.to_read.at(hoid).zeros_for_decode[shard_id_t(5)].insert(0, 4096);
+  fake_sub_read_reply(pipeline, rop, hoid, pg_shards[4]);
+  shard_id_set expected;
+  for (unsigned shard : {0, 1, 2, 4, 5}) {
+    expected.insert(shard_id_t(shard));
+  }
+  ASSERT_EQ(expected, pipeline.get_decode_shards(
+    rop, hoid, rop.complete.at(hoid)));
+
+  // completing accounts the time waited on the late shard, and its reply,
+  // should it still come, finds neither the op nor a sub read to clear
+  const ceph_tid_t tid = rop.tid;
+  pipeline.complete_read_op(std::move(rop));
+  ASSERT_EQ(1, finished);
+  ASSERT_FALSE(pipeline.tid_to_read_map.contains(tid));
+  ASSERT_FALSE(pipeline.shard_to_read_map[pg_shards[3]].contains(tid));
+  ASSERT_LT(1000000, pipeline.osd_read_latency[3].avg_ns);
+}
+
+TEST_F(ECHedgeTest, late_shard_replies_first)
+{
+  {
+    std::lock_guard l(listenerStub.lock);
+    auto &rop = start_read();
+    for (unsigned i = 0; i < 3; i++) {
+      fake_sub_read_reply(pipeline, rop, hoid, pg_shards[i]);
+    }
+  }
+  ASSERT_TRUE(wait_for([this] {
+    return pipeline.tid_to_read_map.begin()->second.hedged;
+  }));
+
+  // the late shard beats the hedge: it is enough to decode
+  std::lock_guard l(listenerStub.lock);
+  auto &rop = pipeline.tid_to_read_map.begin()->second;
+  fake_sub_read_reply(pipeline, rop, hoid, pg_shards[3]);
+  shard_id_set expected;
+  for (unsigned shard : {0, 1, 2, 3}) {
+    expected.insert(shard_id_t(shard));
+  }
+  ASSERT_EQ(expected, pipeline.get_decode_shards(
+    rop, hoid, rop.complete.at(hoid)));
+  ASSERT_EQ(std::set<pg_shard_t>({pg_shards[4]}), rop.in_progress);
+
+  const ceph_tid_t tid = rop.tid;
+  pipeline.complete_read_op(std::move(rop));
+  ASSERT_EQ(1, finished);
+  ASSERT_FALSE(pipeline.shard_to_read_map[pg_shards[4]].contains(tid));
+}
+
+TEST_F(ECHedgeTest, cancel)
+{
+  // an interval change cancels the timer
+  {
+    std::lock_guard l(listenerStub.lock);
+    start_read();
+    ASSERT_TRUE(pipeline.hedge_callback.is_scheduled());
+    pipeline.on_change();
+    ASSERT_FALSE(pipeline.hedge_callback.is_scheduled());
+    ASSERT_TRUE(pipeline.tid_to_read_map.empty());
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  {
+    std::lock_guard l(listenerStub.lock);
+    ASSERT_EQ(k, listenerStub.sent.size());
+  }
+
+  // a read which completed in time is not hedged when the timer fires
+  {
+    std::lock_guard l(listenerStub.lock);
+    auto &rop = start_read();
+    for (unsigned i = 0; i < k; i++) {
+      fake_sub_read_reply(pipeline, rop, hoid, pg_shards[i]);
+    }
+    pipeline.complete_read_op(std::move(rop));
+    ASSERT_EQ(1, finished);
+  }
+  ASSERT_TRUE(wait_for([this] {
+    return !pipeline.hedge_callback.is_scheduled();
+  }));
+  std::lock_guard l(listenerStub.lock);
+  ASSERT_EQ(2 * k, listenerStub.sent.size());
+}
+
 TEST(ECCommon, encode)
 {
   const uint64_t align_size = EC_ALIGN_SIZE;
@@ -1282,6 +1637,87 @@ TEST(ECCommon, encode)
   semap.encode(ec_impl);
 }
 
+// Every parity is the XOR of the data, enough to check the delta plumbing.
+class ErasureCodeXorDeltaImpl : public ErasureCodeDummyImpl {
+public:
+  void encode_delta(const bufferptr &old_data, const bufferptr &new_data,
+                    bufferptr *delta) override {
+    if (&old_data != delta) {
+      memcpy(delta->c_str(), old_data.c_str(), delta->length());
+    }
+    for (unsigned i = 0; i < delta->length(); i++) {
+      delta->c_str()[i] ^= new_data.c_str()[i];
+    }
+  }
+  void apply_delta(const shard_id_map<bufferptr> &in,
+                   shard_id_map<bufferptr> &out) override {
+    for (auto &&[parity_shard, parity] : out) {
+      for (auto &&[data_shard, delta] : in) {
+        ASSERT_EQ(delta.length(), parity.length());
+        for (unsigned i = 0; i < parity.length(); i++) {
+          parity.c_str()[i] ^= delta.c_str()[i];
+        }
+      }
+    }
+  }
+};
+
+TEST(ECCommon, encode_parity_delta)
+{
+  const uint64_t chunk_size = EC_ALIGN_SIZE;
+  const unsigned int k = 4;
+  const unsigned int m = 2;
+
+  ECUtil::stripe_info_t s(k, m, k * chunk_size, vector<shard_id_t>(0));
+  ErasureCodeInterfaceRef ec_impl(new ErasureCodeXorDeltaImpl);
+
+  auto random_buf = [](uint64_t len) {
+    bufferptr bp = buffer::create_page_aligned(len);
+    for (unsigned i = 0; i < len; i++) {
+      bp.c_str()[i] = std::rand();
+    }
+    bufferlist bl;
+    bl.append(bp);
+    return bl;
+  };
+
+  // Small overwrites of shards 0 and 2 in the first stripe and of shard 1
+  // in the third stripe.
+  const std::vector<std::pair<shard_id_t, uint64_t>> writes = {
+    {shard_id_t(0), 0}, {shard_id_t(2), 0}, {shard_id_t(1), 2 * chunk_size}};
+
+  ECUtil::shard_extent_map_t old_sem(&s);
+  ECUtil::shard_extent_map_t to_write(&s);
+  for (auto &&[shard, off] : writes) {
+    old_sem.insert_in_shard(shard, off, random_buf(chunk_size));
+    to_write.insert_in_shard(shard, off, random_buf(chunk_size));
+  }
+  std::map<shard_id_t, bufferlist> expected;
+  for (auto parity : s.get_parity_shards()) {
+    bufferlist old_parity = random_buf(3 * chunk_size);
+    expected[parity].append(old_parity.c_str(), old_parity.length());
+    to_write.insert_in_shard(parity, 0, old_parity);
+  }
+  for (auto &&[shard, off] : writes) {
+    bufferlist old_bl, new_bl;
+    old_sem.get_buffer(shard, off, chunk_size, old_bl);
+    to_write.get_buffer(shard, off, chunk_size, new_bl);
+    for (auto &&[parity, bl] : expected) {
+      for (unsigned i = 0; i < chunk_size; i++) {
+        bl.c_str()[off + i] ^= old_bl[i] ^ new_bl[i];
+      }
+    }
+  }
+
+  ASSERT_EQ(0, to_write.encode_parity_delta(ec_impl, old_sem, nullptr));
+
+  for (auto &&[parity, bl] : expected) {
+    bufferlist out;
+    to_write.get_buffer(parity, 0, 3 * chunk_size, out);
+    ASSERT_TRUE(out.contents_equal(bl)) << "parity shard " << parity;
+  }
+}
+
 bufferlist create_buf(uint64_t len) {
   bufferlist bl;
 
@@ -23,6 +23,7 @@
 
 using namespace std;
 using namespace ECLegacy;
+using ceph::bufferlist;
 
 TEST(ECUtil, stripe_info_t)
 {
@@ -166,6 +167,123 @@ TEST(ECUtil, offset_length_is_same_stripe)
 }
 
 
+// what handle_sub_read returned when it read each sub-chunk run on its
+// own: every read is cut short at the end of the object
+static bufferlist read_subchunk_runs(
+  const bufferlist &object,
+  uint64_t chunk_size,
+  uint64_t subchunk_size,
+  uint64_t off,
+  uint64_t len,
+  const vector<pair<int, int>> &subchunks)
+{
+  bufferlist out;
+  for (uint64_t m = 0; m < len; m += chunk_size) {
+    for (auto &&[first, count] : subchunks) {
+      uint64_t run_off = off + m + first * subchunk_size;
+      uint64_t run_end = std::min<uint64_t>(run_off + count * subchunk_size,
+                                            object.length());
+      if (run_off < run_end) {
+        bufferlist run;
+        run.substr_of(object, run_off, run_end - run_off);
+        out.append(run);
+      }
+    }
+  }
+  return out;
+}
+
+// what a readv of @extents returns
+static bufferlist readv(const bufferlist &object,
+                        const interval_set<uint64_t> &extents)
+{
+  bufferlist out;
+  for (auto &&[off, len] : extents) {
+    bufferlist bl;
+    bl.substr_of(object, off, len);
+    out.append(bl);
+  }
+  return out;
+}
+
+TEST(ECUtil, subchunk_extents)
+{
+  // 8 sub-chunks of 8 bytes per 64 byte chunk
+  ECUtilL::stripe_info_t s(2, 1, 128);
+  const uint64_t chunk_size = s.get_chunk_size();
+  const unsigned sub_chunk_count = 8;
+  const uint64_t subchunk_size = chunk_size / sub_chunk_count;
+  ASSERT_EQ(64u, chunk_size);
+
+  bufferlist object;
+  for (unsigned i = 0; i < 4 * chunk_size; i++) {
+    object.append(static_cast<char>(i));
+  }
+
+  // runs that touch are merged, also across a chunk boundary
+  {
+    vector<pair<int, int>> subchunks = {{0, 2}, {2, 1}, {6, 2}};
+    auto extents = ECUtilL::subchunk_extents(
+      s, sub_chunk_count, 0, 2 * chunk_size, subchunks, object.length());
+    interval_set<uint64_t> expected;
+    expected.insert(0, 3 * subchunk_size);
+    expected.insert(6 * subchunk_size, 5 * subchunk_size);
+    expected.insert(chunk_size + 6 * subchunk_size, 2 * subchunk_size);
+    ASSERT_EQ(expected, extents);
+    ASSERT_TRUE(readv(object, extents).contents_equal(
+      read_subchunk_runs(object, chunk_size, subchunk_size,
+                         0, 2 * chunk_size, subchunks)));
+  }
+
+  // runs that don't touch stay apart, one extent per run per chunk
+  {
+    vector<pair<int, int>> subchunks = {{1, 1}, {4, 2}};
+    auto extents = ECUtilL::subchunk_extents(
+      s, sub_chunk_count, chunk_size, 2 * chunk_size, subchunks,
+      object.length());
+    ASSERT_EQ(4u, extents.num_intervals());
+    ASSERT_EQ(6 * subchunk_size, extents.size());
+    ASSERT_EQ(chunk_size + subchunk_size, extents.range_start());
+    ASSERT_EQ(2 * chunk_size + 6 * subchunk_size, extents.range_end());
+    ASSERT_TRUE(readv(object, extents).contents_equal(
+      read_subchunk_runs(object, chunk_size, subchunk_size,
+                         chunk_size, 2 * chunk_size, subchunks)));
+  }
+
+  // a short object cuts the read in the middle of a run: each requested
+  // extent still gets the bytes that the per run reads returned
+  {
+    vector<pair<int, int>> subchunks = {{0, 1}, {3, 3}};
+    const uint64_t object_size = chunk_size + 4 * subchunk_size + 3;
+    bufferlist short_object;
+    short_object.substr_of(object, 0, object_size);
+    const vector<pair<uint64_t, uint64_t>> to_read = {
+      {0, chunk_size}, {chunk_size, 2 * chunk_size}, {2 * chunk_size, chunk_size}};
+    for (auto &&[off, len] : to_read) {
+      auto extents = ECUtilL::subchunk_extents(
+        s, sub_chunk_count, off, len, subchunks, object_size);
+      ASSERT_LE(extents.range_end(), object_size);
+      auto expected = read_subchunk_runs(short_object, chunk_size,
+                                         subchunk_size, off, len, subchunks);
+      ASSERT_TRUE(readv(short_object, extents).contents_equal(expected));
+      if (off >= object_size) {
+        ASSERT_TRUE(extents.empty());
+      }
+    }
+    auto extents = ECUtilL::subchunk_extents(
+      s, sub_chunk_count, chunk_size, chunk_size, subchunks, object_size);
+    interval_set<uint64_t> expected;
+    expected.insert(chunk_size, subchunk_size);
+    expected.insert(chunk_size + 3 * subchunk_size, subchunk_size + 3);
+    ASSERT_EQ(expected, extents);
+  }
+
+  // an empty object reads nothing
+  ASSERT_TRUE(ECUtilL::subchunk_extents(
+    s, sub_chunk_count, 0, chunk_size, {{0, 8}}, 0).empty());
+}
+
+
 TEST(ECCommon, get_min_want_to_read_shards)
 {
   const uint64_t swidth = 4096;
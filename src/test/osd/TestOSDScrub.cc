@@ -55,6 +55,21 @@ public:
   bool scrub_time_permit(utime_t now) {
     return service.get_scrub_services().scrub_time_permit(now);
   }
+
+  OsdScrub& scrub_services() {
+    return service.get_scrub_services();
+  }
+
+  Scrub::OSDRestrictions restrictions_on_scrubbing(utime_t now) {
+    return service.get_scrub_services().restrictions_on_scrubbing(false, now);
+  }
+
+  static bool is_sched_target_eligible(
+      const Scrub::SchedEntry& e,
+      const Scrub::OSDRestrictions& r,
+      utime_t now) {
+    return OsdScrub::is_sched_target_eligible(e, r, now);
+  }
 };
 
 TEST(TestOSDScrub, scrub_time_permit) {
@@ -200,6 +215,121 @@ TEST(TestOSDScrub, scrub_time_permit) {
   mc.shutdown();
 }
 
+TEST(TestOSDScrub, client_latency) {
+  ceph::async::io_context_pool icp(1);
+  std::unique_ptr<ObjectStore> store = ObjectStore::create(g_ceph_context,
+             g_conf()->osd_objectstore,
+             g_conf()->osd_data,
+             g_conf()->osd_journal);
+  std::string cluster_msgr_type = g_conf()->ms_cluster_type.empty() ? g_conf().get_val<std::string>("ms_type") : g_conf()->ms_cluster_type;
+  Messenger *ms = Messenger::create(g_ceph_context, cluster_msgr_type,
+				    entity_name_t::OSD(0), "make_checker",
+				    getpid());
+  ms->set_cluster_protocol(CEPH_OSD_PROTOCOL);
+  ms->set_default_policy(Messenger::Policy::stateless_server(0));
+  ms->bind(g_conf()->public_addr);
+  MonClient mc(g_ceph_context, icp);
+  mc.build_initial_monmap();
+  TestOSDScrub* osd = new TestOSDScrub(g_ceph_context, std::move(store), 0, ms, ms, ms, ms, ms, ms, ms, &mc, "", "", icp);
+  OsdScrub& scrub = osd->scrub_services();
+
+  g_ceph_context->_conf.set_val("osd_scrub_target_client_latency", "0.01");
+  g_ceph_context->_conf.set_val("osd_max_scrubs", "4");
+  g_ceph_context->_conf.apply_changes(nullptr);
+
+  // the counter is cumulative: only the ops since the previous sample count
+  uint64_t lat_sum_ns = 0;
+  uint64_t op_count = 0;
+  auto sample = [&](uint64_t ops, uint64_t op_lat_ns) {
+    lat_sum_ns += ops * op_lat_ns;
+    op_count += ops;
+    scrub.update_client_latency(lat_sum_ns, op_count);
+  };
+
+  sample(1000, 1'000'000);  // 1ms
+  ASSERT_EQ(1.0, scrub.chunk_size_factor());
+  ASSERT_EQ(25, scrub.adapted_chunk_max(25));
+
+  // slow client ops: the chunks shrink by half on each sample...
+  sample(100, 50'000'000);  // 50ms
+  ASSERT_EQ(0.5, scrub.chunk_size_factor());
+  ASSERT_EQ(12, scrub.adapted_chunk_max(25));
+  ASSERT_FALSE(osd->restrictions_on_scrubbing(ceph_clock_now()).client_latency_high);
+
+  sample(1, 50'000'000);
+  ASSERT_EQ(0.25, scrub.chunk_size_factor());
+  sample(100, 50'000'000);
+  ASSERT_EQ(0.125, scrub.chunk_size_factor());
+  ASSERT_EQ(3, scrub.adapted_chunk_max(25));
+  ASSERT_EQ(1, scrub.adapted_chunk_max(5));
+  ASSERT_FALSE(osd->restrictions_on_scrubbing(ceph_clock_now()).client_latency_high);
+
+  // ...down to 1/8. Only then are regular scrubs no longer started
+  sample(100, 50'000'000);
+  ASSERT_EQ(0.125, scrub.chunk_size_factor());
+  ASSERT_TRUE(osd->restrictions_on_scrubbing(ceph_clock_now()).client_latency_high);
+
+  Scrub::OSDRestrictions restrictions;
+  restrictions.client_latency_high = true;
+  Scrub::SchedEntry entry{spg_t{pg_t{1, 1}}, scrub_level_t::shallow};
+  entry.schedule.not_before = utime_t{};
+  entry.urgency = Scrub::urgency_t::periodic_regular;
+  ASSERT_FALSE(TestOSDScrub::is_sched_target_eligible(entry, restrictions, ceph_clock_now()));
+  entry.urgency = Scrub::urgency_t::must_scrub;
+  ASSERT_FALSE(TestOSDScrub::is_sched_target_eligible(entry, restrictions, ceph_clock_now()));
+  entry.urgency = Scrub::urgency_t::operator_requested;
+  ASSERT_TRUE(TestOSDScrub::is_sched_target_eligible(entry, restrictions, ceph_clock_now()));
+  entry.urgency = Scrub::urgency_t::periodic_regular;
+  restrictions.client_latency_high = false;
+  ASSERT_TRUE(TestOSDScrub::is_sched_target_eligible(entry, restrictions, ceph_clock_now()));
+
+  // the number of concurrent scrubs is scaled down as well (4 * 1/8 -> 1)
+  {
+    auto first = scrub.inc_scrubs_local(false);
+    ASSERT_TRUE(first);
+    ASSERT_FALSE(scrub.inc_scrubs_local(false));
+    // high priority scrubs are not limited
+    auto urgent = scrub.inc_scrubs_local(true);
+    ASSERT_TRUE(urgent);
+  }
+
+  // once latency is back below the target, the chunks grow back slowly
+  sample(100, 1'000'000);
+  ASSERT_EQ(0.25, scrub.chunk_size_factor());
+  ASSERT_FALSE(osd->restrictions_on_scrubbing(ceph_clock_now()).client_latency_high);
+  sample(100, 1'000'000);
+  sample(100, 1'000'000);
+  ASSERT_EQ(0.5, scrub.chunk_size_factor());
+  {
+    // 4 * 1/2 -> 2
+    auto first = scrub.inc_scrubs_local(false);
+    auto second = scrub.inc_scrubs_local(false);
+    ASSERT_TRUE(first);
+    ASSERT_TRUE(second);
+    ASSERT_FALSE(scrub.inc_scrubs_local(false));
+  }
+
+  // no client ops at all counts as low latency
+  for (int i = 0; i < 4; ++i) {
+    sample(0, 0);
+  }
+  ASSERT_EQ(1.0, scrub.chunk_size_factor());
+  ASSERT_EQ(25, scrub.adapted_chunk_max(25));
+
+  // disabling the target restores the configured chunk size at once
+  sample(100, 50'000'000);
+  ASSERT_EQ(0.5, scrub.chunk_size_factor());
+  g_ceph_context->_conf.set_val("osd_scrub_target_client_latency", "0");
+  g_ceph_context->_conf.apply_changes(nullptr);
+  sample(100, 50'000'000);
+  ASSERT_EQ(1.0, scrub.chunk_size_factor());
+  ASSERT_FALSE(osd->restrictions_on_scrubbing(ceph_clock_now()).client_latency_high);
+
+  g_ceph_context->_conf.set_val("osd_max_scrubs", "3");
+  g_ceph_context->_conf.apply_changes(nullptr);
+  mc.shutdown();
+}
+
 // Local Variables:
 // compile-command: "cd ../.. ; make unittest_osdscrub ; ./unittest_osdscrub --log-to-stderr=true  --debug-osd=20 # --gtest_filter=*.* "
 // End:
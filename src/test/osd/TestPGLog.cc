@@ -2685,6 +2685,84 @@ TEST_F(PGLogMergeDupsTest, Superset) {
 }
 
 
+TEST_F(PGLogMergeDupsTest, RollbackInfoWrittenOnChange) {
+  hobject_t hoid;
+  hoid.pool = 1;
+  hoid.oid = "log";
+  ghobject_t log_oid(hoid);
+  auto write = [&] {
+    ObjectStore::Transaction t;
+    map<string, bufferlist> km;
+    write_log_and_missing(t, &km, test_coll, log_oid, true);
+    return km;
+  };
+
+  // the first write always carries the rollback info
+  auto km = write();
+  EXPECT_EQ(1u, km.count("can_rollback_to"));
+  EXPECT_EQ(1u, km.count("rollback_info_trimmed_to"));
+
+  // nothing moved, only the missing set is dirty
+  hobject_t oid;
+  oid.pool = 1;
+  oid.oid = "obj";
+  missing_add(oid, eversion_t(1, 1), eversion_t());
+  km = write();
+  EXPECT_EQ(1u, km.count(string("missing/") + oid.to_str()));
+  EXPECT_EQ(0u, km.count("can_rollback_to"));
+  EXPECT_EQ(0u, km.count("rollback_info_trimmed_to"));
+
+  // rolling forward moves both
+  roll_forward_to(eversion_t(1, 5), nullptr, nullptr);
+  km = write();
+  EXPECT_EQ(1u, km.count("can_rollback_to"));
+  EXPECT_EQ(1u, km.count("rollback_info_trimmed_to"));
+
+  // a full rewrite carries them again
+  mark_log_for_rewrite();
+  km = write();
+  EXPECT_EQ(1u, km.count("can_rollback_to"));
+  EXPECT_EQ(1u, km.count("rollback_info_trimmed_to"));
+}
+
+TEST_F(PGLogMergeDupsTest, RollbackInfoNotWrittenOnRecovery) {
+  hobject_t hoid;
+  hoid.pool = 1;
+  hoid.oid = "log";
+  ghobject_t log_oid(hoid);
+  auto write = [&] {
+    ObjectStore::Transaction t;
+    map<string, bufferlist> km;
+    write_log_and_missing(t, &km, test_coll, log_oid, true);
+    return km;
+  };
+
+  constexpr unsigned num_objects = 100;
+  auto obj = [](unsigned i) {
+    hobject_t oid;
+    oid.pool = 1;
+    oid.oid = "obj" + std::to_string(i);
+    return oid;
+  };
+  for (unsigned i = 0; i < num_objects; ++i) {
+    missing_add(obj(i), eversion_t(1, i + 1), eversion_t());
+  }
+  auto km = write();
+  EXPECT_EQ(num_objects + 2, km.size());
+
+  // each recovered object dirties the missing set only. Its transaction
+  // used to carry both rollback keys (2 puts, 63 bytes of keys and values)
+  pg_info_t info;
+  size_t puts = 0;
+  for (unsigned i = 0; i < num_objects; ++i) {
+    recover_got(obj(i), eversion_t(1, i + 1), info);
+    ASSERT_TRUE(is_dirty());
+    puts += write().size();
+  }
+  EXPECT_EQ(0u, puts);
+}
+
+
 struct PGLogTrimTest :
   public ::testing::Test,
   public PGLogTestBase,
@@ -2923,6 +3001,108 @@ TEST_F(PGLogTrimTest, TestGetRequest) {
   EXPECT_FALSE(result);
 }
 
+TEST_F(PGLogTrimTest, TestLazyReqidIndex) {
+  SetUp(20);
+  PGLog::IndexedLog log;
+  log.head = mk_evt(20, 0);
+  log.skip_can_rollback_to_to_head();
+  log.head = mk_evt(9, 0);
+
+  entity_name_t client = entity_name_t::CLIENT(777);
+
+  log.add(mk_ple_mod(mk_obj(1), mk_evt(10, 100), mk_evt(8, 70),
+		     osd_reqid_t(client, 8, 1)));
+  log.add(mk_ple_mod(mk_obj(2), mk_evt(15, 150), mk_evt(10, 100),
+		     osd_reqid_t(client, 8, 2)));
+  log.add(mk_ple_mod(mk_obj(3), mk_evt(21, 165), mk_evt(15, 150),
+		     osd_reqid_t(client, 8, 3)));
+
+  eversion_t write_from_dups = eversion_t::max();
+  log.trim(cct, mk_evt(15, 150), nullptr, nullptr, &write_from_dups);
+  EXPECT_EQ(1u, log.log.size());
+  EXPECT_EQ(2u, log.dups.size());
+
+  // as when loaded from disk: only the objects are indexed
+  PGLog::IndexedLog loaded(static_cast<const pg_log_t&>(log));
+  EXPECT_EQ(1u, loaded.objects.size());
+  EXPECT_EQ(0u, loaded.caller_ops.size());
+  EXPECT_EQ(0u, loaded.dup_index.size());
+
+  eversion_t version;
+  version_t user_version;
+  int return_code;
+  vector<pg_log_op_return_item_t> op_returns;
+
+  EXPECT_TRUE(loaded.get_request(osd_reqid_t(client, 8, 3), &version,
+				 &user_version, &return_code, &op_returns));
+  EXPECT_EQ(mk_evt(21, 165), version);
+  EXPECT_EQ(1u, loaded.caller_ops.size());
+
+  EXPECT_TRUE(loaded.get_request(osd_reqid_t(client, 8, 1), &version,
+				 &user_version, &return_code, &op_returns));
+  EXPECT_EQ(mk_evt(10, 100), version);
+  EXPECT_EQ(2u, loaded.dup_index.size());
+
+  // once built, the indexes are maintained
+  loaded.add(mk_ple_mod(mk_obj(4), mk_evt(21, 166), mk_evt(21, 165),
+			osd_reqid_t(client, 8, 4)));
+  EXPECT_EQ(2u, loaded.caller_ops.size());
+  EXPECT_TRUE(loaded.get_request(osd_reqid_t(client, 8, 4), &version,
+				 &user_version, &return_code, &op_returns));
+  EXPECT_EQ(mk_evt(21, 166), version);
+
+  // as when the PG stops being primary
+  loaded.unindex_requests();
+  EXPECT_EQ(2u, loaded.objects.size());
+  EXPECT_EQ(0u, loaded.caller_ops.size());
+  EXPECT_EQ(0u, loaded.dup_index.size());
+  EXPECT_TRUE(loaded.get_request(osd_reqid_t(client, 8, 1), &version,
+				 &user_version, &return_code, &op_returns));
+  EXPECT_EQ(mk_evt(10, 100), version);
+}
+
+TEST_F(PGLogTrimTest, TestSplitLazyReqidIndex) {
+  SetUp(20);
+  PGLog::IndexedLog log;
+  log.head = mk_evt(9, 0);
+
+  entity_name_t client = entity_name_t::CLIENT(777);
+
+  // mk_obj() hashes object i to i: odd ones go to the child
+  for (unsigned i = 1; i <= 4; ++i) {
+    log.add(mk_ple_mod(mk_obj(i), mk_evt(10, 100 + i), mk_evt(10, 99 + i),
+		       osd_reqid_t(client, 8, i)));
+  }
+  // the primary looked up a resent op: all the indexes are built
+  eversion_t version;
+  version_t user_version;
+  int return_code;
+  vector<pg_log_op_return_item_t> op_returns;
+  EXPECT_TRUE(log.get_request(osd_reqid_t(client, 8, 2), &version,
+			      &user_version, &return_code, &op_returns));
+  EXPECT_EQ(4u, log.caller_ops.size());
+
+  PGLog::IndexedLog child;
+  log.split_out_child(pg_t(1, 1), 1, &child);
+  EXPECT_EQ(2u, log.log.size());
+  EXPECT_EQ(2u, log.objects.size());
+  EXPECT_EQ(0u, log.caller_ops.size());
+  EXPECT_EQ(2u, child.log.size());
+  EXPECT_EQ(2u, child.objects.size());
+  EXPECT_EQ(0u, child.caller_ops.size());
+
+  EXPECT_TRUE(log.get_request(osd_reqid_t(client, 8, 2), &version,
+			      &user_version, &return_code, &op_returns));
+  EXPECT_EQ(mk_evt(10, 102), version);
+  EXPECT_FALSE(log.get_request(osd_reqid_t(client, 8, 3), &version,
+			       &user_version, &return_code, &op_returns));
+  EXPECT_EQ(2u, log.caller_ops.size());
+  EXPECT_TRUE(child.get_request(osd_reqid_t(client, 8, 3), &version,
+				&user_version, &return_code, &op_returns));
+  EXPECT_EQ(mk_evt(10, 103), version);
+  EXPECT_EQ(2u, child.caller_ops.size());
+}
+
 TEST_F(PGLogTest, _merge_object_divergent_entries) {
   {
     // Test for issue 20843
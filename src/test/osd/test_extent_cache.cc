@@ -16,6 +16,7 @@
 
 #include <gtest/gtest.h>
 #include "osd/ECExtentCache.h"
+#include "osd/osd_perf_counters.h"
 
 using namespace std;
 using namespace ECUtil;
@@ -67,9 +68,10 @@ struct Client : public ECExtentCache::BackendReadListener
   optional<shard_extent_set_t> active_reads;
   list<shard_extent_map_t> results;
 
-  Client(uint64_t chunk_size, int k, int m, uint64_t cache_size) :
+  Client(uint64_t chunk_size, int k, int m, uint64_t cache_size,
+         PerfCounters *logger = nullptr) :
     sinfo(k, m, k*chunk_size, vector<shard_id_t>(0)),
-    lru(cache_size), cache(*this, lru, sinfo, g_ceph_context) {};
+    lru(cache_size, logger), cache(*this, lru, sinfo, g_ceph_context) {};
 
   void backend_read(hobject_t _oid, const shard_extent_set_t& request,
     uint64_t object_size) override  {
@@ -693,4 +695,140 @@ TEST(ECExtentCache, test_invalidate_lru)
     cl.complete_write(*op5);
     op5.reset();
   }
-}
\ No newline at end of file
+}
+
+TEST(ECExtentCache, hit_miss_counters)
+{
+  std::unique_ptr<PerfCounters> logger(build_osd_logger(g_ceph_context));
+  Client cl(32, 2, 1, 64, logger.get());
+  auto to_write = iset_from_vector({{{0, 10}}, {{0, 10}}}, cl.get_stripe_info());
+
+  auto do_op = [&cl, &to_write](shard_extent_set_t const &to_read) {
+    optional op = cl.cache.prepare(cl.oid, to_read, to_write, 10, 10, false,
+      [&cl](ECExtentCache::OpRef &op)
+      {
+        cl.cache_ready(op->get_hoid(), op->get_result());
+      });
+    cl.cache_execute(*op);
+    if (cl.active_reads) {
+      cl.complete_read();
+    }
+    cl.complete_write(*op);
+    op.reset();
+  };
+
+  // Nothing cached, the read goes to the shards.
+  do_op(iset_from_vector({{{0, 2}}, {{0, 2}}}, cl.get_stripe_info()));
+  ASSERT_EQ(0u, logger->get(l_osd_ec_extent_cache_hit));
+  ASSERT_EQ(1u, logger->get(l_osd_ec_extent_cache_miss));
+  ASSERT_EQ(0u, logger->get(l_osd_ec_extent_cache_bytes_saved));
+
+  // Served from the previous write.
+  do_op(iset_from_vector({{{2, 2}}, {{2, 2}}}, cl.get_stripe_info()));
+  ASSERT_EQ(1u, logger->get(l_osd_ec_extent_cache_hit));
+  ASSERT_EQ(1u, logger->get(l_osd_ec_extent_cache_miss));
+  ASSERT_EQ(4u, logger->get(l_osd_ec_extent_cache_bytes_saved));
+
+  // Half of it is beyond what was written.
+  do_op(iset_from_vector({{{8, 4}}, {{8, 4}}}, cl.get_stripe_info()));
+  ASSERT_EQ(1u, logger->get(l_osd_ec_extent_cache_hit));
+  ASSERT_EQ(2u, logger->get(l_osd_ec_extent_cache_miss));
+  ASSERT_EQ(8u, logger->get(l_osd_ec_extent_cache_bytes_saved));
+}
+
+TEST(ECExtentCache, pri_cache)
+{
+  const uint64_t min_size = 1024*1024;
+  Client cl(4096, 2, 1, min_size);
+  ECExtentCache::LRU other(min_size);
+  ECExtentCache::PriCache pri_cache({&cl.lru, &other}, min_size, 0.05);
+
+  ASSERT_EQ(0, pri_cache.request_cache_bytes(PriorityCache::Priority::LAST, 0));
+
+  {
+    auto to_write = iset_from_vector({{{0, 8192}}, {{0, 8192}}}, cl.get_stripe_info());
+    optional op = cl.cache.prepare(cl.oid, nullopt, to_write, 0, 16384, false,
+      [&cl](ECExtentCache::OpRef &op)
+      {
+        cl.cache_ready(op->get_hoid(), op->get_result());
+      });
+    cl.cache_execute(*op);
+    cl.complete_write(*op);
+    op.reset();
+  }
+
+  // The written lines are now in the LRU, all of it is requested at LAST.
+  uint64_t used = cl.lru.get_size();
+  ASSERT_LT(0u, used);
+  ASSERT_EQ(used, pri_cache.get_used_bytes());
+  ASSERT_EQ(0, pri_cache.request_cache_bytes(PriorityCache::Priority::PRI1,
+                                             1ul << 30));
+  ASSERT_EQ((int64_t)used,
+            pri_cache.request_cache_bytes(PriorityCache::Priority::LAST,
+                                          1ul << 30));
+
+  // Committed memory is split between the LRUs.
+  pri_cache.set_cache_bytes(PriorityCache::Priority::LAST, 256ul << 20);
+  int64_t committed = pri_cache.commit_cache_size(1ul << 30);
+  ASSERT_LE(256l << 20, committed);
+  ASSERT_EQ((uint64_t)committed / 2, cl.lru.get_max_size());
+  ASSERT_EQ((uint64_t)committed / 2, other.get_max_size());
+  ASSERT_EQ(used, cl.lru.get_size());
+
+  // But never below the configured size.
+  ECExtentCache::PriCache big_min({&cl.lru}, 1ul << 30, 0.05);
+  big_min.commit_cache_size(1ul << 30);
+  ASSERT_EQ(1ul << 30, cl.lru.get_max_size());
+
+  // Shrinking the LRU evicts.
+  cl.lru.set_max_size(0);
+  ASSERT_EQ(0u, cl.lru.get_size());
+}
+
+// Stands in for the object store's caches, wants a fixed amount at LAST.
+class FixedPriCache : public ECExtentCache::PriCache {
+  int64_t wants;
+
+ public:
+  FixedPriCache(int64_t wants, double ratio) :
+    ECExtentCache::PriCache({}, 0, ratio), wants(wants) {}
+
+  int64_t request_cache_bytes(PriorityCache::Priority pri,
+                              uint64_t total_cache) const override {
+    return pri == PriorityCache::Priority::LAST ? wants : 0;
+  }
+};
+
+TEST(ECExtentCache, pri_cache_within_target)
+{
+  const uint64_t target = 1ul << 30;
+  PriorityCache::Manager pcm(g_ceph_context, target, target, target, false,
+                             "ec_extent_cache_test");
+  ASSERT_EQ(target, pcm.get_tuned_mem());
+
+  // The store's caches, their ratios add up to 1. All of them get what they
+  // want, what is left is split by the ratios.
+  std::vector<std::shared_ptr<ECExtentCache::PriCache>> caches = {
+    std::make_shared<FixedPriCache>(64ul << 20, 0.45),
+    std::make_shared<FixedPriCache>(0, 0.4),
+    std::make_shared<FixedPriCache>(256ul << 20, 0.15),
+  };
+  // And the EC extent caches on top.
+  caches.push_back(std::make_shared<ECExtentCache::PriCache>(
+    std::vector<ECExtentCache::LRU*>{}, 0, 0.05));
+  for (unsigned i = 0; i < caches.size(); i++) {
+    pcm.insert("cache" + std::to_string(i), caches[i], false);
+  }
+
+  pcm.balance();
+  uint64_t assigned = 0;
+  for (auto &&cache : caches) {
+    assigned += cache->get_cache_bytes();
+  }
+  ASSERT_LT(0u, caches.back()->get_cache_bytes());
+  ASSERT_LE(assigned, target);
+
+  for (unsigned i = 0; i < caches.size(); i++) {
+    pcm.erase("cache" + std::to_string(i));
+  }
+}
@@ -24,6 +24,7 @@
 #include "common/Thread.h"
 #include "include/stringify.h"
 #include "osd/ReplicatedBackend.h"
+#include "osd/recovery_types.h"
 
 #include <iostream> // for std::cout
 #include <sstream>
@@ -2328,6 +2329,43 @@ TEST(chunk_info_test, calc_refs_inc_match) {
     mk_delta({}));
 }
 
+TEST(ReplicaBackfillInterval, extend) {
+  auto mk = [](const char *name) {
+    return hobject_t(object_t(name), "", CEPH_NOSNAP, 0x42, 1, "");
+  };
+  ReplicaBackfillInterval bi;
+  bi.reset(mk("a"));
+  bi.end = mk("d");
+  bi.objects[mk("b")] = eversion_t(1, 1);
+  bi.objects[mk("c")] = eversion_t(1, 2);
+  bi.trim();
+
+  // a read-ahead of the range that follows is appended
+  std::map<hobject_t, eversion_t> ahead{{mk("e"), eversion_t(1, 3)}};
+  ASSERT_TRUE(bi.extend(mk("d"), mk("f"), std::move(ahead)));
+  ASSERT_EQ(mk("b"), bi.begin);
+  ASSERT_EQ(mk("f"), bi.end);
+  ASSERT_EQ(3u, bi.objects.size());
+
+  // the objects still held are consumed before the next read-ahead is back
+  bi.pop_front();
+  bi.pop_front();
+  bi.pop_front();
+  ASSERT_TRUE(bi.empty());
+  std::map<hobject_t, eversion_t> last{{mk("g"), eversion_t(1, 4)}};
+  ASSERT_TRUE(bi.extend(mk("f"), hobject_t(hobject_t::get_max()), std::move(last)));
+  ASSERT_EQ(mk("g"), bi.begin);
+  ASSERT_TRUE(bi.extends_to_end());
+
+  // a read-ahead asked before the interval was reset is stale
+  bi.reset(mk("a"));
+  std::map<hobject_t, eversion_t> stale{{mk("i"), eversion_t(1, 5)}};
+  ASSERT_FALSE(bi.extend(mk("h"), mk("j"), std::move(stale)));
+  ASSERT_EQ(mk("a"), bi.begin);
+  ASSERT_EQ(mk("a"), bi.end);
+  ASSERT_TRUE(bi.empty());
+}
+
 /*
  * Local Variables:
  * compile-command: "cd ../.. ;
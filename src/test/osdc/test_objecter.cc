@@ -0,0 +1,330 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:nil -*-
+// vim: ts=8 sw=2 sts=2 expandtab
+
+#include <chrono>
+#include <thread>
+
+#include <boost/asio/io_context.hpp>
+
+#include "gtest/gtest.h"
+
+#include "global/global_context.h"
+#include "osd/OSDMap.h"
+#include "osd/OSDMapMapping.h"
+#include "osdc/Objecter.h"
+
+using namespace std;
+
+class ObjecterTest : public ::testing::Test {
+protected:
+  using target_changes_t = Objecter::target_changes_t;
+  using op_target_t = Objecter::op_target_t;
+
+  static constexpr int num_osds = 6;
+  static constexpr int64_t pool_a = 1;
+  static constexpr int64_t pool_b = 2;
+
+  OSDMap osdmap;
+
+  void SetUp() override {
+    uuid_d fsid;
+    osdmap.build_simple(g_ceph_context, 0, fsid, num_osds);
+    OSDMap::Incremental pending_inc(osdmap.get_epoch() + 1);
+    pending_inc.fsid = osdmap.get_fsid();
+    entity_addrvec_t sample_addrs;
+    sample_addrs.v.push_back(entity_addr_t());
+    uuid_d sample_uuid;
+    for (int i = 0; i < num_osds; ++i) {
+      sample_uuid.generate_random();
+      sample_addrs.v[0].nonce = i;
+      pending_inc.new_state[i] = CEPH_OSD_EXISTS | CEPH_OSD_NEW;
+      pending_inc.new_up_client[i] = sample_addrs;
+      pending_inc.new_up_cluster[i] = sample_addrs;
+      pending_inc.new_hb_back_up[i] = sample_addrs;
+      pending_inc.new_hb_front_up[i] = sample_addrs;
+      pending_inc.new_weight[i] = CEPH_OSD_IN;
+      pending_inc.new_uuid[i] = sample_uuid;
+    }
+    osdmap.apply_incremental(pending_inc);
+
+    OSDMap::Incremental new_pool_inc(osdmap.get_epoch() + 1);
+    new_pool_inc.new_pool_max = osdmap.get_pool_max();
+    new_pool_inc.fsid = osdmap.get_fsid();
+    add_pool("a", new_pool_inc);
+    add_pool("b", new_pool_inc);
+    osdmap.apply_incremental(new_pool_inc);
+  }
+
+  void add_pool(const string& name, OSDMap::Incremental& inc,
+		unsigned pg_num = 32) {
+    pg_pool_t empty;
+    int64_t pool_id = ++inc.new_pool_max;
+    pg_pool_t *p = inc.get_new_pool(pool_id, &empty);
+    p->size = 3;
+    p->set_pg_num(pg_num);
+    p->set_pgp_num(pg_num);
+    p->type = pg_pool_t::TYPE_REPLICATED;
+    p->crush_rule = 0;
+    p->set_flag(pg_pool_t::FLAG_HASHPSPOOL);
+    inc.new_pool_names[pool_id] = name;
+  }
+
+  OSDMap::Incremental next_inc() const {
+    OSDMap::Incremental inc(osdmap.get_epoch() + 1);
+    inc.fsid = osdmap.get_fsid();
+    return inc;
+  }
+
+  // apply inc to osdmap, and diff it against the map it replaced
+  std::optional<target_changes_t> apply(const OSDMap::Incremental& inc) {
+    int prev_flags = osdmap.get_flags();
+    auto prev_require_osd_release = osdmap.require_osd_release;
+    osdmap.apply_incremental(inc);
+    return target_changes_t::diff(prev_flags, prev_require_osd_release,
+				  inc, osdmap);
+  }
+
+  static op_target_t target_of(const pg_t& pgid) {
+    op_target_t t(object_t("foo"), object_locator_t(pgid.pool()), 0);
+    t.target_oloc = t.base_oloc;
+    t.pgid = pgid;
+    t.actual_pgid = spg_t(pgid);
+    return t;
+  }
+
+  // the background pg mapping of an objecter
+  static ThreadPool& pg_mapper_tp(Objecter& objecter) {
+    return *objecter.pg_mapper_tp;
+  }
+  static void start_pg_mapping(Objecter& objecter,
+			       const std::shared_ptr<const OSDMap>& map) {
+    std::lock_guard l{objecter.map_lock};
+    objecter._start_pg_mapping(map);
+  }
+  static bool has_pg_mapping_job(Objecter& objecter) {
+    std::lock_guard l{objecter.map_lock};
+    return bool(objecter.pg_mapping_job);
+  }
+  static std::shared_ptr<const OSDMapMapping> pg_mapping_table(
+    Objecter& objecter) {
+    return objecter.pg_mapping_table.load();
+  }
+  static bool wait_for_pg_mapping_table(Objecter& objecter, epoch_t epoch) {
+    for (int i = 0; i < 1000; ++i) {
+      if (auto table = pg_mapping_table(objecter);
+	  table && table->get_epoch() == epoch) {
+	return true;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+  }
+  static bool lookup_pg_mapping(Objecter& objecter, const pg_t& pg,
+				epoch_t epoch, vector<int> *up,
+				int *up_primary, vector<int> *acting,
+				int *acting_primary) {
+    return objecter.lookup_pg_mapping(pg, epoch, up, up_primary,
+				      acting, acting_primary);
+  }
+  static void update_pg_mapping(Objecter& objecter, const pg_t& pg,
+				epoch_t epoch, const vector<int>& osds) {
+    objecter.update_pg_mapping(
+      pg, Objecter::pg_mapping_t(epoch, osds, osds[0], osds, osds[0]));
+  }
+};
+
+TEST_F(ObjecterTest, DiffUnchanged) {
+  // an incremental that only bumps the epoch changes no target
+  auto changes = apply(next_inc());
+  ASSERT_TRUE(changes);
+  EXPECT_TRUE(changes->empty());
+  EXPECT_FALSE(changes->may_change(target_of(pg_t(0, pool_a))));
+}
+
+TEST_F(ObjecterTest, DiffPoolDeleted) {
+  auto inc = next_inc();
+  inc.old_pools.insert(pool_a);
+  auto changes = apply(inc);
+  ASSERT_TRUE(changes);
+  EXPECT_EQ(set<int64_t>{pool_a}, changes->pools);
+  EXPECT_TRUE(changes->pgs.empty());
+  EXPECT_TRUE(changes->may_change(target_of(pg_t(0, pool_a))));
+  EXPECT_FALSE(changes->may_change(target_of(pg_t(0, pool_b))));
+}
+
+TEST_F(ObjecterTest, DiffPgNumChanged) {
+  auto inc = next_inc();
+  pg_pool_t *p = inc.get_new_pool(pool_b, osdmap.get_pg_pool(pool_b));
+  p->set_pg_num(64);
+  p->set_pgp_num(64);
+  auto changes = apply(inc);
+  ASSERT_TRUE(changes);
+  EXPECT_EQ(set<int64_t>{pool_b}, changes->pools);
+  EXPECT_TRUE(changes->pgs.empty());
+  EXPECT_TRUE(changes->may_change(target_of(pg_t(5, pool_b))));
+  EXPECT_FALSE(changes->may_change(target_of(pg_t(5, pool_a))));
+
+  // a target redirected to pool b may change as well
+  auto t = target_of(pg_t(5, pool_a));
+  t.target_oloc = object_locator_t(pool_b);
+  EXPECT_TRUE(changes->may_change(t));
+}
+
+TEST_F(ObjecterTest, DiffActingChanged) {
+  const pg_t pg_temp(1, pool_a), primary_temp(2, pool_a);
+  auto inc = next_inc();
+  inc.new_pg_temp[pg_temp] =
+    mempool::osdmap::vector<int32_t>{0, 1, 2};
+  inc.new_primary_temp[primary_temp] = 3;
+  auto changes = apply(inc);
+  ASSERT_TRUE(changes);
+  EXPECT_TRUE(changes->pools.empty());
+  EXPECT_EQ((set<pg_t>{pg_temp, primary_temp}), changes->pgs);
+  EXPECT_TRUE(changes->may_change(target_of(pg_temp)));
+  EXPECT_TRUE(changes->may_change(target_of(primary_temp)));
+  EXPECT_FALSE(changes->may_change(target_of(pg_t(3, pool_a))));
+  EXPECT_FALSE(changes->may_change(target_of(pg_t(1, pool_b))));
+}
+
+TEST_F(ObjecterTest, DiffUpmapChanged) {
+  const pg_t upmap(1, pool_b), upmap_items(2, pool_b);
+  {
+    auto inc = next_inc();
+    inc.new_pg_upmap[upmap] = mempool::osdmap::vector<int32_t>{3, 4, 5};
+    inc.new_pg_upmap_items[upmap_items] =
+      mempool::osdmap::vector<pair<int32_t,int32_t>>{{0, 5}};
+    auto changes = apply(inc);
+    ASSERT_TRUE(changes);
+    EXPECT_TRUE(changes->pools.empty());
+    EXPECT_EQ((set<pg_t>{upmap, upmap_items}), changes->pgs);
+    EXPECT_FALSE(changes->may_change(target_of(pg_t(3, pool_b))));
+  }
+  {
+    // and removing them again
+    auto inc = next_inc();
+    inc.old_pg_upmap.insert(upmap);
+    inc.old_pg_upmap_items.insert(upmap_items);
+    auto changes = apply(inc);
+    ASSERT_TRUE(changes);
+    EXPECT_EQ((set<pg_t>{upmap, upmap_items}), changes->pgs);
+    EXPECT_TRUE(changes->may_change(target_of(upmap)));
+    EXPECT_TRUE(changes->may_change(target_of(upmap_items)));
+  }
+}
+
+TEST_F(ObjecterTest, DiffEverythingMayChange) {
+  {
+    // an osd going down may remap any pg
+    auto inc = next_inc();
+    inc.new_state[0] = CEPH_OSD_UP;
+    EXPECT_FALSE(apply(inc));
+  }
+  {
+    auto inc = next_inc();
+    inc.new_weight[1] = CEPH_OSD_OUT;
+    EXPECT_FALSE(apply(inc));
+  }
+  {
+    // so does a change of the flags
+    auto inc = next_inc();
+    inc.new_flags = osdmap.get_flags() | CEPH_OSDMAP_PAUSERD;
+    EXPECT_FALSE(apply(inc));
+  }
+}
+
+class ObjecterPGMappingTest : public ObjecterTest {
+protected:
+  boost::asio::io_context ioctx;
+  std::unique_ptr<Objecter> objecter;
+
+  void SetUp() override {
+    ObjecterTest::SetUp();
+    g_ceph_context->_conf.set_val_or_die("objecter_pg_mapping_threads", "2");
+    g_ceph_context->_conf.set_val_or_die("objecter_pg_mapping_pgs_per_chunk",
+					 "1");
+    objecter = std::make_unique<Objecter>(g_ceph_context, nullptr, nullptr,
+					  ioctx);
+    objecter->init();
+  }
+  void TearDown() override {
+    if (objecter->initialized) {
+      objecter->shutdown();
+    }
+    objecter.reset();
+    g_ceph_context->_conf.rm_val("objecter_pg_mapping_threads");
+    g_ceph_context->_conf.rm_val("objecter_pg_mapping_pgs_per_chunk");
+  }
+};
+
+TEST_F(ObjecterPGMappingTest, Lookup) {
+  objecter->start(&osdmap);
+  const epoch_t epoch = osdmap.get_epoch();
+  ASSERT_TRUE(wait_for_pg_mapping_table(*objecter, epoch));
+
+  // once the table has the epoch of the lookup, it is served from there
+  const pg_t pg(1, pool_a);
+  vector<int> up, acting, expected_up, expected_acting;
+  int up_primary, acting_primary, expected_up_primary, expected_acting_primary;
+  ASSERT_TRUE(lookup_pg_mapping(*objecter, pg, epoch, &up, &up_primary,
+				&acting, &acting_primary));
+  osdmap.pg_to_up_acting_osds(pg, &expected_up, &expected_up_primary,
+			      &expected_acting, &expected_acting_primary);
+  EXPECT_EQ(expected_up, up);
+  EXPECT_EQ(expected_up_primary, up_primary);
+  EXPECT_EQ(expected_acting, acting);
+  EXPECT_EQ(expected_acting_primary, acting_primary);
+
+  // map the next epoch, but hold its job back
+  auto inc = next_inc();
+  inc.new_pg_temp[pg] = mempool::osdmap::vector<int32_t>{0, 1, 2};
+  osdmap.apply_incremental(inc);
+  auto next = std::make_shared<OSDMap>();
+  next->deepish_copy_from(osdmap);
+  pg_mapper_tp(*objecter).pause();
+  start_pg_mapping(*objecter, next);
+
+  // while it is running, the previous epoch is still served from the
+  // table, and lookups for the next one fall back to the per-pg mappings
+  EXPECT_TRUE(lookup_pg_mapping(*objecter, pg, epoch, &up, &up_primary,
+				&acting, &acting_primary));
+  EXPECT_FALSE(lookup_pg_mapping(*objecter, pg, epoch + 1, &up, &up_primary,
+				 &acting, &acting_primary));
+  update_pg_mapping(*objecter, pg, epoch + 1, {5, 4, 3});
+  ASSERT_TRUE(lookup_pg_mapping(*objecter, pg, epoch + 1, &up, &up_primary,
+				&acting, &acting_primary));
+  EXPECT_EQ((vector<int>{5, 4, 3}), acting);
+  EXPECT_EQ(5, acting_primary);
+
+  pg_mapper_tp(*objecter).unpause();
+  ASSERT_TRUE(wait_for_pg_mapping_table(*objecter, epoch + 1));
+  ASSERT_TRUE(lookup_pg_mapping(*objecter, pg, epoch + 1, &up, &up_primary,
+				&acting, &acting_primary));
+  EXPECT_EQ((vector<int>{0, 1, 2}), acting);
+  EXPECT_EQ(0, acting_primary);
+  // and the previous epoch is not served anymore
+  EXPECT_FALSE(lookup_pg_mapping(*objecter, pg, epoch, &up, &up_primary,
+				 &acting, &acting_primary));
+}
+
+TEST_F(ObjecterPGMappingTest, ShutdownAbortsJob) {
+  // enough pgs to keep the job busy for a while
+  auto inc = next_inc();
+  inc.new_pool_max = osdmap.get_pool_max();
+  add_pool("big", inc, 8192);
+  osdmap.apply_incremental(inc);
+
+  pg_mapper_tp(*objecter).pause();
+  objecter->start(&osdmap);
+  ASSERT_TRUE(has_pg_mapping_job(*objecter));
+  EXPECT_FALSE(pg_mapping_table(*objecter));
+
+  // the job has to be able to make progress to notice the abort
+  pg_mapper_tp(*objecter).unpause();
+  objecter->shutdown();
+  EXPECT_FALSE(has_pg_mapping_job(*objecter));
+  EXPECT_FALSE(pg_mapping_table(*objecter));
+
+  // and the job does not publish its table after all
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_FALSE(pg_mapping_table(*objecter));
+}